@@ -0,0 +1,285 @@
+// two phase occlusion culling: the early phase draws the instances that were visible last frame, a hi-z pyramid is built from
+// the depth they leave, and the late phase tests every instance against it, drawing those that became visible & remembering the result
+// (without occlusion culling only the early phase runs & draws everything inside the frustum)
+// frustum culls every instance against its model's bounding sphere, then each of its model's clusters (meshlets) against theirs & their normal cone
+// each phase runs three passes over one compacted visible list with one indirect draw per cluster:
+// cs_count counts each cluster's visible instances, cs_prefix_sum turns the counts into ranges of the list
+// and writes them into the indirect draws, cs_scatter repeats the cluster tests & writes the instances into their cluster's range
+// the late phase runs after the early phase's draws, so both reuse the same draws & list
+
+struct cull_uniforms_t {
+	planes: array<vec4f, 6>,
+	camera_position: vec4f,
+	view_projection: mat4x4f,
+	// size of the hi-z pyramid's first level
+	hiz_size: vec2f,
+	instance_count: u32,
+	dispatch_width: u32,
+	hiz_mip_count: u32,
+	occlusion_culling: u32,
+	// 0 early, 1 late
+	phase: u32,
+	// entries of visible_instances, instances past it are dropped (and counted)
+	visible_capacity: u32,
+	// without the indirect-first-instance feature draws start at instance 0 & the vertex shader offsets them itself
+	indirect_first_instance: u32,
+	padding0: u32,
+	padding1: u32,
+	padding2: u32,
+};
+
+struct instance_t {
+	model: mat4x4f,
+	model_index: u32,
+	padding0: u32,
+	padding1: u32,
+	padding2: u32,
+};
+
+struct model_info_t {
+	bounding_sphere: vec4f,
+	first_cluster: u32,
+	cluster_count: u32,
+	padding0: u32,
+	padding1: u32,
+};
+
+struct cluster_info_t {
+	bounding_sphere: vec4f,
+	cone_apex: vec3f,
+	cone_cutoff: f32,
+	cone_axis: vec3f,
+	padding0: u32,
+};
+
+struct draw_indexed_indirect_t {
+	index_count: u32,
+	instance_count: u32,
+	first_index: u32,
+	base_vertex: i32,
+	first_instance: u32,
+};
+
+// one per draw
+struct visible_range_t {
+	count: atomic<u32>,
+	cursor: atomic<u32>,
+	first: u32,
+};
+
+@group(0) @binding(0) var<uniform> cull_uniforms: cull_uniforms_t;
+@group(0) @binding(1) var<storage, read> instances: array<instance_t>;
+@group(0) @binding(2) var<storage, read> models: array<model_info_t>;
+@group(0) @binding(3) var<storage, read_write> draws: array<draw_indexed_indirect_t>;
+@group(0) @binding(4) var<storage, read_write> visible_instances: array<u32>;
+@group(0) @binding(5) var<storage, read> clusters: array<cluster_info_t>;
+// bit 0: the instance was visible last frame, bit 1: the current phase draws it
+@group(0) @binding(6) var<storage, read_write> visibility: array<u32>;
+// instances frustum culled, occluded, drawn by the early & by the late phase, cluster instances dropped for lack of room
+@group(0) @binding(7) var<storage, read_write> stats: array<atomic<u32>, 5>;
+@group(0) @binding(8) var<storage, read_write> ranges: array<visible_range_t>;
+// farthest depth of each texel's footprint, every level halves the previous one
+@group(1) @binding(0) var hiz: texture_2d<f32>;
+
+const visible_bit = 1u;
+const drawn_bit = 2u;
+const prefix_sum_workgroup_size = 256u;
+
+fn outside_frustum(center: vec3f, radius: f32) -> bool {
+	for (var i: u32 = 0; i < 6; i++) {
+		let plane = cull_uniforms.planes[i];
+		if dot(plane.xyz, center) + plane.w < -radius {
+			return true;
+		}
+	}
+	return false;
+}
+
+// true when the sphere is entirely behind the depth the hi-z pyramid holds over its screen footprint
+fn occluded(center: vec3f, radius: f32) -> bool {
+	var min_uv = vec2f(1.0, 1.0);
+	var max_uv = vec2f(0.0, 0.0);
+	var nearest = 1.0;
+	for (var i: u32 = 0; i < 8; i++) {
+		let corner = center + radius * vec3f(select(-1.0, 1.0, (i & 1u) != 0u), select(-1.0, 1.0, (i & 2u) != 0u), select(-1.0, 1.0, (i & 4u) != 0u));
+		let clip = cull_uniforms.view_projection * vec4f(corner, 1.0);
+		// crosses the camera plane, its footprint is unbounded
+		if clip.w <= 0.0 {
+			return false;
+		}
+		let ndc = clip.xyz / clip.w;
+		let uv = vec2f(ndc.x * 0.5 + 0.5, 0.5 - ndc.y * 0.5);
+		min_uv = min(min_uv, uv);
+		max_uv = max(max_uv, uv);
+		nearest = min(nearest, ndc.z);
+	}
+	min_uv = clamp(min_uv, vec2f(0.0), vec2f(1.0));
+	max_uv = clamp(max_uv, vec2f(0.0), vec2f(1.0));
+
+	// the level where the footprint covers at most 2x2 texels
+	let footprint = (max_uv - min_uv) * cull_uniforms.hiz_size;
+	let level = min(u32(ceil(log2(max(max(footprint.x, footprint.y), 1.0)))), cull_uniforms.hiz_mip_count - 1u);
+	let last = textureDimensions(hiz, level) - vec2u(1u, 1u);
+	let min_texel = min(vec2u(min_uv * vec2f(last + vec2u(1u, 1u))), last);
+	let max_texel = min(vec2u(max_uv * vec2f(last + vec2u(1u, 1u))), last);
+	var farthest = 0.0;
+	for (var y = min_texel.y; y <= max_texel.y; y++) {
+		for (var x = min_texel.x; x <= max_texel.x; x++) {
+			farthest = max(farthest, textureLoad(hiz, vec2u(x, y), level).r);
+		}
+	}
+	return nearest > farthest;
+}
+
+fn instance_index_of(id: vec3u) -> u32 {
+	// 2d dispatch so that more than 65535 * 64 instances fit
+	return id.y * cull_uniforms.dispatch_width + id.x;
+}
+
+fn world_scale(instance: instance_t) -> vec3f {
+	return vec3f(length(instance.model[0].xyz), length(instance.model[1].xyz), length(instance.model[2].xyz));
+}
+
+// whether one of the model's clusters survives the per cluster tests, the same in cs_count & cs_scatter
+fn cluster_visible(instance: instance_t, model: model_info_t, cluster_index: u32) -> bool {
+	let axis_scales = world_scale(instance);
+	let scale = max(axis_scales.x, max(axis_scales.y, axis_scales.z));
+	let cluster = clusters[cluster_index];
+	// a model's only cluster has the model's bounds, already tested
+	if model.cluster_count > 1u && outside_frustum((instance.model * vec4f(cluster.bounding_sphere.xyz, 1.0)).xyz, cluster.bounding_sphere.w * scale) {
+		return false;
+	}
+	// normal cones only stay valid under rotations & uniform scales
+	let linear = mat3x3f(instance.model[0].xyz, instance.model[1].xyz, instance.model[2].xyz);
+	let cone_culling = determinant(linear) > 0.0 && min(axis_scales.x, min(axis_scales.y, axis_scales.z)) > scale * 0.999;
+	if cone_culling {
+		let apex = (instance.model * vec4f(cluster.cone_apex, 1.0)).xyz;
+		let axis = normalize(linear * cluster.cone_axis);
+		if dot(normalize(apex - cull_uniforms.camera_position.xyz), axis) >= cluster.cone_cutoff {
+			return false;
+		}
+	}
+	return true;
+}
+
+@compute @workgroup_size(64)
+fn cs_count(@builtin(global_invocation_id) id: vec3u) {
+	let instance_index = instance_index_of(id);
+	if instance_index >= cull_uniforms.instance_count {
+		return;
+	}
+
+	let late = cull_uniforms.phase == 1u;
+	let instance = instances[instance_index];
+	let model = models[instance.model_index];
+	let axis_scales = world_scale(instance);
+	let scale = max(axis_scales.x, max(axis_scales.y, axis_scales.z));
+	let center = (instance.model * vec4f(model.bounding_sphere.xyz, 1.0)).xyz;
+	let radius = model.bounding_sphere.w * scale;
+	let was_visible = (visibility[instance_index] & visible_bit) != 0u;
+	if outside_frustum(center, radius) {
+		if late {
+			visibility[instance_index] = 0u;
+		} else {
+			visibility[instance_index] = select(0u, visible_bit, was_visible);
+			atomicAdd(&stats[0], 1u);
+		}
+		return;
+	}
+
+	if late {
+		if occluded(center, radius) {
+			visibility[instance_index] = 0u;
+			atomicAdd(&stats[1], 1u);
+			return;
+		}
+		// already drawn by the early phase
+		if was_visible {
+			visibility[instance_index] = visible_bit;
+			return;
+		}
+		visibility[instance_index] = visible_bit | drawn_bit;
+		atomicAdd(&stats[3], 1u);
+	} else {
+		// with occlusion culling the early phase only draws what was visible last frame, the late phase the rest
+		if cull_uniforms.occlusion_culling == 1u && !was_visible {
+			visibility[instance_index] = 0u;
+			return;
+		}
+		visibility[instance_index] = select(0u, visible_bit, was_visible) | drawn_bit;
+		atomicAdd(&stats[2], 1u);
+	}
+
+	for (var cluster_index = model.first_cluster; cluster_index < model.first_cluster + model.cluster_count; cluster_index++) {
+		if cluster_visible(instance, model, cluster_index) {
+			atomicAdd(&ranges[cluster_index].count, 1u);
+		}
+	}
+}
+
+var<workgroup> thread_sums: array<u32, prefix_sum_workgroup_size>;
+
+// a single workgroup, each thread sums a contiguous run of clusters before the runs are scanned
+@compute @workgroup_size(256)
+fn cs_prefix_sum(@builtin(local_invocation_index) thread: u32) {
+	let cluster_count = arrayLength(&clusters);
+	let per_thread = (cluster_count + prefix_sum_workgroup_size - 1u) / prefix_sum_workgroup_size;
+	let first = min(thread * per_thread, cluster_count);
+	let last = min(first + per_thread, cluster_count);
+
+	var sum = 0u;
+	for (var i = first; i < last; i++) {
+		sum += atomicLoad(&ranges[i].count);
+	}
+	thread_sums[thread] = sum;
+	workgroupBarrier();
+	if thread == 0u {
+		var running = 0u;
+		for (var i = 0u; i < prefix_sum_workgroup_size; i++) {
+			let thread_sum = thread_sums[i];
+			thread_sums[i] = running;
+			running += thread_sum;
+		}
+	}
+	workgroupBarrier();
+
+	let capacity = cull_uniforms.visible_capacity;
+	var start = thread_sums[thread];
+	var dropped = 0u;
+	for (var i = first; i < last; i++) {
+		let count = atomicLoad(&ranges[i].count);
+		// counted from zero again by the next phase
+		atomicStore(&ranges[i].count, 0u);
+		let range_first = min(start, capacity);
+		let kept = min(count, capacity - range_first);
+		ranges[i].first = range_first;
+		atomicStore(&ranges[i].cursor, 0u);
+		draws[i].instance_count = kept;
+		draws[i].first_instance = select(0u, range_first, cull_uniforms.indirect_first_instance == 1u);
+		dropped += count - kept;
+		start += count;
+	}
+	if dropped > 0u {
+		atomicAdd(&stats[4], dropped);
+	}
+}
+
+@compute @workgroup_size(64)
+fn cs_scatter(@builtin(global_invocation_id) id: vec3u) {
+	let instance_index = instance_index_of(id);
+	if instance_index >= cull_uniforms.instance_count || (visibility[instance_index] & drawn_bit) == 0u {
+		return;
+	}
+
+	let instance = instances[instance_index];
+	let model = models[instance.model_index];
+	for (var cluster_index = model.first_cluster; cluster_index < model.first_cluster + model.cluster_count; cluster_index++) {
+		if !cluster_visible(instance, model, cluster_index) {
+			continue;
+		}
+		let slot = atomicAdd(&ranges[cluster_index].cursor, 1u);
+		if slot < draws[cluster_index].instance_count {
+			visible_instances[ranges[cluster_index].first + slot] = instance_index;
+		}
+	}
+}
@@ -7,10 +7,12 @@ struct local_uniforms_t {
 	model: mat4x4f,
 	view: mat4x4f,
 	projection: mat4x4f,
-	tint: vec4f,
+	// the material's layer of its texture array (see render_settings::texture_arrays), 0 for textures of their own
+	texture_layer: u32,
 };
+// group 0 is bound once per pass, group 1 once per material & group 2 per draw (at a dynamic offset)
 @group(0) @binding(0) var<uniform> global_uniforms : global_uniforms_t;
-@group(0) @binding(1) var<uniform> local_uniforms : local_uniforms_t;
+@group(2) @binding(0) var<uniform> local_uniforms : local_uniforms_t;
 
 struct vertex_input {
 	@builtin(vertex_index) vertex_index: u32,
@@ -22,29 +24,72 @@ struct vertex_input {
 };
 
 struct vertex_output {
-	@builtin(position) projected_position: vec4f,
+	// invariant so the depth pre-pass and the color pass produce bit identical depth for the Equal test
+	@builtin(position) @invariant projected_position: vec4f,
 	@location(0) world_position: vec3f,
 	@location(1) color: vec4f,
 	@location(2) world_normal: vec3f,
 	@location(3) uv: vec2f,
 	@location(4) camera_view_direction: vec3f,
+	@location(5) @interpolate(flat) texture_layer: u32,
 };
 
-@vertex
-fn vs_main(in: vertex_input) -> vertex_output {
+// compact vertex formats (see fae::vertex_format), the normal is octahedral encoded & color is optional
+struct compact_vertex_input {
+	@location(0) local_position: vec3f,
+	@location(2) octahedral_normal: vec2f,
+	@location(3) uv: vec2f,
+};
+
+struct compact_colored_vertex_input {
+	@location(0) local_position: vec3f,
+	@location(1) color: vec4f,
+	@location(2) octahedral_normal: vec2f,
+	@location(3) uv: vec2f,
+};
+
+fn octahedral_decode(e: vec2f) -> vec3f {
+    var n = vec3f(e.x, e.y, 1.0 - abs(e.x) - abs(e.y));
+    let t = clamp(-n.z, 0.0, 1.0);
+    n.x += select(t, -t, n.x >= 0.0);
+    n.y += select(t, -t, n.y >= 0.0);
+    return normalize(n);
+}
+
+fn transform_vertex(local_position: vec3f, color: vec4f, local_normal: vec3f, uv: vec2f) -> vertex_output {
     let mvp = local_uniforms.projection * local_uniforms.view * local_uniforms.model;
     var out: vertex_output;
-    out.projected_position = mvp * vec4f(in.local_position, 1.0);
-    out.world_position = (local_uniforms.model * vec4f(in.local_position, 1.0)).xyz;
-    out.color = in.color;
-    out.world_normal = normalize(local_uniforms.model * vec4(in.local_normal, 0.0)).xyz;
-    out.uv = in.uv;
+    out.projected_position = mvp * vec4f(local_position, 1.0);
+    out.world_position = (local_uniforms.model * vec4f(local_position, 1.0)).xyz;
+    out.color = color;
+    out.world_normal = normalize(local_uniforms.model * vec4(local_normal, 0.0)).xyz;
+    out.uv = uv;
     out.camera_view_direction = normalize(out.world_position - global_uniforms.camera_world_position);
+    out.texture_layer = local_uniforms.texture_layer;
     return out;
 }
 
-@group(0) @binding(2) var texture : texture_2d<f32>;
-@group(0) @binding(3) var texture_sampler: sampler;
+@vertex
+fn vs_main(in: vertex_input) -> vertex_output {
+    return transform_vertex(in.local_position, in.color, in.local_normal, in.uv);
+}
+
+@vertex
+fn vs_main_compact(in: compact_vertex_input) -> vertex_output {
+    return transform_vertex(in.local_position, vec4f(1.0), octahedral_decode(in.octahedral_normal), in.uv);
+}
+
+@vertex
+fn vs_main_compact_colored(in: compact_colored_vertex_input) -> vertex_output {
+    return transform_vertex(in.local_position, in.color, octahedral_decode(in.octahedral_normal), in.uv);
+}
+
+struct material_uniforms_t {
+	base_color: vec4f,
+};
+@group(1) @binding(0) var<uniform> material_uniforms : material_uniforms_t;
+@group(1) @binding(1) var texture : texture_2d_array<f32>;
+@group(1) @binding(2) var texture_sampler: sampler;
 
 
 const max_lights: u32 = 512;
@@ -60,26 +105,26 @@ struct light_info_t {
 struct ambient_light_info_t {
 	lights: light_info_t,
 }
-@group(0) @binding(4) var<uniform> ambient_light_info : ambient_light_info_t;
+@group(0) @binding(1) var<uniform> ambient_light_info : ambient_light_info_t;
 
 struct directional_light_info_t {
 	directions: array<vec4f, max_lights>,
 	lights: light_info_t,
 }
-@group(0) @binding(5) var<uniform> directional_light_info : directional_light_info_t;
+@group(0) @binding(2) var<uniform> directional_light_info : directional_light_info_t;
 
 @fragment
 fn fs_main(in: vertex_output) -> @location(0) vec4f {
 	// let texel_coords = vec2i(in.uv * vec2f(textureDimensions(texture)));
 	// let texture_color = textureLoad(texture, texel_coords, 0);
-    let texture_color = textureSample(texture, texture_sampler, in.uv);
+    let texture_color = textureSample(texture, texture_sampler, in.uv, in.texture_layer);
     let hardness = 1.0;
     let diffuse_scalar = 0.5;
     let specular_scalar = 0.5;
 
     var color = vec4f(0.0, 0.0, 0.0, 1.0);
 
-    let base_color = local_uniforms.tint * texture_color * in.color;
+    let base_color = material_uniforms.base_color * texture_color * in.color;
 
     for (var i: u32 = 0; i < max_lights; i++) {
         if i >= ambient_light_info.lights.count {
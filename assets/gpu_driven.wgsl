@@ -0,0 +1,145 @@
+// default.wgsl for instances drawn by the gpu_driven_renderer
+// per instance data comes from storage buffers (indexed through the culling pass' visible list) instead of per draw uniforms
+
+struct frame_uniforms_t {
+	view: mat4x4f,
+	projection: mat4x4f,
+	camera_world_position: vec3f,
+	time: f32,
+};
+@group(0) @binding(0) var<uniform> frame_uniforms : frame_uniforms_t;
+
+struct instance_t {
+	model: mat4x4f,
+	model_index: u32,
+	padding0: u32,
+	padding1: u32,
+	padding2: u32,
+};
+@group(1) @binding(0) var<storage, read> instances : array<instance_t>;
+// every draw's instances, compacted by the culling pass. each draw's range starts at its first_instance
+@group(1) @binding(1) var<storage, read> visible_instances : array<u32>;
+
+// the culling pass' ranges (see cull_instances.wgsl), only read without the indirect-first-instance feature
+struct visible_range_t {
+	count: u32,
+	cursor: u32,
+	first: u32,
+};
+@group(1) @binding(2) var<storage, read> ranges : array<visible_range_t>;
+// the draw being recorded, bound with a dynamic offset per draw without the feature (always 0 with it)
+@group(1) @binding(3) var<uniform> draw_index : u32;
+
+// with the feature instance_index already starts at the draw's first_instance
+override indirect_first_instance: bool = true;
+
+struct vertex_input {
+	@builtin(vertex_index) vertex_index: u32,
+	@builtin(instance_index) instance_index: u32,
+	@location(0) local_position: vec3f,
+	@location(1) color: vec4f,
+	@location(2) local_normal: vec3f,
+	@location(3) uv: vec2f,
+};
+
+struct vertex_output {
+	@builtin(position) projected_position: vec4f,
+	@location(0) world_position: vec3f,
+	@location(1) color: vec4f,
+	@location(2) world_normal: vec3f,
+	@location(3) uv: vec2f,
+	@location(4) camera_view_direction: vec3f,
+};
+
+@vertex
+fn vs_main(in: vertex_input) -> vertex_output {
+    let first_instance = select(ranges[draw_index].first, 0u, indirect_first_instance);
+    let model = instances[visible_instances[first_instance + in.instance_index]].model;
+    let mvp = frame_uniforms.projection * frame_uniforms.view * model;
+    var out: vertex_output;
+    out.projected_position = mvp * vec4f(in.local_position, 1.0);
+    out.world_position = (model * vec4f(in.local_position, 1.0)).xyz;
+    out.color = in.color;
+    out.world_normal = normalize(model * vec4(in.local_normal, 0.0)).xyz;
+    out.uv = in.uv;
+    out.camera_view_direction = normalize(out.world_position - frame_uniforms.camera_world_position);
+    return out;
+}
+
+struct material_uniforms_t {
+	base_color: vec4f,
+};
+@group(2) @binding(0) var<uniform> material_uniforms : material_uniforms_t;
+@group(2) @binding(1) var texture : texture_2d<f32>;
+@group(2) @binding(2) var texture_sampler: sampler;
+
+
+const max_lights: u32 = 512;
+
+struct light_info_t {
+	colors: array<vec4f, max_lights>,
+	count: u32,
+	padding0: u32,
+	padding1: u32,
+	padding2: u32,
+}
+
+struct ambient_light_info_t {
+	lights: light_info_t,
+}
+@group(0) @binding(1) var<uniform> ambient_light_info : ambient_light_info_t;
+
+struct directional_light_info_t {
+	directions: array<vec4f, max_lights>,
+	lights: light_info_t,
+}
+@group(0) @binding(2) var<uniform> directional_light_info : directional_light_info_t;
+
+@fragment
+fn fs_main(in: vertex_output) -> @location(0) vec4f {
+	// let texel_coords = vec2i(in.uv * vec2f(textureDimensions(texture)));
+	// let texture_color = textureLoad(texture, texel_coords, 0);
+    let texture_color = textureSample(texture, texture_sampler, in.uv);
+    let hardness = 1.0;
+    let diffuse_scalar = 0.5;
+    let specular_scalar = 0.5;
+
+    var color = vec4f(0.0, 0.0, 0.0, 1.0);
+
+    let base_color = material_uniforms.base_color * texture_color * in.color;
+
+    for (var i: u32 = 0; i < max_lights; i++) {
+        if i >= ambient_light_info.lights.count {
+			break;
+        }
+        let light_color = ambient_light_info.lights.colors[i];
+        let scaled_light_color = vec4f(light_color.a * light_color.rgb, 0.0);
+
+        let ambient = scaled_light_color;
+
+        color += scaled_light_color * base_color;
+    }
+
+    let V = normalize(in.camera_view_direction);
+
+
+    for (var i: u32 = 0; i < max_lights; i++) {
+        if i >= directional_light_info.lights.count {
+			break;
+        }
+        let light_direction = -normalize(directional_light_info.directions[i].xyz);
+        let light_color = directional_light_info.lights.colors[i];
+        let scaled_light_color = vec4f(light_color.a * light_color.rgb, 0.0);
+
+        let diffuse = max(0.0, dot(light_direction, normalize(in.world_normal))) * scaled_light_color;
+
+        let reflect_light_direction = reflect(light_direction, in.world_normal);
+        let specular = pow(max(0.0, dot(reflect_light_direction, in.camera_view_direction)), hardness);
+
+        color += specular_scalar * specular + diffuse_scalar * diffuse * base_color;
+    }
+
+    let gamma_corrected_color = pow(color, vec4f(2.2));
+
+    return gamma_corrected_color;
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+// builds a hi-z pyramid: level 0 is a copy of the depth buffer, every other level keeps the farthest depth of the 2x2 texels below it
+// (odd sized levels fold the last row/column into the texel next to it, so each texel covers its whole footprint)
+
+@group(0) @binding(0) var depth: texture_depth_2d;
+@group(0) @binding(1) var level_0: texture_storage_2d<r32float, write>;
+
+@compute @workgroup_size(8, 8)
+fn cs_copy_depth(@builtin(global_invocation_id) id: vec3u) {
+	let size = textureDimensions(level_0);
+	if id.x >= size.x || id.y >= size.y {
+		return;
+	}
+	textureStore(level_0, id.xy, vec4f(textureLoad(depth, id.xy, 0), 0.0, 0.0, 0.0));
+}
+
+// bindings aren't shared with cs_copy_depth's, both entry points live in one module
+@group(0) @binding(2) var previous_level: texture_2d<f32>;
+@group(0) @binding(3) var next_level: texture_storage_2d<r32float, write>;
+
+@compute @workgroup_size(8, 8)
+fn cs_downsample(@builtin(global_invocation_id) id: vec3u) {
+	let size = textureDimensions(next_level);
+	if id.x >= size.x || id.y >= size.y {
+		return;
+	}
+
+	let previous_size = textureDimensions(previous_level);
+	let first = id.xy * 2u;
+	// the last texel of a row/column also covers the odd texel left over
+	let extra = select(vec2u(0u, 0u), previous_size % 2u, id.xy == size - vec2u(1u, 1u));
+	let last = min(first + vec2u(1u, 1u) + extra, previous_size - vec2u(1u, 1u));
+	var farthest = 0.0;
+	for (var y = first.y; y <= last.y; y++) {
+		for (var x = first.x; x <= last.x; x++) {
+			farthest = max(farthest, textureLoad(previous_level, vec2u(x, y), 0).r);
+		}
+	}
+	textureStore(next_level, id.xy, vec4f(farthest, 0.0, 0.0, 0.0));
+}
@@ -0,0 +1,46 @@
+// downsamples one mip level into the next, matching the cpu path (build_mip_chain without srgb):
+// even sizes use a 2x2 box filter, odd sizes 2n + 1 shrink to n texels that each cover 2 + 1/n source texels (3 weighted taps)
+
+@group(0) @binding(0) var previous_level: texture_2d<f32>;
+@group(0) @binding(1) var next_level: texture_storage_2d<rgba8unorm, write>;
+
+struct filter_taps {
+	index: vec3u,
+	weight: vec3f,
+}
+
+fn make_filter_taps(source_size: u32, destination_size: u32, i: u32) -> filter_taps {
+	if source_size == 1u {
+		return filter_taps(vec3u(0u, 0u, 0u), vec3f(1.0, 0.0, 0.0));
+	}
+	if source_size % 2u == 0u {
+		return filter_taps(vec3u(2u * i, 2u * i + 1u, 2u * i + 1u), vec3f(0.5, 0.5, 0.0));
+	}
+	let n = f32(destination_size);
+	let size = f32(source_size);
+	let fi = f32(i);
+	return filter_taps(vec3u(2u * i, 2u * i + 1u, 2u * i + 2u), vec3f((n - fi) / size, n / size, (fi + 1.0) / size));
+}
+
+@compute @workgroup_size(8, 8)
+fn cs_main(@builtin(global_invocation_id) id: vec3u) {
+	let size = textureDimensions(next_level);
+	if id.x >= size.x || id.y >= size.y {
+		return;
+	}
+
+	let previous_size = textureDimensions(previous_level);
+	let x_taps = make_filter_taps(previous_size.x, size.x, id.x);
+	let y_taps = make_filter_taps(previous_size.y, size.y, id.y);
+	var sum = vec4f(0.0);
+	for (var ty = 0u; ty < 3u; ty++) {
+		for (var tx = 0u; tx < 3u; tx++) {
+			let weight = x_taps.weight[tx] * y_taps.weight[ty];
+			if weight > 0.0 {
+				sum += weight * textureLoad(previous_level, vec2u(x_taps.index[tx], y_taps.index[ty]), 0);
+			}
+		}
+	}
+
+	textureStore(next_level, id.xy, sum);
+}
@@ -0,0 +1,24 @@
+// stretches a scene rendered at a lower resolution over the whole target with bilinear filtering
+// (one triangle covering the screen, no vertex buffer)
+
+@group(0) @binding(0) var scene: texture_2d<f32>;
+@group(0) @binding(1) var scene_sampler: sampler;
+
+struct vertex_output {
+	@builtin(position) position: vec4f,
+	@location(0) uv: vec2f,
+};
+
+@vertex
+fn vs_main(@builtin(vertex_index) index: u32) -> vertex_output {
+	let uv = vec2f(f32((index << 1u) & 2u), f32(index & 2u));
+	var out: vertex_output;
+	out.position = vec4f(uv.x * 2.0 - 1.0, 1.0 - uv.y * 2.0, 0.0, 1.0);
+	out.uv = uv;
+	return out;
+}
+
+@fragment
+fn fs_main(in: vertex_output) -> @location(0) vec4f {
+	return textureSample(scene, scene_sampler, in.uv);
+}
@@ -0,0 +1,283 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <print>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "fae/application/application.hpp"
+#include "fae/camera.hpp"
+#include "fae/core/exit.hpp"
+#include "fae/lighting.hpp"
+#include "fae/rendering/rendering.hpp"
+#include "fae/webgpu/webgpu.hpp"
+
+/*
+draws a large grid of cubes (or another mesh) headless, either through the gpu driven path (compute culling + indirect draws) or one render_model per entity
+reports cpu encode time, gpu time & bytes uploaded per frame, and how many instances the gpu driven path culled
+
+usage: gpu_driven [--cpu] [--mesh path] [--meshlets] [--no-occlusion] [--instances n] [--moving n] [--frames n] [--fallback | --null]
+    --cpu           draw every cube as its own entity through the regular render commands
+    --mesh          draw this mesh instead of cubes, e.g. Utah_teapot_(solid).stl from the asset directory
+    --meshlets      split the mesh into meshlets so it is also culled per cluster (frustum & backfacing normal cones)
+    --no-occlusion  only frustum cull, without the hi-z occlusion culling phase
+    --instances     number of cubes (default 100000)
+    --moving        number of cubes whose transform changes every frame (default 0)
+    --fallback      force dawn's cpu adapter (swiftshader)
+    --null          use dawn's null backend (nothing is rasterized, measures cpu cost only)
+*/
+
+using clock_type = std::chrono::steady_clock;
+
+struct options
+{
+    bool cpu = false;
+    std::filesystem::path mesh{};
+    bool meshlets = false;
+    bool occlusion_culling = true;
+    bool force_fallback_adapter = false;
+    bool null_backend = false;
+    int instances = 100'000;
+    int moving = 0;
+    int frames = 200;
+};
+
+struct results
+{
+    std::vector<double> cpu_encode_ms;
+    std::vector<double> gpu_ms;
+    std::vector<double> bytes_uploaded;
+    fae::render_stats latest_stats{};
+    int frame = 0;
+};
+
+constexpr std::uint32_t width = 1280;
+constexpr std::uint32_t height = 720;
+constexpr float spacing = 3.f;
+
+/* cubes fill a volume around the camera so that roughly a fifth of them are in the frustum */
+auto grid_position(int index, int side) noexcept -> fae::vec3
+{
+    auto x = index % side;
+    auto y = (index / side) % side;
+    auto z = index / (side * side);
+    return fae::vec3{ (x - side / 2) * spacing, (y - side / 2) * spacing, (z - side / 2) * spacing };
+}
+
+auto spin_transform(int index, int side, int frame) noexcept -> fae::transform
+{
+    return fae::transform{
+        .position = grid_position(index, side),
+        .rotation = fae::math::angleAxis(fae::math::radians(0.5f * frame), fae::math::normalize(fae::vec3{ 1.f, static_cast<float>(index % 7), 1.f })),
+    };
+}
+
+auto percentile(std::vector<double> values, double p) -> double
+{
+    if (values.empty())
+    {
+        return 0.0;
+    }
+    std::ranges::sort(values);
+    return values[static_cast<std::size_t>(p * (values.size() - 1))];
+}
+
+auto print_timings(std::string_view name, std::string_view unit, const std::vector<double>& values) -> void
+{
+    auto total = 0.0;
+    for (auto value : values)
+    {
+        total += value;
+    }
+    std::println("{:<14} avg {:12.3f} {}  p50 {:12.3f} {}  p95 {:12.3f} {}", name, total / std::max<std::size_t>(values.size(), 1), unit, percentile(values, 0.5), unit, percentile(values, 0.95), unit);
+}
+
+auto main(int argc, char* argv[]) -> int
+{
+    auto options = ::options{};
+    for (int i = 1; i < argc; ++i)
+    {
+        auto arg = std::string_view(argv[i]);
+        if (arg == "--cpu")
+        {
+            options.cpu = true;
+        }
+        else if (arg == "--mesh" && i + 1 < argc)
+        {
+            options.mesh = argv[++i];
+        }
+        else if (arg == "--meshlets")
+        {
+            options.meshlets = true;
+        }
+        else if (arg == "--no-occlusion")
+        {
+            options.occlusion_culling = false;
+        }
+        else if (arg == "--fallback")
+        {
+            options.force_fallback_adapter = true;
+        }
+        else if (arg == "--null")
+        {
+            options.null_backend = true;
+        }
+        else if (arg == "--instances" && i + 1 < argc)
+        {
+            options.instances = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "--moving" && i + 1 < argc)
+        {
+            options.moving = std::max(0, std::atoi(argv[++i]));
+        }
+        else if (arg == "--frames" && i + 1 < argc)
+        {
+            options.frames = std::max(1, std::atoi(argv[++i]));
+        }
+    }
+    options.moving = std::min(options.moving, options.instances);
+    auto side = static_cast<int>(std::ceil(std::cbrt(static_cast<double>(options.instances))));
+
+    auto mesh = fae::meshes::cube();
+    if (!options.mesh.empty())
+    {
+        auto path = std::filesystem::exists(options.mesh) ? options.mesh : FAE_ASSET_DIR / options.mesh;
+        auto maybe_mesh = fae::mesh::load(path);
+        if (!maybe_mesh)
+        {
+            std::println("failed to load {}", path.string());
+            return fae::exit_failure;
+        }
+        mesh = std::move(*maybe_mesh);
+        // fit the grid's spacing like the unit cube does
+        auto extent = 0.f;
+        for (const auto& vertex : mesh.vertices)
+        {
+            extent = std::max(extent, fae::math::length(vertex.position));
+        }
+        for (auto& vertex : mesh.vertices)
+        {
+            vertex.position /= std::max(extent, 1e-6f);
+        }
+    }
+    if (options.meshlets)
+    {
+        fae::build_meshlets(mesh);
+    }
+
+    auto webgpu_plugin = fae::webgpu_plugin{};
+    webgpu_plugin.headless = true;
+    webgpu_plugin.headless_width = width;
+    webgpu_plugin.headless_height = height;
+    webgpu_plugin.adapter_options.forceFallbackAdapter = options.force_fallback_adapter;
+    if (options.null_backend)
+    {
+        webgpu_plugin.adapter_options.backendType = wgpu::BackendType::Null;
+    }
+
+    auto results = ::results{};
+    auto app = fae::application{};
+    auto benchmark_start = clock_type::now();
+    app
+        .add_plugin(webgpu_plugin)
+        .add_plugin(fae::rendering_plugin{})
+        .add_plugin(fae::lighting_plugin{})
+        .add_system<fae::start_step>([&](const fae::start_step& step)
+            {
+                auto camera_entity = step.ecs_world.create_entity();
+                camera_entity
+                    .set_component<fae::transform>(fae::transform{})
+                    .set_component<fae::camera>(fae::camera{});
+                step.global_entity.set_component<fae::active_camera>(fae::active_camera{ .camera_entity = camera_entity.id });
+                step.global_entity.set_component<fae::render_settings>(fae::render_settings{ .occlusion_culling = options.occlusion_culling });
+                step.ecs_world.create_entity().set_component<fae::ambient_light>(fae::ambient_light{ .color = fae::color{ 80, 80, 80 } });
+                step.ecs_world.create_entity().set_component<fae::directional_light>(fae::directional_light{
+                    .direction = fae::math::normalize(fae::vec3{ 1.f, -1.f, -1.f }),
+                });
+
+                auto model = fae::model{ .mesh = step.assets.add(mesh) };
+                if (options.cpu)
+                {
+                    for (int i = 0; i < options.instances; ++i)
+                    {
+                        step.ecs_world.create_entity()
+                            .set_component<fae::transform>(spin_transform(i, side, 0))
+                            .set_component<fae::model>(model);
+                    }
+                    return;
+                }
+                step.global_entity.use_component<fae::webgpu>([&](fae::webgpu& webgpu)
+                    {
+                        auto model_index = webgpu.gpu_driven.add_model(mesh);
+                        for (int i = 0; i < options.instances; ++i)
+                        {
+                            (void)webgpu.gpu_driven.add_instance(model_index, spin_transform(i, side, 0));
+                        } }); })
+        .add_system<fae::update_step>([&](const fae::update_step& step)
+            {
+                if (options.moving == 0)
+                {
+                    return;
+                }
+                if (options.cpu)
+                {
+                    auto i = 0;
+                    for (auto& [entity, transform, model] : step.ecs_world.query<fae::transform, const fae::model>())
+                    {
+                        if (i >= options.moving)
+                        {
+                            break;
+                        }
+                        transform = spin_transform(i++, side, results.frame);
+                    }
+                    return;
+                }
+                step.global_entity.use_component<fae::webgpu>([&](fae::webgpu& webgpu)
+                    {
+                        for (int i = 0; i < options.moving; ++i)
+                        {
+                            webgpu.gpu_driven.set_transform(i, spin_transform(i, side, results.frame));
+                        } }); })
+        .add_system<fae::post_update_step>([&](const fae::post_update_step& step)
+            {
+                step.global_entity.use_component<fae::webgpu>([&](fae::webgpu& webgpu)
+                    {
+                        auto start = clock_type::now();
+                        fae::wait_for_submitted_work_sync(webgpu.instance, webgpu.device);
+                        results.gpu_ms.push_back(std::chrono::duration<double, std::milli>(clock_type::now() - start).count()); });
+                step.global_entity.use_component<const fae::render_stats>([&](const fae::render_stats& stats)
+                    {
+                        results.cpu_encode_ms.push_back(stats.cpu_encode_time.seconds_f32() * 1000.0);
+                        results.bytes_uploaded.push_back(static_cast<double>(stats.bytes_uploaded));
+                        results.latest_stats = stats; });
+                if (++results.frame >= options.frames)
+                {
+                    step.scheduler.invoke(fae::application_quit{});
+                } });
+    app.run();
+    auto total_ms = std::chrono::duration<double, std::milli>(clock_type::now() - benchmark_start).count();
+
+    std::println("{} frames of {} {} ({} moving, {} triangles, {} meshlets each) at {}x{}, {} path ({})", results.frame, options.instances, options.mesh.empty() ? "cubes" : options.mesh.filename().string(), options.moving,
+        mesh.has_indices() ? mesh.indices.size() / 3 : mesh.vertices.size() / 3, mesh.meshlets.size(), width, height, options.cpu ? "cpu" : "gpu driven", options.null_backend ? "null backend" : options.force_fallback_adapter ? "fallback adapter" : "default adapter");
+    std::println("throughput: {:.1f} frames/s", results.frame / (total_ms / 1000.0));
+    // the first frame uploads every instance, keep it out of the steady state numbers
+    if (results.cpu_encode_ms.size() > 1)
+    {
+        std::println("first frame: cpu encode {:.3f} ms, {:.0f} bytes uploaded", results.cpu_encode_ms.front(), results.bytes_uploaded.front());
+        results.cpu_encode_ms.erase(results.cpu_encode_ms.begin());
+        results.gpu_ms.erase(results.gpu_ms.begin());
+        results.bytes_uploaded.erase(results.bytes_uploaded.begin());
+    }
+    print_timings("cpu encode", "ms", results.cpu_encode_ms);
+    print_timings("gpu (wait)", "ms", results.gpu_ms);
+    print_timings("uploaded", "B ", results.bytes_uploaded);
+    if (!options.cpu)
+    {
+        // counts are read back asynchronously, these describe one of the last frames
+        std::println("culling ({}): {} drawn, {} frustum culled, {} occluded", options.occlusion_culling ? "frustum & occlusion" : "frustum", results.latest_stats.gpu_driven_drawn, results.latest_stats.gpu_driven_frustum_culled, results.latest_stats.gpu_driven_occluded);
+    }
+    return fae::exit_success;
+}
@@ -0,0 +1,418 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <numeric>
+#include <optional>
+#include <print>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "fae/application/application.hpp"
+#include "fae/camera.hpp"
+#include "fae/core/exit.hpp"
+#include "fae/lighting.hpp"
+#include "fae/rendering/rendering.hpp"
+#include "fae/webgpu/webgpu.hpp"
+
+/*
+renders a reference scene headless (offscreen, no window) for a number of frames
+reports cpu encode time, gpu time and compares the last frame against a golden image
+
+usage: headless_render [--fallback | --null] [--frames n] [--pipelined [--frames-in-flight n]] [--depth-prepass] [--dynamic-resolution ms] [--golden path.ppm] [--update-golden] [--dump path.ppm] [--trace path.json]
+    --fallback            force dawn's cpu adapter (swiftshader)
+    --null                use dawn's null backend (nothing is rasterized, measures cpu cost only, no image comparison)
+    --pipelined           don't wait for the gpu after every frame (throughput instead of per frame gpu time)
+    --frames-in-flight    frames submitted before waiting for the gpu when pipelined (default 2), reports their latency
+    --depth-prepass       render with a depth pre-pass (see render_settings::depth_prepass)
+    --dynamic-resolution  scale the scene's resolution to keep frames under this budget, reports the scales used
+    --golden              compare the last frame against this image, written instead if it doesn't exist yet
+    --update-golden       overwrite the golden image with the last frame
+    --dump                write the last frame to this image
+    --trace               write the frames' cpu & gpu timings as a chrome trace (see frame_trace)
+*/
+
+using clock_type = std::chrono::steady_clock;
+
+struct options
+{
+    bool force_fallback_adapter = false;
+    bool null_backend = false;
+    bool pipelined = false;
+    bool depth_prepass = false;
+    std::optional<float> dynamic_resolution_ms;
+    int frames = 300;
+    std::uint32_t frames_in_flight = 2;
+    std::optional<std::filesystem::path> golden_path;
+    bool update_golden = false;
+    std::optional<std::filesystem::path> dump_path;
+    std::filesystem::path trace_path;
+};
+
+struct spin
+{
+    fae::vec3 axis;
+};
+
+struct results
+{
+    std::vector<double> cpu_encode_ms;
+    std::vector<double> gpu_ms;
+    /* per pass gpu times from timestamp queries, by pass label */
+    std::map<std::string, std::vector<double>> gpu_pass_ms;
+    std::vector<double> gpu_frame_ms;
+    std::vector<double> latency_ms;
+    std::vector<double> pacing_wait_ms;
+    std::vector<double> resolution_scale;
+    std::optional<std::uint64_t> last_timed_frame;
+    std::optional<fae::readback_frame> last_frame;
+    int frame = 0;
+};
+
+constexpr std::uint32_t width = 640;
+constexpr std::uint32_t height = 360;
+constexpr int grid_size = 16;
+
+auto build_reference_scene(const fae::start_step& step) noexcept -> void
+{
+    auto camera_entity = step.ecs_world.create_entity();
+    camera_entity
+        .set_component<fae::transform>(fae::transform{
+            .position = { 0.f, 6.f, 28.f },
+            .rotation = fae::math::angleAxis(fae::math::radians(-12.f), fae::vec3(1.f, 0.f, 0.f)),
+        })
+        .set_component<fae::camera>(fae::camera{});
+    step.global_entity.set_component<fae::active_camera>(fae::active_camera{ .camera_entity = camera_entity.id });
+
+    step.ecs_world.create_entity().set_component<fae::ambient_light>(fae::ambient_light{ .color = fae::color{ 80, 80, 80 } });
+    step.ecs_world.create_entity().set_component<fae::directional_light>(fae::directional_light{
+        .direction = fae::math::normalize(fae::vec3{ 1.f, -1.f, -1.f }),
+    });
+
+    auto materials = std::vector<fae::asset_handle<fae::material>>();
+    for (auto path : { "cobblestone_floor_08/cobblestone_floor_08_diff_2k.jpg", "fourareen/fourareen2K_albedo.jpg" })
+    {
+        materials.push_back(step.assets.add(fae::material{ .diffuse = step.assets.load<fae::texture>(path) }));
+    }
+    auto cube = step.assets.add(fae::meshes::cube());
+    for (int x = 0; x < grid_size; ++x)
+    {
+        for (int z = 0; z < grid_size; ++z)
+        {
+            auto position = fae::vec3{ (x - grid_size / 2) * 1.5f, 0.f, (z - grid_size / 2) * -1.5f };
+            step.ecs_world.create_entity()
+                .set_component<fae::transform>(fae::transform{ .position = position })
+                .set_component<fae::model>(fae::model{
+                    .mesh = cube,
+                    .material = materials[(x + z) % materials.size()],
+                })
+                .set_component<spin>(spin{ .axis = fae::math::normalize(fae::vec3{ static_cast<float>(x + 1), static_cast<float>(z + 1), 1.f }) });
+        }
+    }
+}
+
+auto write_ppm(const std::filesystem::path& path, const fae::readback_frame& frame) -> bool
+{
+    auto file = std::ofstream(path, std::ios::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+    file << "P6\n"
+         << frame.width << " " << frame.height << "\n255\n";
+    for (std::size_t i = 0; i < static_cast<std::size_t>(frame.width) * frame.height; ++i)
+    {
+        file.write(reinterpret_cast<const char*>(frame.pixels.data() + i * 4), 3);
+    }
+    return true;
+}
+
+auto read_ppm(const std::filesystem::path& path) -> std::optional<fae::readback_frame>
+{
+    auto file = std::ifstream(path, std::ios::binary);
+    auto magic = std::string();
+    auto frame = fae::readback_frame{};
+    auto max_value = 0;
+    if (!(file >> magic >> frame.width >> frame.height >> max_value) || magic != "P6" || max_value != 255)
+    {
+        return std::nullopt;
+    }
+    file.get();
+    frame.pixels.resize(static_cast<std::size_t>(frame.width) * frame.height * 4, 255);
+    for (std::size_t i = 0; i < static_cast<std::size_t>(frame.width) * frame.height; ++i)
+    {
+        file.read(reinterpret_cast<char*>(frame.pixels.data() + i * 4), 3);
+    }
+    return file ? std::optional(std::move(frame)) : std::nullopt;
+}
+
+/* rgb only, alpha is not part of the golden images */
+auto compare(const fae::readback_frame& frame, const fae::readback_frame& golden) -> bool
+{
+    if (frame.width != golden.width || frame.height != golden.height)
+    {
+        std::println("image diff: size mismatch ({}x{} vs golden {}x{})", frame.width, frame.height, golden.width, golden.height);
+        return false;
+    }
+    constexpr int tolerance = 2;
+    constexpr double max_mismatched_ratio = 0.001;
+    auto max_difference = 0;
+    auto mismatched_pixels = std::size_t{ 0 };
+    auto squared_error = 0.0;
+    auto pixel_count = static_cast<std::size_t>(frame.width) * frame.height;
+    for (std::size_t i = 0; i < pixel_count; ++i)
+    {
+        auto pixel_difference = 0;
+        for (std::size_t channel = 0; channel < 3; ++channel)
+        {
+            auto difference = std::abs(static_cast<int>(frame.pixels[i * 4 + channel]) - static_cast<int>(golden.pixels[i * 4 + channel]));
+            pixel_difference = std::max(pixel_difference, difference);
+            squared_error += difference * difference;
+        }
+        max_difference = std::max(max_difference, pixel_difference);
+        mismatched_pixels += pixel_difference > tolerance ? 1 : 0;
+    }
+    auto rmse = std::sqrt(squared_error / (pixel_count * 3));
+    auto mismatched_ratio = static_cast<double>(mismatched_pixels) / pixel_count;
+    std::println("image diff: max {} rmse {:.3f} mismatched pixels {} ({:.4f}%)", max_difference, rmse, mismatched_pixels, mismatched_ratio * 100.0);
+    return mismatched_ratio <= max_mismatched_ratio;
+}
+
+auto percentile(std::vector<double> values, double p) -> double
+{
+    if (values.empty())
+    {
+        return 0.0;
+    }
+    std::ranges::sort(values);
+    return values[static_cast<std::size_t>(p * (values.size() - 1))];
+}
+
+auto print_timings(std::string_view name, const std::vector<double>& milliseconds) -> void
+{
+    auto total = 0.0;
+    for (auto value : milliseconds)
+    {
+        total += value;
+    }
+    std::println("{:<18} avg {:8.3f} ms  p50 {:8.3f} ms  p95 {:8.3f} ms", name, total / std::max<std::size_t>(milliseconds.size(), 1), percentile(milliseconds, 0.5), percentile(milliseconds, 0.95));
+}
+
+auto main(int argc, char* argv[]) -> int
+{
+    auto options = ::options{};
+    for (int i = 1; i < argc; ++i)
+    {
+        auto arg = std::string_view(argv[i]);
+        if (arg == "--fallback")
+        {
+            options.force_fallback_adapter = true;
+        }
+        else if (arg == "--null")
+        {
+            options.null_backend = true;
+        }
+        else if (arg == "--pipelined")
+        {
+            options.pipelined = true;
+        }
+        else if (arg == "--depth-prepass")
+        {
+            options.depth_prepass = true;
+        }
+        else if (arg == "--dynamic-resolution" && i + 1 < argc)
+        {
+            options.dynamic_resolution_ms = static_cast<float>(std::atof(argv[++i]));
+        }
+        else if (arg == "--frames-in-flight" && i + 1 < argc)
+        {
+            options.frames_in_flight = static_cast<std::uint32_t>(std::max(1, std::atoi(argv[++i])));
+        }
+        else if (arg == "--frames" && i + 1 < argc)
+        {
+            options.frames = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "--golden" && i + 1 < argc)
+        {
+            options.golden_path = argv[++i];
+        }
+        else if (arg == "--update-golden")
+        {
+            options.update_golden = true;
+        }
+        else if (arg == "--dump" && i + 1 < argc)
+        {
+            options.dump_path = argv[++i];
+        }
+        else if (arg == "--trace" && i + 1 < argc)
+        {
+            options.trace_path = argv[++i];
+        }
+    }
+
+    auto webgpu_plugin = fae::webgpu_plugin{};
+    webgpu_plugin.headless = true;
+    webgpu_plugin.headless_width = width;
+    webgpu_plugin.headless_height = height;
+    webgpu_plugin.read_back_frames = !options.null_backend;
+    webgpu_plugin.max_frames_in_flight = options.frames_in_flight;
+    webgpu_plugin.adapter_options.forceFallbackAdapter = options.force_fallback_adapter;
+    if (options.null_backend)
+    {
+        webgpu_plugin.adapter_options.backendType = wgpu::BackendType::Null;
+    }
+
+    auto results = ::results{};
+    auto app = fae::application{};
+    auto benchmark_start = clock_type::now();
+    app
+        .add_plugin(webgpu_plugin)
+        .add_plugin(fae::rendering_plugin{ .trace_path = options.trace_path })
+        .add_plugin(fae::lighting_plugin{})
+        .add_system<fae::start_step>(build_reference_scene)
+        .add_system<fae::start_step>([&](const fae::start_step& step)
+            {
+                auto& settings = step.global_entity.get_or_set_component<fae::render_settings>(fae::render_settings{});
+                settings.depth_prepass = options.depth_prepass;
+                if (options.dynamic_resolution_ms)
+                {
+                    settings.dynamic_resolution.enabled = true;
+                    settings.dynamic_resolution.target_frame_ms = *options.dynamic_resolution_ms;
+                } })
+        .add_system<fae::update_step>([&](const fae::update_step& step)
+            {
+                // driven by the frame number instead of time so every run renders the same images
+                auto angle = fae::math::radians(0.5f * results.frame);
+                for (auto& [entity, transform, spin] : step.ecs_world.query<fae::transform, const spin>())
+                {
+                    transform.rotation = fae::math::angleAxis(angle, spin.axis);
+                } })
+        .add_system<fae::post_update_step>([&](const fae::post_update_step& step)
+            {
+                step.global_entity.use_component<fae::webgpu>([&](fae::webgpu& webgpu)
+                    {
+                        if (!options.pipelined)
+                        {
+                            auto start = clock_type::now();
+                            fae::wait_for_submitted_work_sync(webgpu.instance, webgpu.device);
+                            results.gpu_ms.push_back(std::chrono::duration<double, std::milli>(clock_type::now() - start).count());
+                        }
+                        if (webgpu.readback)
+                        {
+                            for (auto& frame : webgpu.readback->take_completed())
+                            {
+                                results.last_frame = std::move(frame);
+                            }
+                        } });
+                step.global_entity.use_component<const fae::render_stats>([&](const fae::render_stats& stats)
+                    {
+                        results.cpu_encode_ms.push_back(stats.cpu_encode_time.seconds_f32() * 1000.0);
+                        results.latency_ms.push_back(stats.frame_latency.seconds_f32() * 1000.0);
+                        results.pacing_wait_ms.push_back(stats.frame_pacing_wait.seconds_f32() * 1000.0);
+                        results.resolution_scale.push_back(stats.resolution_scale); });
+                step.global_entity.use_component<const fae::gpu_frame_stats>([&](const fae::gpu_frame_stats& stats)
+                    {
+                        // the same results are republished until a newer frame is read back, count each frame once
+                        if (stats.passes.empty() || results.last_timed_frame == stats.frame)
+                        {
+                            return;
+                        }
+                        results.last_timed_frame = stats.frame;
+                        results.gpu_frame_ms.push_back(stats.total.seconds_f32() * 1000.0);
+                        for (const auto& pass_time : stats.passes)
+                        {
+                            results.gpu_pass_ms[pass_time.label].push_back(pass_time.time.seconds_f32() * 1000.0);
+                        } });
+                if (++results.frame >= options.frames)
+                {
+                    step.scheduler.invoke(fae::application_quit{});
+                } });
+    app.run();
+
+    // collect the frames still being read back
+    app.global_entity.use_component<fae::webgpu>([&](fae::webgpu& webgpu)
+        {
+            fae::wait_for_submitted_work_sync(webgpu.instance, webgpu.device);
+            while (webgpu.readback && webgpu.readback->frames_in_flight() > 0)
+            {
+                webgpu.instance.ProcessEvents();
+            }
+            if (webgpu.readback)
+            {
+                for (auto& frame : webgpu.readback->take_completed())
+                {
+                    results.last_frame = std::move(frame);
+                }
+                std::println("frames read back: {} dropped: {}", static_cast<std::size_t>(results.frame) - webgpu.readback->frames_dropped(), webgpu.readback->frames_dropped());
+            } });
+    auto total_ms = std::chrono::duration<double, std::milli>(clock_type::now() - benchmark_start).count();
+
+    std::println("{} frames of {} cubes at {}x{}{} ({})", results.frame, grid_size * grid_size, width, height, options.depth_prepass ? " with a depth pre-pass" : "", options.null_backend ? "null backend" : options.force_fallback_adapter ? "fallback adapter" : "default adapter");
+    std::println("throughput: {:.1f} frames/s", results.frame / (total_ms / 1000.0));
+    print_timings("cpu encode", results.cpu_encode_ms);
+    if (!options.pipelined)
+    {
+        print_timings("gpu (wait)", results.gpu_ms);
+    }
+    else
+    {
+        std::println("frames in flight: {}", options.frames_in_flight);
+        print_timings("frame latency", results.latency_ms);
+        print_timings("pacing wait", results.pacing_wait_ms);
+    }
+    if (!results.gpu_frame_ms.empty())
+    {
+        print_timings("gpu (timestamps)", results.gpu_frame_ms);
+    }
+    for (const auto& [label, milliseconds] : results.gpu_pass_ms)
+    {
+        print_timings(label, milliseconds);
+    }
+    if (options.dynamic_resolution_ms)
+    {
+        std::println("dynamic resolution with a {:.2f} ms budget: scale avg {:.3f} min {:.3f} last {:.3f}", *options.dynamic_resolution_ms,
+            std::accumulate(results.resolution_scale.begin(), results.resolution_scale.end(), 0.0) / std::max<std::size_t>(results.resolution_scale.size(), 1),
+            results.resolution_scale.empty() ? 1.0 : std::ranges::min(results.resolution_scale),
+            results.resolution_scale.empty() ? 1.0 : results.resolution_scale.back());
+    }
+
+    if (!results.last_frame)
+    {
+        if (!options.null_backend)
+        {
+            std::println("no frame was read back");
+            return fae::exit_failure;
+        }
+        return fae::exit_success;
+    }
+    if (options.dump_path && !write_ppm(*options.dump_path, *results.last_frame))
+    {
+        std::println("failed to write {}", options.dump_path->string());
+    }
+    if (!options.golden_path)
+    {
+        return fae::exit_success;
+    }
+    if (options.update_golden || !std::filesystem::exists(*options.golden_path))
+    {
+        if (!write_ppm(*options.golden_path, *results.last_frame))
+        {
+            std::println("failed to write golden image {}", options.golden_path->string());
+            return fae::exit_failure;
+        }
+        std::println("wrote golden image {}", options.golden_path->string());
+        return fae::exit_success;
+    }
+    auto golden = read_ppm(*options.golden_path);
+    if (!golden)
+    {
+        std::println("failed to read golden image {}", options.golden_path->string());
+        return fae::exit_failure;
+    }
+    return compare(*results.last_frame, *golden) ? fae::exit_success : fae::exit_failure;
+}
@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <print>
+#include <string_view>
+#include <vector>
+
+#include "fae/core/exit.hpp"
+#include "fae/rendering/cooked_mesh.hpp"
+#include "fae/rendering/mesh.hpp"
+
+/*
+compares loading meshes through assimp (parsing the source & optimizing it, what mesh::load does by default) with loading them cooked
+(mapped & copied without parsing, see cooked_mesh.hpp). meshes are cooked into a temporary directory first, the asset directory is untouched
+
+usage: mesh_loading [--iterations n] [mesh paths...] (default: cube.obj, Suzanne.stl & the teapot in the asset directory)
+    --iterations   loads of each mesh per path, the median is reported (default 20)
+*/
+
+using clock_type = std::chrono::steady_clock;
+
+/* median of iterations loads in ms, nullopt if any load failed */
+auto time_loads(int iterations, const std::function<std::optional<fae::mesh>()>& load) -> std::optional<double>
+{
+    auto times_ms = std::vector<double>();
+    for (int i = 0; i < iterations; ++i)
+    {
+        auto start = clock_type::now();
+        auto mesh = load();
+        times_ms.push_back(std::chrono::duration<double, std::milli>(clock_type::now() - start).count());
+        if (!mesh)
+        {
+            return std::nullopt;
+        }
+    }
+    std::ranges::sort(times_ms);
+    return times_ms[times_ms.size() / 2];
+}
+
+auto main(int argc, char* argv[]) -> int
+{
+    auto iterations = 20;
+    auto paths = std::vector<std::filesystem::path>();
+    for (int i = 1; i < argc; ++i)
+    {
+        auto arg = std::string_view(argv[i]);
+        if (arg == "--iterations" && i + 1 < argc)
+        {
+            iterations = std::max(std::atoi(argv[++i]), 1);
+        }
+        else
+        {
+            paths.emplace_back(arg);
+        }
+    }
+    if (paths.empty())
+    {
+        for (const auto& name : { "cube.obj", "Suzanne.stl", "Utah_teapot_(solid).stl" })
+        {
+            paths.push_back(FAE_ASSET_DIR / std::filesystem::path(name));
+        }
+    }
+
+    auto cooked_directory = std::filesystem::temp_directory_path() / "fae_mesh_loading";
+    std::filesystem::create_directories(cooked_directory);
+    std::println("{:<26} {:>9} {:>10} {:>12} {:>12} {:>12} {:>9}", "mesh", "vertices", "triangles", "assimp ms", "+optimize ms", "cooked ms", "speedup");
+    for (const auto& path : paths)
+    {
+        auto source = fae::mesh::load(path);
+        auto cooked_path = fae::cooked_mesh_path(cooked_directory / path.filename());
+        if (!source || !fae::write_cooked_mesh(*source, cooked_path))
+        {
+            std::println("failed to load & cook {}", path.string());
+            return fae::exit_failure;
+        }
+
+        auto imported_ms = time_loads(iterations, [&]
+            { return fae::mesh::load(path, fae::mesh_import_options{ .optimize = false }); });
+        auto optimized_ms = time_loads(iterations, [&]
+            { return fae::mesh::load(path); });
+        auto cooked_ms = time_loads(iterations, [&]
+            { return fae::mesh::load(cooked_path); });
+        if (!imported_ms || !optimized_ms || !cooked_ms)
+        {
+            std::println("failed to load {}", path.string());
+            return fae::exit_failure;
+        }
+        // against what the cooked file replaces, the optimized import
+        std::println("{:<26} {:>9} {:>10} {:>12.3f} {:>12.3f} {:>12.3f} {:>8.1f}x", path.filename().string(), source->vertices.size(), source->indices.size() / 3,
+            *imported_ms, *optimized_ms, *cooked_ms, *optimized_ms / std::max(*cooked_ms, 1e-6));
+    }
+    std::filesystem::remove_all(cooked_directory);
+    return fae::exit_success;
+}
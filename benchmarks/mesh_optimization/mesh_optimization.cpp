@@ -0,0 +1,60 @@
+#include <chrono>
+#include <filesystem>
+#include <print>
+#include <string_view>
+#include <vector>
+
+#include "fae/core/exit.hpp"
+#include "fae/rendering/mesh.hpp"
+#include "fae/rendering/mesh_optimizer.hpp"
+
+/*
+imports meshes without & with the import time optimization and reports their gpu efficiency (see analyze_mesh)
+
+usage: mesh_optimization [mesh paths...] (default: the stl meshes in the asset directory)
+*/
+
+using clock_type = std::chrono::steady_clock;
+
+auto print_statistics(std::string_view stage, const fae::mesh& mesh) -> void
+{
+    auto statistics = fae::analyze_mesh(mesh);
+    std::println("  {:<10} {:8} vertices {:8} triangles  acmr {:6.3f}  atvr {:6.3f}  overdraw {:6.3f}  overfetch {:6.3f}",
+        stage, mesh.vertices.size(), mesh.indices.size() / 3, statistics.acmr, statistics.atvr, statistics.overdraw, statistics.overfetch);
+}
+
+auto main(int argc, char* argv[]) -> int
+{
+    auto paths = std::vector<std::filesystem::path>();
+    for (int i = 1; i < argc; ++i)
+    {
+        paths.emplace_back(argv[i]);
+    }
+    if (paths.empty())
+    {
+        for (const auto& name : { "Suzanne.stl", "Utah_teapot_(solid).stl", "cube.obj" })
+        {
+            paths.push_back(FAE_ASSET_DIR / std::filesystem::path(name));
+        }
+    }
+
+    for (const auto& path : paths)
+    {
+        auto imported = fae::mesh::load(path, fae::mesh_import_options{ .optimize = false });
+        if (!imported)
+        {
+            std::println("failed to load {}", path.string());
+            return fae::exit_failure;
+        }
+        std::println("{}", path.filename().string());
+        print_statistics("imported", *imported);
+
+        auto optimized = *imported;
+        auto start = clock_type::now();
+        fae::optimize_mesh(optimized);
+        auto optimize_ms = std::chrono::duration<double, std::milli>(clock_type::now() - start).count();
+        print_statistics("optimized", optimized);
+        std::println("  optimized in {:.3f} ms", optimize_ms);
+    }
+    return fae::exit_success;
+}
@@ -0,0 +1,110 @@
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <print>
+#include <span>
+#include <vector>
+
+#include "fae/core/exit.hpp"
+#include "fae/rendering/mip_chain.hpp"
+#include "fae/rendering/texture.hpp"
+
+/*
+times build_mip_chain against the per level loop create_texture_with_mips_and_view used before it
+
+usage: mip_chain [iterations]
+*/
+
+using clock_type = std::chrono::steady_clock;
+
+/* the previous implementation: column major, one allocation per level, truncating average, no odd size handling */
+auto legacy_mip_chain(const std::uint8_t* rgba8, std::uint32_t width, std::uint32_t height) -> std::vector<std::vector<unsigned char>>
+{
+    auto levels = std::vector<std::vector<unsigned char>>();
+    auto level_count = static_cast<std::uint32_t>(std::bit_width(std::max(width, height)));
+    auto mip_width = width;
+    auto mip_height = height;
+    std::vector<unsigned char> previous_level_pixels;
+    std::uint32_t previous_width = 0;
+    for (std::uint32_t level = 0; level < level_count; ++level)
+    {
+        std::vector<unsigned char> pixels(4 * mip_width * mip_height);
+        if (level == 0)
+        {
+            std::memcpy(pixels.data(), rgba8, pixels.size());
+        }
+        else
+        {
+            for (std::uint32_t i = 0; i < mip_width; ++i)
+            {
+                for (std::uint32_t j = 0; j < mip_height; ++j)
+                {
+                    unsigned char* p = &pixels[4 * (j * mip_width + i)];
+                    unsigned char* p00 = &previous_level_pixels[4 * ((2 * j + 0) * previous_width + (2 * i + 0))];
+                    unsigned char* p01 = &previous_level_pixels[4 * ((2 * j + 0) * previous_width + (2 * i + 1))];
+                    unsigned char* p10 = &previous_level_pixels[4 * ((2 * j + 1) * previous_width + (2 * i + 0))];
+                    unsigned char* p11 = &previous_level_pixels[4 * ((2 * j + 1) * previous_width + (2 * i + 1))];
+                    p[0] = (p00[0] + p01[0] + p10[0] + p11[0]) / 4;
+                    p[1] = (p00[1] + p01[1] + p10[1] + p11[1]) / 4;
+                    p[2] = (p00[2] + p01[2] + p10[2] + p11[2]) / 4;
+                    p[3] = (p00[3] + p01[3] + p10[3] + p11[3]) / 4;
+                }
+            }
+        }
+        levels.push_back(pixels);
+        previous_level_pixels = std::move(pixels);
+        previous_width = mip_width;
+        mip_width /= 2;
+        mip_height /= 2;
+    }
+    return levels;
+}
+
+auto milliseconds_per_iteration(int iterations, const std::function<void()>& fn) -> double
+{
+    auto start = clock_type::now();
+    for (int i = 0; i < iterations; ++i)
+    {
+        fn();
+    }
+    return std::chrono::duration<double, std::milli>(clock_type::now() - start).count() / iterations;
+}
+
+auto main(int argc, char* argv[]) -> int
+{
+    auto iterations = argc > 1 ? std::max(1, std::atoi(argv[1])) : 20;
+
+    for (auto path : { "cobblestone_floor_08/cobblestone_floor_08_diff_2k.jpg", "fourareen/fourareen2K_albedo.jpg" })
+    {
+        auto maybe_texture = fae::texture::load(FAE_ASSET_DIR / std::filesystem::path(path));
+        if (!maybe_texture)
+        {
+            return fae::exit_failure;
+        }
+        auto& texture = *maybe_texture;
+        auto pixels = std::span(reinterpret_cast<const std::uint8_t*>(texture.data.data()), texture.data.size() * sizeof(fae::color));
+        auto width = static_cast<std::uint32_t>(texture.width);
+        auto height = static_cast<std::uint32_t>(texture.height);
+
+        auto legacy_ms = milliseconds_per_iteration(iterations, [&]
+            { [[maybe_unused]] auto levels = legacy_mip_chain(pixels.data(), width, height); });
+        auto single_thread_ms = milliseconds_per_iteration(iterations, [&]
+            { [[maybe_unused]] auto chain = fae::build_mip_chain(pixels, width, height, { .parallel_texel_threshold = 0 }); });
+        auto parallel_ms = milliseconds_per_iteration(iterations, [&]
+            { [[maybe_unused]] auto chain = fae::build_mip_chain(pixels, width, height); });
+        auto srgb_ms = milliseconds_per_iteration(iterations, [&]
+            { [[maybe_unused]] auto chain = fae::build_mip_chain(pixels, width, height, { .srgb = true }); });
+
+        std::println("{} ({}x{}, {} iterations)", path, width, height, iterations);
+        std::println("    legacy loop:               {:8.3f} ms", legacy_ms);
+        std::println("    build_mip_chain (1 thread):{:8.3f} ms ({:.2f}x)", single_thread_ms, legacy_ms / single_thread_ms);
+        std::println("    build_mip_chain:           {:8.3f} ms ({:.2f}x)", parallel_ms, legacy_ms / parallel_ms);
+        std::println("    build_mip_chain (srgb):    {:8.3f} ms ({:.2f}x)", srgb_ms, legacy_ms / srgb_ms);
+    }
+
+    return fae::exit_success;
+}
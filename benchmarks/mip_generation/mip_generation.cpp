@@ -0,0 +1,149 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <print>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "fae/core/exit.hpp"
+#include "fae/rendering/mip_chain.hpp"
+#include "fae/rendering/texture.hpp"
+#include "fae/webgpu/mip_generator.hpp"
+#include "fae/webgpu/utils.hpp"
+
+/*
+compares cpu mip generation against the compute shader path on the 2k assets
+and checks every generated level against build_mip_chain, which rounds its averages like the shader's unorm stores do
+(1 lsb tolerance: stores of an exact .5 may round to even where the cpu rounds up)
+
+usage: mip_generation [--fallback] [iterations]
+    --fallback   force dawn's cpu adapter (swiftshader), e.g. on machines without a gpu
+*/
+
+using clock_type = std::chrono::steady_clock;
+
+auto milliseconds_since(clock_type::time_point start) -> double
+{
+    return std::chrono::duration<double, std::milli>(clock_type::now() - start).count();
+}
+
+/* reads every level generated on the gpu back & compares it with the cpu chain, printing the levels that differ */
+auto gpu_levels_match(const wgpu::Instance& instance, const wgpu::Device& device, const fae::texture& texture, fae::mip_generator& mip_generator) -> bool
+{
+    auto expected = fae::build_mip_chain(std::span(reinterpret_cast<const std::uint8_t*>(texture.data.data()), texture.data.size() * sizeof(fae::color)), texture.width, texture.height);
+    auto gpu = fae::create_texture_with_gpu_mips_and_view(device, texture, mip_generator);
+    auto all_levels_match = gpu.texture.GetMipLevelCount() == expected.levels.size();
+    for (std::uint32_t level = 0; level < std::min<std::size_t>(gpu.texture.GetMipLevelCount(), expected.levels.size()); ++level)
+    {
+        auto expected_level = expected.level_data(level);
+        auto actual = fae::read_texture_sync(instance, device, gpu.texture, level);
+        auto max_difference = 0;
+        for (std::size_t i = 0; i < std::min(expected_level.size(), actual.size()); ++i)
+        {
+            max_difference = std::max(max_difference, std::abs(static_cast<int>(expected_level[i]) - static_cast<int>(actual[i])));
+        }
+        auto matches = expected_level.size() == actual.size() && max_difference <= 1;
+        all_levels_match = all_levels_match && matches;
+        if (!matches)
+        {
+            std::println("    level {} ({}x{}) differs from the cpu reference (max difference {})", level, expected.levels[level].width, expected.levels[level].height, max_difference);
+        }
+    }
+    gpu.texture.Destroy();
+    return all_levels_match;
+}
+
+auto main(int argc, char* argv[]) -> int
+{
+    auto force_fallback_adapter = false;
+    auto iterations = 10;
+    for (int i = 1; i < argc; ++i)
+    {
+        auto arg = std::string_view(argv[i]);
+        if (arg == "--fallback")
+        {
+            force_fallback_adapter = true;
+        }
+        else
+        {
+            iterations = std::max(1, std::atoi(argv[i]));
+        }
+    }
+
+    auto instance = wgpu::CreateInstance();
+    auto adapter_options = wgpu::RequestAdapterOptions{};
+    adapter_options.forceFallbackAdapter = force_fallback_adapter;
+    auto adapter = fae::request_adapter_sync(instance, adapter_options);
+    auto device = fae::request_device_sync(adapter);
+    auto mip_generator = fae::mip_generator{};
+    // textures fall back to cpu mips until the pipeline is compiled, only gpu generated chains are measured & checked
+    mip_generator.prepare(device);
+    while (!mip_generator.ready() && !mip_generator.failed())
+    {
+        instance.ProcessEvents();
+    }
+    if (mip_generator.failed())
+    {
+        return fae::exit_failure;
+    }
+
+    auto all_levels_match = true;
+    for (auto path : { "cobblestone_floor_08/cobblestone_floor_08_diff_2k.jpg", "fourareen/fourareen2K_albedo.jpg" })
+    {
+        auto maybe_texture = fae::texture::load(FAE_ASSET_DIR / std::filesystem::path(path));
+        if (!maybe_texture)
+        {
+            return fae::exit_failure;
+        }
+        auto& texture = *maybe_texture;
+
+        // warm up
+        fae::create_texture_with_gpu_mips_and_view(device, texture, mip_generator).texture.Destroy();
+        fae::wait_for_submitted_work_sync(instance, device);
+
+        auto cpu_main_thread_ms = 0.0;
+        auto cpu_total_ms = 0.0;
+        auto gpu_main_thread_ms = 0.0;
+        auto gpu_total_ms = 0.0;
+        for (int i = 0; i < iterations; ++i)
+        {
+            auto start = clock_type::now();
+            auto cpu = fae::create_texture_with_mips_and_view(device, texture);
+            cpu_main_thread_ms += milliseconds_since(start);
+            fae::wait_for_submitted_work_sync(instance, device);
+            cpu_total_ms += milliseconds_since(start);
+            cpu.texture.Destroy();
+
+            start = clock_type::now();
+            auto gpu = fae::create_texture_with_gpu_mips_and_view(device, texture, mip_generator);
+            gpu_main_thread_ms += milliseconds_since(start);
+            fae::wait_for_submitted_work_sync(instance, device);
+            gpu_total_ms += milliseconds_since(start);
+            gpu.texture.Destroy();
+        }
+
+        std::println("{} ({}x{}, {} iterations)", path, texture.width, texture.height, iterations);
+        std::println("    cpu mips: {:.3f} ms main thread, {:.3f} ms until complete", cpu_main_thread_ms / iterations, cpu_total_ms / iterations);
+        std::println("    gpu mips: {:.3f} ms main thread, {:.3f} ms until complete", gpu_main_thread_ms / iterations, gpu_total_ms / iterations);
+
+        all_levels_match = gpu_levels_match(instance, device, texture, mip_generator) && all_levels_match;
+    }
+
+    // the assets are powers of two, odd sized levels (filtered with 3 weighted taps) are checked on a generated texture
+    auto odd_sized = fae::texture{ .width = 37, .height = 19 };
+    for (std::size_t i = 0; i < odd_sized.width * odd_sized.height; ++i)
+    {
+        odd_sized.data.push_back(fae::color{
+            .r = static_cast<std::uint8_t>(i * 7),
+            .g = static_cast<std::uint8_t>(i * 13 + 5),
+            .b = static_cast<std::uint8_t>(i / odd_sized.width * 17),
+            .a = static_cast<std::uint8_t>(255 - i % 64),
+        });
+    }
+    std::println("generated {}x{}", odd_sized.width, odd_sized.height);
+    all_levels_match = gpu_levels_match(instance, device, odd_sized, mip_generator) && all_levels_match;
+
+    return all_levels_match ? fae::exit_success : fae::exit_failure;
+}
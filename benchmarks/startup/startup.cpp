@@ -0,0 +1,216 @@
+#include <chrono>
+#include <filesystem>
+#include <optional>
+#include <print>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "fae/application/application.hpp"
+#include "fae/camera.hpp"
+#include "fae/core/exit.hpp"
+#include "fae/lighting.hpp"
+#include "fae/rendering/cooked_texture.hpp"
+#include "fae/rendering/rendering.hpp"
+#include "fae/webgpu/webgpu.hpp"
+
+/*
+measures how long it takes from launch until the first frame is drawn with every render pipeline ready
+run it once with --cold (empty pipeline cache) and once more without (warm cache) to compare
+
+usage: startup [--cold | --no-cache] [--async-assets] [--cooked] [--cache path] [--fallback | --null]
+    --cold       delete the pipeline cache before starting
+    --no-cache   run without a pipeline cache
+    --async-assets  load the textures with load_async, the start step returns before they are decoded
+    --cooked     load the textures cooked (see cooked_texture.hpp), they are cooked into a temporary directory before launching
+    --cache      pipeline cache directory (default: a directory in the system's temporary directory)
+    --fallback   force dawn's cpu adapter (swiftshader)
+    --null       use dawn's null backend
+*/
+
+using clock_type = std::chrono::steady_clock;
+
+struct options
+{
+    bool cold = false;
+    bool no_cache = false;
+    bool async_assets = false;
+    bool cooked = false;
+    bool force_fallback_adapter = false;
+    bool null_backend = false;
+    std::filesystem::path cache_directory = std::filesystem::temp_directory_path() / "fae_startup_benchmark_cache";
+};
+
+auto milliseconds_since(clock_type::time_point start, clock_type::time_point end) -> double
+{
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+auto main(int argc, char* argv[]) -> int
+{
+    auto options = ::options{};
+    for (int i = 1; i < argc; ++i)
+    {
+        auto arg = std::string_view(argv[i]);
+        if (arg == "--cold")
+        {
+            options.cold = true;
+        }
+        else if (arg == "--no-cache")
+        {
+            options.no_cache = true;
+        }
+        else if (arg == "--async-assets")
+        {
+            options.async_assets = true;
+        }
+        else if (arg == "--cooked")
+        {
+            options.cooked = true;
+        }
+        else if (arg == "--cache" && i + 1 < argc)
+        {
+            options.cache_directory = argv[++i];
+        }
+        else if (arg == "--fallback")
+        {
+            options.force_fallback_adapter = true;
+        }
+        else if (arg == "--null")
+        {
+            options.null_backend = true;
+        }
+    }
+    if (options.cold)
+    {
+        auto error = std::error_code{};
+        std::filesystem::remove_all(options.cache_directory, error);
+    }
+
+    // the 2k textures, decoded from jpg & mipped at upload unless cooked
+    auto texture_paths = std::vector<std::filesystem::path>{ "fourareen/fourareen2K_albedo.jpg", "cobblestone_floor_08/cobblestone_floor_08_diff_2k.jpg" };
+    auto cooked_directory = std::filesystem::temp_directory_path() / "fae_startup_benchmark_textures";
+    if (options.cooked)
+    {
+        std::filesystem::create_directories(cooked_directory);
+        for (auto& path : texture_paths)
+        {
+            auto texture = fae::texture::load(FAE_ASSET_DIR / path);
+            auto cooked_path = fae::cooked_texture_path(cooked_directory / path.filename());
+            if (!texture || !fae::write_cooked_texture(*texture, cooked_path))
+            {
+                std::println("failed to load & cook {}", path.string());
+                return fae::exit_failure;
+            }
+            path = cooked_path;
+        }
+    }
+
+    auto webgpu_plugin = fae::webgpu_plugin{};
+    webgpu_plugin.headless = true;
+    webgpu_plugin.pipeline_cache_directory = options.no_cache ? std::filesystem::path() : options.cache_directory;
+    webgpu_plugin.adapter_options.forceFallbackAdapter = options.force_fallback_adapter;
+    if (options.null_backend)
+    {
+        webgpu_plugin.adapter_options.backendType = wgpu::BackendType::Null;
+    }
+
+    auto launch = clock_type::now();
+    auto app = fae::application{};
+    app.add_plugin(webgpu_plugin);
+    auto device_ready = clock_type::now();
+    app
+        .add_plugin(fae::rendering_plugin{})
+        .add_plugin(fae::lighting_plugin{});
+    auto plugins_ready = clock_type::now();
+
+    auto start_returned = std::optional<clock_type::time_point>();
+    auto assets_loaded = std::optional<clock_type::time_point>();
+    auto pipelines_ready = std::optional<clock_type::time_point>();
+    auto first_frame = std::optional<clock_type::time_point>();
+    auto frames = 0;
+    app
+        .add_system<fae::start_step>([&](const fae::start_step& step)
+            {
+                // stands in for an application's asset loading, which pipeline compilation overlaps with
+                auto camera_entity = step.ecs_world.create_entity();
+                camera_entity
+                    .set_component<fae::transform>(fae::transform{ .position = { 0.f, 0.f, 4.f } })
+                    .set_component<fae::camera>(fae::camera{});
+                step.global_entity.set_component<fae::active_camera>(fae::active_camera{ .camera_entity = camera_entity.id });
+                auto cube = step.assets.add(fae::meshes::cube());
+                auto x = -1.5f;
+                for (const auto& path : texture_paths)
+                {
+                    auto material = fae::material{};
+                    material.diffuse = options.async_assets ? step.assets.load_async<fae::texture>(path) : step.assets.load<fae::texture>(path);
+                    step.ecs_world.create_entity()
+                        .set_component<fae::transform>(fae::transform{ .position = { x, 0.f, 0.f } })
+                        .set_component<fae::model>(fae::model{ .mesh = cube, .material = step.assets.add(material) });
+                    x += 3.f;
+                }
+                start_returned = clock_type::now();
+                if (step.assets.progress().done())
+                {
+                    assets_loaded = start_returned;
+                } })
+        .add_system<fae::post_update_step>([&](const fae::post_update_step& step)
+            {
+                ++frames;
+                if (!assets_loaded && step.assets.progress().done())
+                {
+                    assets_loaded = clock_type::now();
+                }
+                step.global_entity.use_component<fae::webgpu>([&](fae::webgpu& webgpu)
+                    {
+                        if (first_frame)
+                        {
+                            return;
+                        }
+                        if (pipelines_ready && assets_loaded)
+                        {
+                            // this frame was drawn with every pipeline
+                            fae::wait_for_submitted_work_sync(webgpu.instance, webgpu.device);
+                            first_frame = clock_type::now();
+                            step.scheduler.invoke(fae::application_quit{});
+                            return;
+                        }
+                        if (webgpu.pipelines_compiling == 0)
+                        {
+                            pipelines_ready = clock_type::now();
+                        } }); });
+    app.run();
+
+    if (options.cooked)
+    {
+        auto error = std::error_code{};
+        std::filesystem::remove_all(cooked_directory, error);
+    }
+
+    std::println("startup ({}, {} {} assets, {})", options.no_cache ? "no pipeline cache" : options.cold ? "cold pipeline cache" : "warm pipeline cache", options.async_assets ? "async" : "sync", options.cooked ? "cooked" : "source", options.null_backend ? "null backend" : options.force_fallback_adapter ? "fallback adapter" : "default adapter");
+    std::println("device ready     {:10.3f} ms", milliseconds_since(launch, device_ready));
+    std::println("plugins ready    {:10.3f} ms", milliseconds_since(launch, plugins_ready));
+    if (start_returned)
+    {
+        std::println("start returned   {:10.3f} ms", milliseconds_since(launch, *start_returned));
+    }
+    if (assets_loaded)
+    {
+        std::println("assets loaded    {:10.3f} ms", milliseconds_since(launch, *assets_loaded));
+    }
+    if (!pipelines_ready || !first_frame)
+    {
+        std::println("the pipelines or assets never became ready");
+        return fae::exit_failure;
+    }
+    std::println("pipelines ready  {:10.3f} ms", milliseconds_since(launch, *pipelines_ready));
+    std::println("first frame      {:10.3f} ms ({} frames before)", milliseconds_since(launch, *first_frame), frames - 1);
+    app.global_entity.use_component<fae::webgpu>([&](fae::webgpu& webgpu)
+        {
+            if (webgpu.pipeline_cache)
+            {
+                std::println("pipeline cache   {} hits, {} misses, {} stores in {}", webgpu.pipeline_cache->hits.load(), webgpu.pipeline_cache->misses.load(), webgpu.pipeline_cache->stores.load(), webgpu.pipeline_cache->directory.string());
+            } });
+    return fae::exit_success;
+}
@@ -0,0 +1,230 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <print>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "fae/application/application.hpp"
+#include "fae/camera.hpp"
+#include "fae/core/exit.hpp"
+#include "fae/lighting.hpp"
+#include "fae/rendering/rendering.hpp"
+#include "fae/webgpu/webgpu.hpp"
+
+/*
+draws a grid of small props sharing a few materials headless, each prop as its own draw or merged into static batches (see fae::static_model)
+reports cpu encode time, gpu time, bytes uploaded, batches merged & material binds per frame
+
+usage: static_batching [--static] [--texture-arrays] [--props n] [--materials n] [--moving n] [--frames n] [--fallback | --null]
+    --static     tag every prop with a static_model so props of the same material are drawn as one batch
+    --texture-arrays  pack the materials' textures into a texture array so switching materials rebinds nothing (see render_settings::texture_arrays)
+    --props      number of props (default 2000)
+    --materials  number of distinct materials the props are spread over (default 4)
+    --moving     number of props moved every frame, their batches are merged again each time (default 0)
+    --fallback   force dawn's cpu adapter (swiftshader)
+    --null       use dawn's null backend (nothing is rasterized, measures cpu cost only)
+*/
+
+using clock_type = std::chrono::steady_clock;
+
+struct options
+{
+    bool static_batching = false;
+    bool texture_arrays = false;
+    bool force_fallback_adapter = false;
+    bool null_backend = false;
+    int props = 2000;
+    int materials = 4;
+    int moving = 0;
+    int frames = 200;
+};
+
+struct results
+{
+    std::vector<double> cpu_encode_ms;
+    std::vector<double> gpu_ms;
+    std::vector<double> bytes_uploaded;
+    std::vector<double> merges;
+    std::vector<double> material_binds;
+    int frame = 0;
+};
+
+constexpr std::uint32_t width = 1280;
+constexpr std::uint32_t height = 720;
+
+auto prop_transform(int index, int side, int frame) noexcept -> fae::transform
+{
+    return fae::transform{
+        .position = { (index % side - side / 2) * 1.5f, (index / side - side / 2) * 1.5f, 0.f },
+        .rotation = fae::math::angleAxis(fae::math::radians(0.5f * frame), fae::vec3{ 0.f, 1.f, 0.f }),
+        .scale = { 0.5f, 0.5f, 0.5f },
+    };
+}
+
+auto percentile(std::vector<double> values, double p) -> double
+{
+    if (values.empty())
+    {
+        return 0.0;
+    }
+    std::ranges::sort(values);
+    return values[static_cast<std::size_t>(p * (values.size() - 1))];
+}
+
+auto print_timings(std::string_view name, std::string_view unit, const std::vector<double>& values) -> void
+{
+    auto total = 0.0;
+    for (auto value : values)
+    {
+        total += value;
+    }
+    std::println("{:<14} avg {:12.3f} {}  p50 {:12.3f} {}  p95 {:12.3f} {}", name, total / std::max<std::size_t>(values.size(), 1), unit, percentile(values, 0.5), unit, percentile(values, 0.95), unit);
+}
+
+auto main(int argc, char* argv[]) -> int
+{
+    auto options = ::options{};
+    for (int i = 1; i < argc; ++i)
+    {
+        auto arg = std::string_view(argv[i]);
+        if (arg == "--static")
+        {
+            options.static_batching = true;
+        }
+        else if (arg == "--texture-arrays")
+        {
+            options.texture_arrays = true;
+        }
+        else if (arg == "--fallback")
+        {
+            options.force_fallback_adapter = true;
+        }
+        else if (arg == "--null")
+        {
+            options.null_backend = true;
+        }
+        else if (arg == "--props" && i + 1 < argc)
+        {
+            options.props = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "--materials" && i + 1 < argc)
+        {
+            options.materials = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "--moving" && i + 1 < argc)
+        {
+            options.moving = std::max(0, std::atoi(argv[++i]));
+        }
+        else if (arg == "--frames" && i + 1 < argc)
+        {
+            options.frames = std::max(1, std::atoi(argv[++i]));
+        }
+    }
+    options.moving = std::min(options.moving, options.props);
+    auto side = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(options.props))));
+
+    auto webgpu_plugin = fae::webgpu_plugin{};
+    webgpu_plugin.headless = true;
+    webgpu_plugin.headless_width = width;
+    webgpu_plugin.headless_height = height;
+    webgpu_plugin.adapter_options.forceFallbackAdapter = options.force_fallback_adapter;
+    if (options.null_backend)
+    {
+        webgpu_plugin.adapter_options.backendType = wgpu::BackendType::Null;
+    }
+
+    auto results = ::results{};
+    auto moving = std::vector<fae::entity>();
+    auto app = fae::application{};
+    auto benchmark_start = clock_type::now();
+    app
+        .add_plugin(webgpu_plugin)
+        .add_plugin(fae::rendering_plugin{})
+        .add_plugin(fae::lighting_plugin{})
+        .add_system<fae::start_step>([&](const fae::start_step& step)
+            {
+                auto camera_entity = step.ecs_world.create_entity();
+                camera_entity
+                    .set_component<fae::transform>(fae::transform{ .position = { 0.f, 0.f, side * 1.5f } })
+                    .set_component<fae::camera>(fae::camera{});
+                step.global_entity.set_component<fae::active_camera>(fae::active_camera{ .camera_entity = camera_entity.id });
+                step.global_entity.set_component<fae::render_settings>(fae::render_settings{ .texture_arrays = options.texture_arrays });
+                step.ecs_world.create_entity().set_component<fae::ambient_light>(fae::ambient_light{ .color = fae::color{ 80, 80, 80 } });
+                step.ecs_world.create_entity().set_component<fae::directional_light>(fae::directional_light{
+                    .direction = fae::math::normalize(fae::vec3{ 1.f, -1.f, -1.f }),
+                });
+
+                // 1x1 textured materials added to the asset manager, props of the same color share one handle & every prop the cube's
+                auto cube = step.assets.add(fae::meshes::cube());
+                auto models = std::vector<fae::model>();
+                for (int i = 0; i < options.materials; ++i)
+                {
+                    auto diffuse = step.assets.add(fae::texture{
+                        .width = 1,
+                        .height = 1,
+                        .data = { fae::color{ static_cast<std::uint8_t>(255 * (i + 1) / options.materials), 128, 255, 255 } },
+                    });
+                    models.push_back(fae::model{ .mesh = cube, .material = step.assets.add(fae::material{ .diffuse = diffuse }) });
+                }
+                for (int i = 0; i < options.props; ++i)
+                {
+                    auto entity = step.ecs_world.create_entity();
+                    entity
+                        .set_component<fae::transform>(prop_transform(i, side, 0))
+                        .set_component<fae::model>(models[i % options.materials]);
+                    if (options.static_batching)
+                    {
+                        entity.set_component<fae::static_model>(fae::static_model{});
+                    }
+                    if (i < options.moving)
+                    {
+                        moving.push_back(entity.id);
+                    }
+                } })
+        .add_system<fae::update_step>([&](const fae::update_step& step)
+            {
+                for (std::size_t i = 0; i < moving.size(); ++i)
+                {
+                    step.ecs_world.get_entity(moving[i]).set_component<fae::transform>(prop_transform(static_cast<int>(i), side, results.frame));
+                } })
+        .add_system<fae::post_update_step>([&](const fae::post_update_step& step)
+            {
+                step.global_entity.use_component<fae::webgpu>([&](fae::webgpu& webgpu)
+                    {
+                        auto start = clock_type::now();
+                        fae::wait_for_submitted_work_sync(webgpu.instance, webgpu.device);
+                        results.gpu_ms.push_back(std::chrono::duration<double, std::milli>(clock_type::now() - start).count()); });
+                step.global_entity.use_component<const fae::render_stats>([&](const fae::render_stats& stats)
+                    {
+                        results.cpu_encode_ms.push_back(stats.cpu_encode_time.seconds_f32() * 1000.0);
+                        results.bytes_uploaded.push_back(static_cast<double>(stats.bytes_uploaded));
+                        results.material_binds.push_back(static_cast<double>(stats.material_binds)); });
+                step.global_entity.use_component<const fae::static_batches>([&](const fae::static_batches& static_batches)
+                    { results.merges.push_back(static_cast<double>(static_batches.merges)); });
+                if (++results.frame >= options.frames)
+                {
+                    step.scheduler.invoke(fae::application_quit{});
+                } });
+    app.run();
+    auto total_ms = std::chrono::duration<double, std::milli>(clock_type::now() - benchmark_start).count();
+
+    std::println("{} frames of {} props ({} moving, {} materials) at {}x{}, {} ({})", results.frame, options.props, options.moving, options.materials, width, height, options.static_batching ? "static batches" : "one draw per prop", options.null_backend ? "null backend" : options.force_fallback_adapter ? "fallback adapter" : "default adapter");
+    std::println("throughput: {:.1f} frames/s", results.frame / (total_ms / 1000.0));
+    // the first frame merges & uploads every batch, keep it out of the steady state numbers
+    if (results.cpu_encode_ms.size() > 1)
+    {
+        std::println("first frame: cpu encode {:.3f} ms, {:.0f} bytes uploaded", results.cpu_encode_ms.front(), results.bytes_uploaded.front());
+        results.cpu_encode_ms.erase(results.cpu_encode_ms.begin());
+        results.gpu_ms.erase(results.gpu_ms.begin());
+        results.bytes_uploaded.erase(results.bytes_uploaded.begin());
+    }
+    print_timings("cpu encode", "ms", results.cpu_encode_ms);
+    print_timings("gpu (wait)", "ms", results.gpu_ms);
+    print_timings("uploaded", "B ", results.bytes_uploaded);
+    print_timings("merges", "  ", results.merges);
+    print_timings("material binds", "  ", results.material_binds);
+    return fae::exit_success;
+}
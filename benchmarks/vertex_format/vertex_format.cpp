@@ -0,0 +1,275 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <numbers>
+#include <optional>
+#include <print>
+#include <string_view>
+#include <vector>
+
+#include "fae/application/application.hpp"
+#include "fae/camera.hpp"
+#include "fae/core/exit.hpp"
+#include "fae/lighting.hpp"
+#include "fae/rendering/rendering.hpp"
+#include "fae/webgpu/webgpu.hpp"
+
+/*
+compares the vertex formats (see fae::vertex_format): gpu memory per vertex & normal precision of every format, then renders
+a vertex bound scene with one of them (dense spheres in a small target, so vertex fetch & shading dominate over fragments)
+run once per format to compare throughput
+
+usage: vertex_format [--format standard|compact|compact_with_color] [--spheres n] [--segments n] [--frames n] [--fallback | --null]
+    --format     the format the scene is rendered with (default standard)
+    --spheres    number of spheres (default 64)
+    --segments   sphere tessellation, vertices per sphere are about segments^2 / 2 (default 256)
+    --fallback   force dawn's cpu adapter (swiftshader)
+    --null       use dawn's null backend (nothing is rasterized, measures cpu cost only)
+*/
+
+using clock_type = std::chrono::steady_clock;
+
+struct options
+{
+    std::optional<fae::vertex_format> format;
+    bool force_fallback_adapter = false;
+    bool null_backend = false;
+    int spheres = 64;
+    int segments = 256;
+    int frames = 100;
+};
+
+struct results
+{
+    std::vector<double> cpu_encode_ms;
+    std::vector<double> gpu_ms;
+    std::vector<double> bytes_uploaded;
+    int frame = 0;
+};
+
+constexpr std::uint32_t width = 256;
+constexpr std::uint32_t height = 256;
+
+auto to_string(fae::vertex_format format) noexcept -> std::string_view
+{
+    switch (format)
+    {
+    case fae::vertex_format::compact:
+        return "compact";
+    case fae::vertex_format::compact_with_color:
+        return "compact_with_color";
+    case fae::vertex_format::standard:
+        break;
+    }
+    return "standard";
+}
+
+auto uv_sphere(int segments) -> fae::mesh
+{
+    auto mesh = fae::mesh{};
+    auto rings = std::max(segments / 2, 2);
+    for (int ring = 0; ring <= rings; ++ring)
+    {
+        auto v = static_cast<float>(ring) / rings;
+        auto phi = v * std::numbers::pi_v<float>;
+        for (int segment = 0; segment <= segments; ++segment)
+        {
+            auto u = static_cast<float>(segment) / segments;
+            auto theta = u * 2.f * std::numbers::pi_v<float>;
+            auto normal = fae::vec3{ std::sin(phi) * std::cos(theta), std::cos(phi), std::sin(phi) * std::sin(theta) };
+            mesh.vertices.push_back(fae::vertex{
+                .position = normal * 0.5f,
+                .color = { u, v, 1.f - u, 1.f },
+                .normal = normal,
+                // tiled so the half float uvs are exercised outside [0, 1]
+                .uv = { u * 8.f, v * 4.f },
+            });
+        }
+    }
+    auto stride = static_cast<std::uint32_t>(segments + 1);
+    for (std::uint32_t ring = 0; ring < static_cast<std::uint32_t>(rings); ++ring)
+    {
+        for (std::uint32_t segment = 0; segment < static_cast<std::uint32_t>(segments); ++segment)
+        {
+            auto a = ring * stride + segment;
+            auto b = a + stride;
+            mesh.indices.insert(mesh.indices.end(), { a, a + 1, b, a + 1, b + 1, b });
+        }
+    }
+    return mesh;
+}
+
+auto percentile(std::vector<double> values, double p) -> double
+{
+    if (values.empty())
+    {
+        return 0.0;
+    }
+    std::ranges::sort(values);
+    return values[static_cast<std::size_t>(p * (values.size() - 1))];
+}
+
+auto print_timings(std::string_view name, std::string_view unit, const std::vector<double>& values) -> void
+{
+    auto total = 0.0;
+    for (auto value : values)
+    {
+        total += value;
+    }
+    std::println("{:<14} avg {:12.3f} {}  p50 {:12.3f} {}  p95 {:12.3f} {}", name, total / std::max<std::size_t>(values.size(), 1), unit, percentile(values, 0.5), unit, percentile(values, 0.95), unit);
+}
+
+/* worst case error of what the vertex shader decodes, relative to the full precision vertices */
+auto print_memory_and_precision(const fae::mesh& mesh, fae::vertex_format format) -> void
+{
+    auto start = clock_type::now();
+    auto packed = fae::pack_vertices(mesh.vertices, format);
+    auto pack_ms = std::chrono::duration<double, std::milli>(clock_type::now() - start).count();
+
+    auto max_normal_degrees = 0.0;
+    if (format != fae::vertex_format::standard)
+    {
+        for (std::size_t i = 0; i < mesh.vertices.size(); ++i)
+        {
+            auto compact = fae::compact_vertex{};
+            std::memcpy(&compact, packed.data() + i * fae::vertex_stride(format), sizeof(compact));
+            auto decoded = fae::octahedral_decode(compact.normal);
+            auto cosine = std::clamp(static_cast<double>(fae::math::dot(decoded, fae::math::normalize(mesh.vertices[i].normal))), -1.0, 1.0);
+            max_normal_degrees = std::max(max_normal_degrees, std::acos(cosine) * 180.0 / std::numbers::pi);
+        }
+    }
+    std::println("{:<20} {:3} bytes/vertex  {:10} bytes  pack {:8.3f} ms  max normal error {:.4f} deg",
+        to_string(format), fae::vertex_stride(format), packed.size(), pack_ms, max_normal_degrees);
+}
+
+auto render(const options& options, const fae::mesh& sphere, fae::vertex_format format) -> void
+{
+    auto webgpu_plugin = fae::webgpu_plugin{};
+    webgpu_plugin.headless = true;
+    webgpu_plugin.headless_width = width;
+    webgpu_plugin.headless_height = height;
+    webgpu_plugin.adapter_options.forceFallbackAdapter = options.force_fallback_adapter;
+    if (options.null_backend)
+    {
+        webgpu_plugin.adapter_options.backendType = wgpu::BackendType::Null;
+    }
+
+    auto results = ::results{};
+    auto app = fae::application{};
+    auto benchmark_start = clock_type::now();
+    app
+        .add_plugin(webgpu_plugin)
+        .add_plugin(fae::rendering_plugin{})
+        .add_plugin(fae::lighting_plugin{})
+        .add_system<fae::start_step>([&](const fae::start_step& step)
+            {
+                auto camera_entity = step.ecs_world.create_entity();
+                camera_entity
+                    .set_component<fae::transform>(fae::transform{ .position = { 0.f, 0.f, 12.f } })
+                    .set_component<fae::camera>(fae::camera{});
+                step.global_entity.set_component<fae::active_camera>(fae::active_camera{ .camera_entity = camera_entity.id });
+                step.ecs_world.create_entity().set_component<fae::ambient_light>(fae::ambient_light{ .color = fae::color{ 80, 80, 80 } });
+                step.ecs_world.create_entity().set_component<fae::directional_light>(fae::directional_light{
+                    .direction = fae::math::normalize(fae::vec3{ 1.f, -1.f, -1.f }),
+                });
+
+                auto mesh = sphere;
+                mesh.format = format;
+                auto model = fae::model{ .mesh = step.assets.add(std::move(mesh)) };
+                auto side = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(options.spheres))));
+                for (int i = 0; i < options.spheres; ++i)
+                {
+                    step.ecs_world.create_entity()
+                        .set_component<fae::transform>(fae::transform{ .position = { (i % side - side / 2) * 1.2f, (i / side - side / 2) * 1.2f, 0.f } })
+                        .set_component<fae::model>(model);
+                } })
+        .add_system<fae::post_update_step>([&](const fae::post_update_step& step)
+            {
+                step.global_entity.use_component<fae::webgpu>([&](fae::webgpu& webgpu)
+                    {
+                        auto start = clock_type::now();
+                        fae::wait_for_submitted_work_sync(webgpu.instance, webgpu.device);
+                        results.gpu_ms.push_back(std::chrono::duration<double, std::milli>(clock_type::now() - start).count()); });
+                step.global_entity.use_component<const fae::render_stats>([&](const fae::render_stats& stats)
+                    {
+                        results.cpu_encode_ms.push_back(stats.cpu_encode_time.seconds_f32() * 1000.0);
+                        results.bytes_uploaded.push_back(static_cast<double>(stats.bytes_uploaded)); });
+                // pipelines compile asynchronously, only count frames drawn with all of them
+                step.global_entity.use_component<fae::webgpu>([&](fae::webgpu& webgpu)
+                    {
+                        if (webgpu.pipelines_compiling > 0)
+                        {
+                            results.cpu_encode_ms.clear();
+                            results.gpu_ms.clear();
+                            results.bytes_uploaded.clear();
+                        } });
+                if (++results.frame >= options.frames)
+                {
+                    step.scheduler.invoke(fae::application_quit{});
+                } });
+    app.run();
+    auto total_ms = std::chrono::duration<double, std::milli>(clock_type::now() - benchmark_start).count();
+
+    std::println("");
+    std::println("{}: {} frames of {} spheres ({} vertices, {} triangles each) at {}x{} ({})", to_string(format), results.frame, options.spheres, sphere.vertices.size(), sphere.indices.size() / 3, width, height, options.null_backend ? "null backend" : options.force_fallback_adapter ? "fallback adapter" : "default adapter");
+    std::println("throughput: {:.1f} frames/s", results.frame / (total_ms / 1000.0));
+    print_timings("cpu encode", "ms", results.cpu_encode_ms);
+    print_timings("gpu (wait)", "ms", results.gpu_ms);
+    print_timings("uploaded", "B ", results.bytes_uploaded);
+}
+
+auto main(int argc, char* argv[]) -> int
+{
+    auto options = ::options{};
+    for (int i = 1; i < argc; ++i)
+    {
+        auto arg = std::string_view(argv[i]);
+        if (arg == "--format" && i + 1 < argc)
+        {
+            auto name = std::string_view(argv[++i]);
+            for (std::size_t format = 0; format < fae::vertex_format_count; ++format)
+            {
+                if (to_string(static_cast<fae::vertex_format>(format)) == name)
+                {
+                    options.format = static_cast<fae::vertex_format>(format);
+                }
+            }
+            if (!options.format)
+            {
+                std::println("unknown vertex format {}", name);
+                return fae::exit_failure;
+            }
+        }
+        else if (arg == "--fallback")
+        {
+            options.force_fallback_adapter = true;
+        }
+        else if (arg == "--null")
+        {
+            options.null_backend = true;
+        }
+        else if (arg == "--spheres" && i + 1 < argc)
+        {
+            options.spheres = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "--segments" && i + 1 < argc)
+        {
+            options.segments = std::max(4, std::atoi(argv[++i]));
+        }
+        else if (arg == "--frames" && i + 1 < argc)
+        {
+            options.frames = std::max(1, std::atoi(argv[++i]));
+        }
+    }
+
+    auto sphere = uv_sphere(options.segments);
+    std::println("sphere: {} vertices", sphere.vertices.size());
+    for (std::size_t format = 0; format < fae::vertex_format_count; ++format)
+    {
+        print_memory_and_precision(sphere, static_cast<fae::vertex_format>(format));
+    }
+    render(options, sphere, options.format.value_or(fae::vertex_format::standard));
+    return fae::exit_success;
+}
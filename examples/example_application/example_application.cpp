@@ -47,10 +47,10 @@ auto start(const fae::start_step& step) noexcept -> void
             .scale = fae::vec3(100.f, 0.5f, 100.f),
         })
         .set_component<fae::model>(fae::model{
-            .mesh = fae::meshes::cube(),
-            .material = fae::material{
-                .diffuse = *step.assets.load<fae::texture>("rock.png"),
-            },
+            .mesh = step.assets.add(fae::meshes::cube()),
+            .material = step.assets.add(fae::material{
+                .diffuse = step.assets.load_async<fae::texture>("cobblestone.jpg"),
+            }),
         });
 
     step.ecs_world.create_entity()
@@ -61,10 +61,10 @@ auto start(const fae::start_step& step) noexcept -> void
             .scale = fae::vec3{ 1.f, 1.f, 1.f },
         })
         .set_component<fae::model>(fae::model{
-            .mesh = *step.assets.load<fae::mesh>("cube.obj"),
-            .material = fae::material{
-                .diffuse = *step.assets.load<fae::texture>("wood.png"),
-            },
+            .mesh = step.assets.load<fae::mesh>("cube.obj"),
+            .material = step.assets.add(fae::material{
+                .diffuse = step.assets.load_async<fae::texture>("checkerboard.png"),
+            }),
         })
         .set_component<rotate>(rotate{ .speed = 60.f });
 
@@ -76,7 +76,7 @@ auto start(const fae::start_step& step) noexcept -> void
     //         .scale = fae::vec3{ 1.f, 1.f, 1.f } * 0.03f,
     //     })
     //     .set_component<fae::model>(fae::model{
-    //         .mesh = *step.assets.load<fae::mesh>("Stanford_Bunny.stl"),
+    //         .mesh = step.assets.load<fae::mesh>("Stanford_Bunny.stl"),
     //     });
 }
 
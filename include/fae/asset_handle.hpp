@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+namespace fae
+{
+    /* identifies one loaded asset for as long as it stays loaded (0 is never issued) */
+    using asset_id = std::uint64_t;
+
+    /*
+    typed reference to an asset owned by the asset_manager
+    a default constructed handle is null and refers to no asset
+    */
+    template <typename t_asset>
+    struct asset_handle
+    {
+        asset_id id = 0;
+
+        [[nodiscard]] inline constexpr auto valid() const noexcept -> bool
+        {
+            return id != 0;
+        }
+
+        [[nodiscard]] inline constexpr auto operator==(const asset_handle& rhs) const noexcept -> bool = default;
+    };
+}
+
+template <typename t_asset>
+struct std::hash<fae::asset_handle<t_asset>>
+{
+    auto operator()(const fae::asset_handle<t_asset>& handle) const noexcept -> std::size_t
+    {
+        return std::hash<fae::asset_id>{}(handle.id);
+    }
+};
@@ -1,13 +1,27 @@
 #pragma once
 
 #include <any>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <typeindex>
 #include <unordered_map>
+#include <unordered_set>
 #include <concepts>
 #include <filesystem>
+#include <format>
+#include <functional>
+#include <utility>
+#include <vector>
 
+#include "fae/asset_handle.hpp"
+#include "fae/event.hpp"
+#include "fae/logging.hpp"
+#include "fae/thread_pool.hpp"
 #include "fae/core/optional_reference.hpp"
+#include "fae/core/slot_map.hpp"
 
 namespace fae
 {
@@ -16,27 +30,279 @@ namespace fae
         { t_asset::load(path) } -> std::same_as<std::optional<t_asset>>;
     };
 
+    enum struct asset_load_state
+    {
+        loading,
+        ready,
+        /* also what released & never issued handles report */
+        failed,
+    };
+
+    /* async loads requested since nothing was loading, e.g. for a loading screen */
+    struct asset_load_progress
+    {
+        std::size_t requested = 0;
+        /* failed ones included */
+        std::size_t finished = 0;
+        std::size_t failed = 0;
+
+        [[nodiscard]] inline constexpr auto fraction() const noexcept -> float
+        {
+            return requested == 0 ? 1.f : static_cast<float>(finished) / static_cast<float>(requested);
+        }
+
+        [[nodiscard]] inline constexpr auto done() const noexcept -> bool
+        {
+            return finished == requested;
+        }
+    };
+
+    /*
+    owns every asset, each type in a slot map of its own (stored densely) & reached through asset_handles
+    components keep handles instead of copies, one texture or mesh in memory serves every entity using it
+    assets are reference counted: load, load_async, add & retain add a reference, release drops one & the asset is unloaded with the last
+    references from get are invalidated when an asset of the same type is added or unloaded, keep the handle instead
+    */
     struct asset_manager
     {
+        /*
+        invoked with the id of an asset right before it is unloaded or replaced by a reload
+        so that anything derived from it (e.g. gpu resources) can be released deterministically
+        */
+        event<asset_id> on_asset_released{};
+        /* invoked on the main thread (see update) with the id of an asset load_async finished loading or failed to */
+        event<asset_id> on_asset_loaded{};
+        event<asset_id> on_asset_load_failed{};
+
+        /* threads async loads are read & decoded on, read when the first one starts */
+        std::size_t loader_thread_count = thread_pool::default_thread_count();
+
+        /* loads the asset at path unless it already is & adds a reference to it, null when loading failed. finishes an async load of path right away */
         template <asset t_asset>
-        [[nodiscard]] auto load(const std::filesystem::path& path) noexcept
-            -> optional_reference<t_asset>
+        [[nodiscard]] auto load(const std::filesystem::path& path) noexcept -> asset_handle<t_asset>
         {
             auto resolved_path = resolve_path(path);
-            if (m_assets.find(resolved_path) != m_assets.end())
+            auto& slots = storage<t_asset>();
+            auto known = m_paths.find(resolved_path);
+            if (known != m_paths.end() && slots.contains(known->second.id))
             {
-                return optional_reference<t_asset>(std::any_cast<t_asset&>(m_assets.at(resolved_path)));
+                slots.retain(known->second.id);
+                return asset_handle<t_asset>{ .id = known->second.id };
+            }
+            if (known != m_paths.end() && !slots.reserved(known->second.id))
+            {
+                fae::log_error(std::format("{} is already loaded as another type of asset", resolved_path.string()));
+                return {};
             }
 
             auto maybe_asset = t_asset::load(resolved_path);
-            if (maybe_asset)
+            if (!maybe_asset)
+            {
+                return {};
+            }
+            // an async load of the same path is superseded, its handle becomes ready now & its result is dropped
+            auto pending = known != m_paths.end();
+            auto id = pending ? known->second.id : slots.reserve(next_generation());
+            if (pending)
+            {
+                slots.retain(id);
+            }
+            else
+            {
+                m_paths.insert({ resolved_path, loaded_path{ .id = id, .erase = &erase_asset<t_asset> } });
+                m_id_paths.insert({ id, resolved_path });
+            }
+            set_handle(*maybe_asset, id);
+            slots.emplace(id, std::move(*maybe_asset));
+            if (pending && m_pending.erase(id) != 0)
+            {
+                m_progress.finished++;
+                on_asset_loaded.invoke(id);
+            }
+            return asset_handle<t_asset>{ .id = id };
+        }
+
+        /*
+        starts loading the asset at path on the loader threads & returns its handle (with a reference) right away, loading until update moves the asset in
+        paths already loaded or loading return their handle. on the web the asset is loaded before this returns
+        t_asset::load must be safe to call from several threads at once
+        */
+        template <asset t_asset>
+        [[nodiscard]] auto load_async(const std::filesystem::path& path) -> asset_handle<t_asset>
+        {
+            auto resolved_path = resolve_path(path);
+            auto& slots = storage<t_asset>();
+            if (auto known = m_paths.find(resolved_path); known != m_paths.end())
             {
-                auto asset = *maybe_asset;
-                m_assets.insert_or_assign(resolved_path, std::any(std::forward<t_asset&&>(asset)));
-                return optional_reference<t_asset>(std::any_cast<t_asset&>(m_assets.at(resolved_path)));
+                if (!slots.retain(known->second.id))
+                {
+                    fae::log_error(std::format("{} is already loaded as another type of asset", resolved_path.string()));
+                    return {};
+                }
+                return asset_handle<t_asset>{ .id = known->second.id };
             }
 
-            return std::nullopt;
+            if (m_pending.empty())
+            {
+                m_progress = {};
+            }
+            m_progress.requested++;
+            auto id = slots.reserve(next_generation());
+            m_paths.insert({ resolved_path, loaded_path{ .id = id, .erase = &erase_asset<t_asset> } });
+            m_id_paths.insert({ id, resolved_path });
+            m_pending.insert(id);
+            if (!m_loader)
+            {
+                m_loader = std::make_unique<thread_pool>(loader_thread_count);
+            }
+            m_loader->submit([completed = m_completed, resolved_path, id]()
+                {
+                    auto complete = std::function<bool(asset_manager&)>([id](asset_manager& assets)
+                        {
+                            assets.storage<t_asset>().erase(id);
+                            return false; });
+                    if (auto maybe_asset = t_asset::load(resolved_path))
+                    {
+                        set_handle(*maybe_asset, id);
+                        complete = [id, asset = std::move(*maybe_asset)](asset_manager& assets) mutable
+                        { return assets.storage<t_asset>().emplace(id, std::move(asset)) != nullptr; };
+                    }
+                    auto lock = std::scoped_lock(completed->mutex);
+                    completed->loads.push_back(completed_load{ .id = id, .complete = std::move(complete) }); });
+            return asset_handle<t_asset>{ .id = id };
+        }
+
+        /* moves the assets async loads finished in & invokes on_asset_loaded or on_asset_load_failed for each, the application calls it at the start of every step */
+        auto update() -> void
+        {
+            auto completed = std::vector<completed_load>();
+            {
+                auto lock = std::scoped_lock(m_completed->mutex);
+                std::swap(completed, m_completed->loads);
+            }
+            for (auto& load : completed)
+            {
+                // released or loaded synchronously while it was loading
+                if (m_pending.erase(load.id) == 0)
+                {
+                    continue;
+                }
+                m_progress.finished++;
+                if (load.complete(*this))
+                {
+                    on_asset_loaded.invoke(load.id);
+                    continue;
+                }
+                m_progress.failed++;
+                if (auto path = m_id_paths.find(load.id); path != m_id_paths.end())
+                {
+                    fae::log_error(std::format("failed to load asset {}", path->second.string()));
+                    m_paths.erase(path->second);
+                    m_id_paths.erase(path);
+                }
+                on_asset_load_failed.invoke(load.id);
+            }
+        }
+
+        /* takes ownership of an asset that has no file (e.g. a material), an asset comparing equal to one stored before gets that one's handle instead */
+        template <typename t_asset>
+        [[nodiscard]] auto add(t_asset asset) noexcept -> asset_handle<t_asset>
+        {
+            auto& slots = storage<t_asset>();
+            if constexpr (std::equality_comparable<t_asset>)
+            {
+                if (auto existing = slots.find_if([&](const t_asset& stored)
+                        { return stored == asset; }))
+                {
+                    slots.retain(existing);
+                    return asset_handle<t_asset>{ .id = existing };
+                }
+            }
+            auto id = slots.reserve(next_generation());
+            set_handle(asset, id);
+            slots.emplace(id, std::move(asset));
+            return asset_handle<t_asset>{ .id = id };
+        }
+
+        /* the asset, null while it is loading & once it was unloaded */
+        template <typename t_asset>
+        [[nodiscard]] auto get(asset_handle<t_asset> handle) noexcept -> optional_reference<t_asset>
+        {
+            auto* asset = storage<t_asset>().get(handle.id);
+            if (!asset)
+            {
+                return std::nullopt;
+            }
+            return optional_reference<t_asset>(*asset);
+        }
+
+        template <typename t_asset>
+        [[nodiscard]] auto state(asset_handle<t_asset> handle) const noexcept -> asset_load_state
+        {
+            const auto* slots = find_storage<t_asset>();
+            if (slots && slots->contains(handle.id))
+            {
+                return asset_load_state::ready;
+            }
+            return slots && slots->reserved(handle.id) ? asset_load_state::loading : asset_load_state::failed;
+        }
+
+        [[nodiscard]] auto progress() const noexcept -> asset_load_progress
+        {
+            return m_progress;
+        }
+
+        /* adds a reference to handle's asset, e.g. when storing a copy of the handle that is released separately. false once unloaded */
+        template <typename t_asset>
+        auto retain(asset_handle<t_asset> handle) noexcept -> bool
+        {
+            return storage<t_asset>().retain(handle.id);
+        }
+
+        /* drops a reference to handle's asset, the last one unloads it (cancelling its load if still loading) */
+        template <typename t_asset>
+        auto release(asset_handle<t_asset> handle) noexcept -> void
+        {
+            if (storage<t_asset>().ref_count(handle.id) == 1)
+            {
+                erase_asset<t_asset>(*this, handle.id);
+                return;
+            }
+            storage<t_asset>().release(handle.id);
+        }
+
+        template <typename t_asset>
+        [[nodiscard]] auto ref_count(asset_handle<t_asset> handle) const noexcept -> std::uint32_t
+        {
+            const auto* slots = find_storage<t_asset>();
+            return slots ? slots->ref_count(handle.id) : 0;
+        }
+
+        /* unloads handle's asset whatever its references. returns whether anything was removed */
+        template <typename t_asset>
+        auto remove(asset_handle<t_asset> handle) noexcept -> bool
+        {
+            return erase_asset<t_asset>(*this, handle.id);
+        }
+
+        /* unloads the asset at path (if loaded) whatever its references, or cancels its async load. returns whether anything was unloaded */
+        auto unload(const std::filesystem::path& path) noexcept -> bool
+        {
+            auto it = m_paths.find(resolve_path(path));
+            if (it == m_paths.end())
+            {
+                return false;
+            }
+            auto loaded = it->second;
+            return loaded.erase(*this, loaded.id);
+        }
+
+        /* unloads & loads the asset at path again, the reloaded asset is issued a new id (with one reference) */
+        template <asset t_asset>
+        [[nodiscard]] auto reload(const std::filesystem::path& path) noexcept -> asset_handle<t_asset>
+        {
+            unload(path);
+            return load<t_asset>(path);
         }
 
         [[nodiscard]] auto resolve_path(const std::filesystem::path& path) const noexcept
@@ -46,6 +312,96 @@ namespace fae
         }
 
       private:
-        std::unordered_map<std::filesystem::path, std::any> m_assets{};
+        struct loaded_path
+        {
+            asset_id id;
+            /* erase_asset of the asset's type */
+            auto (*erase)(asset_manager&, asset_id) -> bool;
+        };
+
+        template <typename t_asset>
+        [[nodiscard]] auto storage() -> slot_map<t_asset>&
+        {
+            auto it = m_storages.find(std::type_index(typeid(t_asset)));
+            if (it == m_storages.end())
+            {
+                it = m_storages.insert({ std::type_index(typeid(t_asset)), std::any(slot_map<t_asset>{}) }).first;
+            }
+            return std::any_cast<slot_map<t_asset>&>(it->second);
+        }
+
+        template <typename t_asset>
+        [[nodiscard]] auto find_storage() const noexcept -> const slot_map<t_asset>*
+        {
+            auto it = m_storages.find(std::type_index(typeid(t_asset)));
+            return it == m_storages.end() ? nullptr : std::any_cast<slot_map<t_asset>>(&it->second);
+        }
+
+        /* assets that know their own handle (e.g. texture, which keys its gpu copy with it) are told */
+        template <typename t_asset>
+        static auto set_handle(t_asset& asset, asset_id id) noexcept -> void
+        {
+            if constexpr (requires { asset.handle = asset_handle<t_asset>{}; })
+            {
+                asset.handle = asset_handle<t_asset>{ .id = id };
+            }
+        }
+
+        template <typename t_asset>
+        static auto erase_asset(asset_manager& assets, asset_id id) -> bool
+        {
+            auto& slots = assets.storage<t_asset>();
+            if (!slots.reserved(id))
+            {
+                return false;
+            }
+            // listeners may still read the asset
+            if (slots.contains(id))
+            {
+                assets.on_asset_released.invoke(id);
+            }
+            if (assets.m_pending.erase(id) != 0)
+            {
+                assets.m_progress.finished++;
+            }
+            if (auto path = assets.m_id_paths.find(id); path != assets.m_id_paths.end())
+            {
+                assets.m_paths.erase(path->second);
+                assets.m_id_paths.erase(path);
+            }
+            return slots.erase(id);
+        }
+
+        /* the high half of the next id, never reused so ids stay unique across types & reloads (0 is never issued) */
+        [[nodiscard]] auto next_generation() noexcept -> std::uint32_t
+        {
+            return m_next_generation++;
+        }
+
+        /* a slot_map<t_asset> per asset type */
+        std::unordered_map<std::type_index, std::any> m_storages{};
+        /* assets loaded from a file, both ways */
+        std::unordered_map<std::filesystem::path, loaded_path> m_paths{};
+        std::unordered_map<asset_id, std::filesystem::path> m_id_paths{};
+        std::uint32_t m_next_generation = 1;
+
+        /* an async load's result, complete moves the asset into its slot (or frees the slot when it failed) & returns whether it loaded */
+        struct completed_load
+        {
+            asset_id id;
+            std::function<bool(asset_manager&)> complete;
+        };
+        /* shared with the loader threads' tasks */
+        struct completed_loads
+        {
+            std::mutex mutex;
+            std::vector<completed_load> loads;
+        };
+        std::shared_ptr<completed_loads> m_completed = std::make_shared<completed_loads>();
+        /* async loads update hasn't moved in yet */
+        std::unordered_set<asset_id> m_pending{};
+        asset_load_progress m_progress{};
+        /* created with the first async load, destroyed first so running loads finish before the rest goes away */
+        std::unique_ptr<thread_pool> m_loader{};
     };
 }
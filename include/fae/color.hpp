@@ -39,6 +39,8 @@ namespace fae
         {
             return { r / 255.f, g / 255.f, b / 255.f, a / 255.f };
         }
+
+        [[nodiscard]] inline constexpr auto operator==(const color_rgba& rhs) const noexcept -> bool = default;
     };
     using color = color_rgba;
 
@@ -10,4 +10,5 @@
 #include "match.hpp"
 #include "offset_of.hpp"
 #include "optional_reference.hpp"
+#include "slot_map.hpp"
 #include "vector.hpp"
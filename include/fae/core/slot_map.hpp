@@ -0,0 +1,209 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace fae
+{
+    /*
+    values stored densely (iterating them touches no holes) & reached in O(1) through ids that stay valid until the value is erased
+    an id is a slot index (low 32 bits) & the generation the slot was handed out with (high 32 bits), so ids of erased values never match a later value
+    generations are given by the caller, drawing them from one counter makes ids unique across several slot maps
+    slots are reference counted, starting at 1. pointers to values are invalidated by emplacing or erasing
+    */
+    template <typename t_value>
+    struct slot_map
+    {
+        using id_type = std::uint64_t;
+
+        /* a slot whose value is emplaced later, reserved but not contained until then. generation must not be 0 */
+        [[nodiscard]] auto reserve(std::uint32_t generation) -> id_type
+        {
+            auto index = static_cast<std::uint32_t>(m_slots.size());
+            if (!m_free_slots.empty())
+            {
+                index = m_free_slots.back();
+                m_free_slots.pop_back();
+            }
+            else
+            {
+                m_slots.emplace_back();
+            }
+            m_slots[index] = slot{ .generation = generation, .ref_count = 1 };
+            return (static_cast<id_type>(generation) << 32) | index;
+        }
+
+        /* fills a reserved slot (replacing its value if it has one), null when id was erased */
+        auto emplace(id_type id, t_value value) -> t_value*
+        {
+            auto* slot = find_slot(id);
+            if (!slot)
+            {
+                return nullptr;
+            }
+            if (slot->value_index != no_value)
+            {
+                m_values[slot->value_index] = std::move(value);
+                return &m_values[slot->value_index];
+            }
+            slot->value_index = static_cast<std::uint32_t>(m_values.size());
+            m_values.push_back(std::move(value));
+            m_value_slots.push_back(index_of(id));
+            return &m_values.back();
+        }
+
+        [[nodiscard]] auto insert(t_value value, std::uint32_t generation) -> id_type
+        {
+            auto id = reserve(generation);
+            emplace(id, std::move(value));
+            return id;
+        }
+
+        [[nodiscard]] auto get(id_type id) noexcept -> t_value*
+        {
+            auto* slot = find_slot(id);
+            return slot && slot->value_index != no_value ? &m_values[slot->value_index] : nullptr;
+        }
+
+        [[nodiscard]] auto get(id_type id) const noexcept -> const t_value*
+        {
+            return const_cast<slot_map*>(this)->get(id);
+        }
+
+        [[nodiscard]] auto contains(id_type id) const noexcept -> bool
+        {
+            return get(id) != nullptr;
+        }
+
+        [[nodiscard]] auto reserved(id_type id) const noexcept -> bool
+        {
+            return const_cast<slot_map*>(this)->find_slot(id) != nullptr;
+        }
+
+        /* adds a reference, false when id was erased */
+        auto retain(id_type id) noexcept -> bool
+        {
+            auto* slot = find_slot(id);
+            if (!slot)
+            {
+                return false;
+            }
+            slot->ref_count++;
+            return true;
+        }
+
+        /* drops a reference & erases the slot once none are left. returns the references left */
+        auto release(id_type id) -> std::uint32_t
+        {
+            auto* slot = find_slot(id);
+            if (!slot)
+            {
+                return 0;
+            }
+            if (--slot->ref_count == 0)
+            {
+                erase(id);
+                return 0;
+            }
+            return slot->ref_count;
+        }
+
+        [[nodiscard]] auto ref_count(id_type id) const noexcept -> std::uint32_t
+        {
+            const auto* slot = const_cast<slot_map*>(this)->find_slot(id);
+            return slot ? slot->ref_count : 0;
+        }
+
+        /* erases the slot whatever its reference count, the last value moves into the erased one's place */
+        auto erase(id_type id) -> bool
+        {
+            auto* slot = find_slot(id);
+            if (!slot)
+            {
+                return false;
+            }
+            if (slot->value_index != no_value)
+            {
+                auto last = static_cast<std::uint32_t>(m_values.size() - 1);
+                if (slot->value_index != last)
+                {
+                    m_values[slot->value_index] = std::move(m_values[last]);
+                    m_value_slots[slot->value_index] = m_value_slots[last];
+                    m_slots[m_value_slots[last]].value_index = slot->value_index;
+                }
+                m_values.pop_back();
+                m_value_slots.pop_back();
+            }
+            *slot = {};
+            m_free_slots.push_back(index_of(id));
+            return true;
+        }
+
+        [[nodiscard]] auto size() const noexcept -> std::size_t
+        {
+            return m_values.size();
+        }
+
+        /* the id of the first contained value predicate accepts, 0 when none does */
+        template <typename t_predicate>
+        [[nodiscard]] auto find_if(t_predicate&& predicate) const -> id_type
+        {
+            for (std::size_t i = 0; i < m_values.size(); ++i)
+            {
+                if (predicate(m_values[i]))
+                {
+                    auto index = m_value_slots[i];
+                    return (static_cast<id_type>(m_slots[index].generation) << 32) | index;
+                }
+            }
+            return 0;
+        }
+
+        /* every contained value, in no particular order */
+        [[nodiscard]] auto values() noexcept -> std::span<t_value>
+        {
+            return m_values;
+        }
+
+        [[nodiscard]] auto values() const noexcept -> std::span<const t_value>
+        {
+            return m_values;
+        }
+
+      private:
+        static constexpr std::uint32_t no_value = std::numeric_limits<std::uint32_t>::max();
+
+        struct slot
+        {
+            /* 0 while free */
+            std::uint32_t generation = 0;
+            std::uint32_t ref_count = 0;
+            std::uint32_t value_index = no_value;
+        };
+
+        [[nodiscard]] static constexpr auto index_of(id_type id) noexcept -> std::uint32_t
+        {
+            return static_cast<std::uint32_t>(id);
+        }
+
+        [[nodiscard]] auto find_slot(id_type id) noexcept -> slot*
+        {
+            auto index = index_of(id);
+            auto generation = static_cast<std::uint32_t>(id >> 32);
+            if (index >= m_slots.size() || generation == 0 || m_slots[index].generation != generation)
+            {
+                return nullptr;
+            }
+            return &m_slots[index];
+        }
+
+        std::vector<t_value> m_values;
+        /* the slot of each value, to fix up the slot of the value moved by erase */
+        std::vector<std::uint32_t> m_value_slots;
+        std::vector<slot> m_slots;
+        std::vector<std::uint32_t> m_free_slots;
+    };
+}
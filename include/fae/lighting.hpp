@@ -66,6 +66,15 @@ namespace fae
     };
     static_assert(sizeof(directional_light_info) % 16 == 0, "uniform buffer must be aligned on 16 bytes");
 
+    /*
+    bumped by update_lighting whenever the contents of ambient_light_info or directional_light_info change
+    (renderers compare it against the version they last uploaded to skip redundant buffer writes)
+    */
+    struct lighting_version
+    {
+        std::uint64_t value = 0;
+    };
+
     struct lighting_plugin
     {
         auto init(application& app) const noexcept -> void;
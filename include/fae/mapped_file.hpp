@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace fae
+{
+    /*
+    a read only view of a whole file, memory mapped so nothing is read until touched & the os can page it in & out
+    on the web (no mmap) the file is read into memory instead
+    */
+    struct mapped_file
+    {
+        mapped_file() noexcept = default;
+        mapped_file(const mapped_file&) = delete;
+        auto operator=(const mapped_file&) -> mapped_file& = delete;
+        mapped_file(mapped_file&& other) noexcept;
+        auto operator=(mapped_file&& other) noexcept -> mapped_file&;
+        ~mapped_file();
+
+        /* nullopt when the file can't be opened or mapped */
+        [[nodiscard]] static auto open(const std::filesystem::path& path) noexcept -> std::optional<mapped_file>;
+
+        [[nodiscard]] auto bytes() const noexcept -> std::span<const std::uint8_t>;
+
+      private:
+        auto close() noexcept -> void;
+
+        const std::uint8_t* m_data = nullptr;
+        std::size_t m_size = 0;
+        /* where the bytes are when the file was read instead of mapped */
+        std::vector<std::uint8_t> m_read{};
+#ifdef FAE_PLATFORM_WINDOWS
+        void* m_file = nullptr;
+        void* m_mapping = nullptr;
+#endif
+    };
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "fae/rendering/mip_chain.hpp"
+
+namespace fae
+{
+    /* block compressed payloads that can be uploaded as is (all of them use 4x4 texel blocks) */
+    enum struct texture_compression
+    {
+        bc1,
+        bc2,
+        bc3,
+        bc4,
+        bc5,
+        bc7,
+        etc2_rgb8,
+        etc2_rgb8a1,
+        etc2_rgba8,
+        astc_4x4,
+    };
+
+    [[nodiscard]] auto block_size_in_bytes(texture_compression compression) noexcept -> std::size_t;
+    [[nodiscard]] auto compressed_level_size_in_bytes(texture_compression compression, std::size_t width, std::size_t height) noexcept -> std::size_t;
+    /* whether decompress_level can turn the format into rgba8 (for devices that can't sample it) */
+    [[nodiscard]] auto has_cpu_decoder(texture_compression compression) noexcept -> bool;
+
+    /* precompressed mip levels as stored in a ktx2 or dds file, level 0 first */
+    struct compressed_texture
+    {
+        texture_compression compression;
+        bool srgb = false;
+        std::vector<std::uint8_t> data{};
+        /* offsets are into data, like mip_chain's */
+        std::vector<mip_level> levels{};
+
+        [[nodiscard]] auto level_data(std::size_t level) const noexcept -> std::span<const std::uint8_t>;
+
+        /* parses a ktx2 (without supercompression) or dds file, picked by extension */
+        [[nodiscard]] static auto load(const std::filesystem::path& path) -> std::optional<compressed_texture>;
+        [[nodiscard]] static auto parse_ktx2(std::span<const std::uint8_t> file) -> std::optional<compressed_texture>;
+        [[nodiscard]] static auto parse_dds(std::span<const std::uint8_t> file) -> std::optional<compressed_texture>;
+    };
+
+    [[nodiscard]] auto is_compressed_texture_path(const std::filesystem::path& path) noexcept -> bool;
+
+    /*
+    decodes one level into tightly packed rgba8 (bc1 to bc5 only, see has_cpu_decoder)
+    bc4 & bc5 decode to (r, 0, 0, 255) & (r, g, 0, 255), matching what sampling them on the gpu returns
+    */
+    [[nodiscard]] auto decompress_level(const compressed_texture& texture, std::size_t level) -> std::optional<std::vector<std::uint8_t>>;
+    /* decodes every level, returns nullopt if the format has no cpu decoder */
+    [[nodiscard]] auto decompress(const compressed_texture& texture) -> std::optional<mip_chain>;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "fae/math.hpp"
+#include "fae/rendering/mesh.hpp"
+
+namespace fae
+{
+    /*
+    meshes cooked ahead of time (see the asset_cooker tool) into a binary file that loads without parsing:
+    a header, then the vertex, index & meshlet blobs exactly as they are in memory, each at an aligned offset
+    files are little endian & tied to the vertex & meshlet layout, a version or size mismatch is rejected instead of misread
+    */
+    inline constexpr auto cooked_mesh_extension = ".fmesh";
+
+    struct cooked_mesh_header
+    {
+        static constexpr std::uint32_t expected_magic = 0x48534d46; // "FMSH"
+        static constexpr std::uint32_t current_version = 1;
+        /* blobs start at multiples of it, so they can be read in place (e.g. uploaded straight from a mapped file) */
+        static constexpr std::uint64_t blob_alignment = 16;
+
+        std::uint32_t magic = expected_magic;
+        std::uint32_t version = current_version;
+        std::uint32_t vertex_size = sizeof(vertex);
+        std::uint32_t meshlet_size = sizeof(meshlet);
+        std::uint32_t format = 0;
+        std::uint32_t vertex_count = 0;
+        std::uint32_t index_count = 0;
+        std::uint32_t meshlet_count = 0;
+        /* axis aligned bounds of the vertices' positions */
+        float bounds_min[3] = {};
+        float bounds_max[3] = {};
+        /* from the start of the file */
+        std::uint64_t vertices_offset = 0;
+        std::uint64_t indices_offset = 0;
+        std::uint64_t meshlets_offset = 0;
+    };
+
+    /* a cooked mesh's blobs, pointing into the bytes it was parsed from */
+    struct cooked_mesh_view
+    {
+        cooked_mesh_header header;
+        std::span<const vertex> vertices;
+        std::span<const std::uint32_t> indices;
+        std::span<const meshlet> meshlets;
+
+        /* validates the header & blob ranges, nullopt (with an error logged) when bytes aren't a cooked mesh of this version */
+        [[nodiscard]] static auto parse(std::span<const std::uint8_t> bytes) noexcept -> std::optional<cooked_mesh_view>;
+
+        [[nodiscard]] auto bounds_min() const noexcept -> vec3;
+        [[nodiscard]] auto bounds_max() const noexcept -> vec3;
+        /* copies the blobs into a mesh */
+        [[nodiscard]] auto to_mesh() const -> mesh;
+    };
+
+    [[nodiscard]] auto cook_mesh(const mesh& mesh) -> std::vector<std::uint8_t>;
+    /* cooks mesh into path, false (with an error logged) when it can't be written */
+    [[nodiscard]] auto write_cooked_mesh(const mesh& mesh, const std::filesystem::path& path) -> bool;
+    /* maps the file at path & copies its blobs into a mesh, what mesh::load does for cooked_mesh_extension paths */
+    [[nodiscard]] auto load_cooked_mesh(const std::filesystem::path& path) -> std::optional<mesh>;
+    [[nodiscard]] auto is_cooked_mesh_path(const std::filesystem::path& path) noexcept -> bool;
+    /* where a source mesh is cooked to: its path with cooked_mesh_extension appended (e.g. cube.obj.fmesh), so sources differing by extension don't collide */
+    [[nodiscard]] auto cooked_mesh_path(const std::filesystem::path& source) -> std::filesystem::path;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "fae/rendering/texture.hpp"
+
+namespace fae
+{
+    /*
+    textures cooked ahead of time (see the asset_cooker tool) into a binary file that loads without decoding:
+    a header, a table of levels & every mip level (rgba8, or block compressed as it came from a ktx2/dds) at an aligned offset
+    each level is what the gpu takes for that level, so uploading is one write per level & no mips are built at runtime
+    */
+    inline constexpr auto cooked_texture_extension = ".ftex";
+
+    struct cooked_texture_header
+    {
+        static constexpr std::uint32_t expected_magic = 0x58455446; // "FTEX"
+        static constexpr std::uint32_t current_version = 1;
+        static constexpr std::uint64_t level_alignment = 16;
+        /* rgba8 levels, otherwise compression holds a texture_compression */
+        static constexpr std::uint32_t uncompressed = 0xffffffff;
+
+        std::uint32_t magic = expected_magic;
+        std::uint32_t version = current_version;
+        std::uint32_t width = 0;
+        std::uint32_t height = 0;
+        std::uint32_t level_count = 0;
+        std::uint32_t compression = uncompressed;
+        std::uint32_t srgb = 0;
+        std::uint32_t reserved = 0;
+    };
+
+    /* follows the header, one per level (level 0 first) */
+    struct cooked_texture_level
+    {
+        std::uint32_t width = 0;
+        std::uint32_t height = 0;
+        /* from the start of the file */
+        std::uint64_t offset = 0;
+        std::uint64_t size = 0;
+    };
+
+    /* a cooked texture's levels, pointing into the bytes it was parsed from */
+    struct cooked_texture_view
+    {
+        cooked_texture_header header{};
+        std::vector<cooked_texture_level> levels{};
+        std::span<const std::uint8_t> bytes{};
+
+        /* validates the header & level ranges, nullopt (with an error logged) when bytes aren't a cooked texture of this version */
+        [[nodiscard]] static auto parse(std::span<const std::uint8_t> bytes) -> std::optional<cooked_texture_view>;
+
+        [[nodiscard]] auto level_data(std::size_t level) const noexcept -> std::span<const std::uint8_t>;
+        /* copies the levels into a texture (its mips, or compressed) */
+        [[nodiscard]] auto to_texture() const -> texture;
+    };
+
+    /* textures with rgba8 data get their full mip chain built (see build_mip_chain), compressed ones keep their levels */
+    [[nodiscard]] auto cook_texture(const texture& texture, const mip_chain_options& mip_options = {}) -> std::vector<std::uint8_t>;
+    /* cooks texture into path, false (with an error logged) when it can't be written */
+    [[nodiscard]] auto write_cooked_texture(const texture& texture, const std::filesystem::path& path, const mip_chain_options& mip_options = {}) -> bool;
+    /* maps the file at path & copies its levels into a texture, what texture::load does for cooked_texture_extension paths */
+    [[nodiscard]] auto load_cooked_texture(const std::filesystem::path& path) -> std::optional<texture>;
+    [[nodiscard]] auto is_cooked_texture_path(const std::filesystem::path& path) noexcept -> bool;
+    /* where a source texture is cooked to: its path with cooked_texture_extension appended (e.g. wood.png.ftex) */
+    [[nodiscard]] auto cooked_texture_path(const std::filesystem::path& source) -> std::filesystem::path;
+}
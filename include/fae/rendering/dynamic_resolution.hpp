@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+
+#include "render_settings.hpp"
+
+namespace fae
+{
+    /*
+    picks the scale scenes are rendered at from measured frame times (see dynamic_resolution_settings)
+    lowers it after a few frames over budget & raises it only after many frames well under it, so the scale doesn't oscillate
+    */
+    struct dynamic_resolution
+    {
+        float scale = 1.f;
+        std::uint32_t frames_over_budget = 0;
+        std::uint32_t frames_under_budget = 0;
+
+        /* feeds one frame's time, returns true when the scale changed */
+        auto update(float frame_ms, const dynamic_resolution_settings& settings) noexcept -> bool;
+        /* back to full resolution, e.g. when disabled */
+        auto reset() noexcept -> void;
+    };
+
+    /* a width or height at scale, at least 1 */
+    [[nodiscard]] auto scaled_extent(std::uint32_t size, float scale) noexcept -> std::uint32_t;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <string>
+
+#include "gpu_frame_stats.hpp"
+
+namespace fae
+{
+    /*
+    records the frames' cpu encode time & gpu pass times and writes them in the chrome trace event format
+    (open in ui.perfetto.dev or chrome://tracing). gpu clocks aren't synchronized with the cpu's, so each frame's
+    gpu passes are placed at the time the frame was submitted, on their own track
+    */
+    struct frame_trace
+    {
+        /* the file written by write, and when the application stops (see rendering_plugin::trace_path) */
+        std::filesystem::path path;
+        /* events of older frames are dropped */
+        std::size_t max_frames = 1000;
+
+        auto add_cpu_frame(std::uint64_t frame, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point submitted) -> void;
+        /* the gpu passes of a frame added with add_cpu_frame, ignored if it is too old or was already added */
+        auto add_gpu_frame(const gpu_frame_stats& stats) -> void;
+        /* returns false if the file couldn't be written */
+        auto write() const -> bool;
+
+      private:
+        struct event
+        {
+            std::string name;
+            std::uint64_t frame;
+            /* 1 for the cpu track, 2 for the gpu's */
+            int track;
+            std::chrono::steady_clock::time_point begin;
+            std::chrono::nanoseconds duration;
+        };
+        struct submission
+        {
+            std::uint64_t frame;
+            std::chrono::steady_clock::time_point submitted;
+            bool gpu_added = false;
+        };
+        auto drop_old_frames() -> void;
+
+        std::deque<event> m_events;
+        std::deque<submission> m_submissions;
+    };
+}
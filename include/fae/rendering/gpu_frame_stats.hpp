@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "fae/duration.hpp"
+
+namespace fae
+{
+    struct gpu_pass_time
+    {
+        std::string label;
+        /* from the beginning of the frame's first timed pass */
+        duration start{};
+        duration time{};
+    };
+
+    /*
+    gpu time of the render passes of a recent frame, measured with timestamp queries & published by the active renderer
+    results are read back asynchronously, so they describe a frame submitted a few frames ago
+    */
+    struct gpu_frame_stats
+    {
+        /* false when the device has no timestamp queries, nothing else is filled in then */
+        bool supported = false;
+        /* the frame (counted in submitted frames) the passes were measured on */
+        std::uint64_t frame = 0;
+        /* how many frames were submitted since */
+        std::uint64_t frames_late = 0;
+        /* from the beginning of the first timed pass to the end of the last one */
+        duration total{};
+        std::vector<gpu_pass_time> passes;
+    };
+}
@@ -1,20 +1,28 @@
 #pragma once
+
+#include "fae/asset_handle.hpp"
+#include "fae/color.hpp"
 #include "fae/rendering/texture.hpp"
 
 namespace fae
 {
+    /*
+    how a surface is shaded, shared by handle: add it to the asset_manager once & reference the handle from models
+    renderers bake a material's textures, sampler & parameters into one bind group the first time it is drawn
+    */
     struct material
     {
-        texture diffuse = texture
-        {
-            .width = 1,
-            .height = 1,
-            .data = { colors::white },
-        };
+        /* loaded or added through the asset_manager, null draws white */
+        asset_handle<texture> diffuse{};
+        /* multiplied with the diffuse texture */
+        color base_color = colors::white;
         // texture normal;
         // texture metallic;
         // texture roughness;
         // texture ambient_occlusion;
         // texture emissive;
+
+        /* identical materials are added once */
+        [[nodiscard]] auto operator==(const material& rhs) const noexcept -> bool = default;
     };
 }
@@ -1,9 +1,13 @@
 #pragma once
 
-#include <vector>
+#include <cstdint>
 #include <filesystem>
+#include <optional>
+#include <vector>
 
 #include "fae/math.hpp"
+#include "mesh_optimizer.hpp"
+#include "vertex_format.hpp"
 
 namespace fae
 {
@@ -15,12 +19,47 @@ namespace fae
         vec2 uv;
     };
 
+    /*
+    a cluster of a mesh's triangles, small enough to be culled on its own (see build_meshlets)
+    its triangles are the index range [first_index, first_index + index_count) of the mesh
+    */
+    struct meshlet
+    {
+        std::uint32_t first_index = 0;
+        std::uint32_t index_count = 0;
+        /* xyz center, w radius */
+        vec4 bounding_sphere = vec4(0.f);
+        /* every triangle faces away from a camera for which dot(normalize(cone_apex - camera), cone_axis) >= cone_cutoff */
+        vec3 cone_apex = vec3(0.f);
+        vec3 cone_axis = vec3(0.f, 0.f, 1.f);
+        float cone_cutoff = 1.f;
+    };
+
+    struct mesh_import_options
+    {
+        /* reorder indices & vertices for the gpu's caches (see optimize_mesh) */
+        bool optimize = true;
+        mesh_optimization_options optimization{};
+        /* log the mesh's statistics (see analyze_mesh) before & after optimizing */
+        bool log_statistics = false;
+        /* split the mesh into meshlets after optimizing so the gpu driven renderer can cull it per cluster */
+        bool build_meshlets = false;
+        meshlet_options meshlets{};
+    };
+
     struct mesh
     {
         std::vector<vertex> vertices;
         std::vector<std::uint32_t> indices;
+        /* the layout the vertices are packed into on the gpu, compact formats halve vertex memory & bandwidth */
+        vertex_format format = vertex_format::standard;
+        /* empty unless built, indices are grouped by meshlet when not */
+        std::vector<meshlet> meshlets;
+        /* bump it after editing a mesh in the asset_manager (through assets.get()), renderers upload a mesh again only when it changes */
+        std::uint64_t version = 0;
 
-        static auto load(std::filesystem::path path) -> std::optional<mesh>;
+        /* imports the file with assimp, or maps it without parsing when cooked (see cooked_mesh_extension), options then only build missing meshlets */
+        static auto load(std::filesystem::path path, const mesh_import_options& options = {}) -> std::optional<mesh>;
 
         constexpr auto has_indices() const noexcept -> bool
         {
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+
+namespace fae
+{
+    struct mesh;
+
+    struct mesh_optimization_options
+    {
+        /* reorder triangles so vertices are still in the post transform cache when reused */
+        bool vertex_cache = true;
+        /* reorder clusters of triangles front to back, may worsen acmr by up to overdraw_threshold */
+        bool overdraw = true;
+        float overdraw_threshold = 1.05f;
+        /* reorder vertices in the order triangles first use them, for locality of vertex fetches */
+        bool vertex_fetch = true;
+    };
+
+    struct meshlet_options
+    {
+        /* 64 & 124 fit the meshlet sizes gpus prefer and keep a meshlet's triangles in one post transform cache */
+        std::uint32_t max_vertices = 64;
+        std::uint32_t max_triangles = 124;
+        /* 0 optimizes meshlets for culling by their bounding sphere, 1 for their normal cone */
+        float cone_weight = 0.25f;
+    };
+
+    /*
+    how efficiently a mesh's triangles use the gpu, computed for a fifo post transform cache
+    acmr: vertices transformed per triangle (0.5 is ideal for large grids, 3 is the worst)
+    atvr: vertices transformed per vertex of the mesh (1 is ideal)
+    overdraw: pixels shaded per covered pixel, measured from a few view directions (1 is ideal)
+    overfetch: bytes fetched from the vertex buffer per byte it holds (1 is ideal)
+    */
+    struct mesh_statistics
+    {
+        float acmr = 0.f;
+        float atvr = 0.f;
+        float overdraw = 0.f;
+        float overfetch = 0.f;
+    };
+
+    /* meshes without indices are indexed first (identical vertices merged) */
+    auto optimize_mesh(mesh& mesh, const mesh_optimization_options& options = {}) -> void;
+    /*
+    splits the mesh into meshlets with bounding spheres & normal cones, its indices are rewritten so every meshlet's triangles are contiguous
+    build them after optimizing, optimize_mesh reorders the indices & drops the meshlets
+    */
+    auto build_meshlets(mesh& mesh, const meshlet_options& options = {}) -> void;
+    [[nodiscard]] auto analyze_mesh(const mesh& mesh, std::uint32_t cache_size = 16) -> mesh_statistics;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace fae
+{
+    struct mip_level
+    {
+        std::size_t width;
+        std::size_t height;
+        /* in bytes, from the start of mip_chain::data */
+        std::size_t offset;
+    };
+
+    /*
+    every level of an rgba8 image, back to back in a single allocation (level 0 first)
+    each level is max(1, previous / 2) in both dimensions, down to 1x1
+    */
+    struct mip_chain
+    {
+        std::vector<std::uint8_t> data;
+        std::vector<mip_level> levels;
+
+        [[nodiscard]] auto level_data(std::size_t level) const noexcept -> std::span<const std::uint8_t>;
+    };
+
+    struct mip_chain_options
+    {
+        /* decode texels as srgb and average them in linear space (alpha is always linear) */
+        bool srgb = false;
+        /* levels with at least this many texels are filtered by several threads, split by rows (0 never splits) */
+        std::size_t parallel_texel_threshold = 256 * 256;
+    };
+
+    [[nodiscard]] auto mip_level_count(std::size_t width, std::size_t height) noexcept -> std::uint32_t;
+    [[nodiscard]] auto mip_chain_size_in_bytes(std::size_t width, std::size_t height) noexcept -> std::size_t;
+
+    /*
+    builds the full mip chain of a tightly packed rgba8 image
+    even dimensions use a (simd) 2x2 box filter, odd dimensions a 3 tap filter weighted by texel coverage
+    */
+    [[nodiscard]] auto build_mip_chain(std::span<const std::uint8_t> rgba8,
+        std::size_t width,
+        std::size_t height,
+        const mip_chain_options& options = {}) -> mip_chain;
+}
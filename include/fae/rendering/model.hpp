@@ -1,21 +1,20 @@
 #pragma once
 
+#include "fae/asset_handle.hpp"
 #include "fae/rendering/mesh.hpp"
 #include "fae/rendering/material.hpp"
 
 namespace fae
 {
+    /*
+    references its mesh & material, one copy of each in the asset_manager serves every model using them
+    with the rendering_plugin the component holds a reference to both while set (replace it with set_component to switch them, not in place)
+    */
     struct model
     {
-        fae::mesh mesh;
-        fae::material material = fae::material
-        {
-            .diffuse = fae::texture
-            {
-                .width = 1,
-                .height = 1,
-                .data = { fae::color{ 255, 255, 255, 255 } },
-            },
-        };
+        /* loaded or added through the asset_manager, models whose mesh isn't ready (or was unloaded) are not drawn */
+        asset_handle<fae::mesh> mesh{};
+        /* added with asset_manager::add, null draws with a default white material */
+        asset_handle<fae::material> material{};
     };
 }
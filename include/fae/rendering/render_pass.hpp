@@ -1,13 +1,17 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 
+#include "fae/asset_handle.hpp"
 #include "fae/math.hpp"
 #include "fae/color.hpp"
 
 namespace fae
 {
+    struct mesh;
+    struct material;
     struct model;
     struct render_pipeline;
 
@@ -24,5 +28,16 @@ namespace fae
             const transform& transform;
         };
         std::function<void(const render_model_args& args)> render_model;
+
+        struct render_batch_args
+        {
+            /* already in world space */
+            const fae::mesh& mesh;
+            asset_handle<fae::material> material;
+            /* identifies the batch across frames, renderers keep its gpu copy until version changes */
+            std::uint64_t id;
+            std::uint64_t version;
+        };
+        std::function<void(const render_batch_args& args)> render_batch;
     };
 }
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+
+namespace fae
+{
+    /*
+    lower the resolution scenes are rendered at when frames take longer than a budget & raise it again once there is headroom
+    the scene is rendered into a smaller texture & upscaled to the target, ui is drawn at full resolution over it
+    */
+    struct dynamic_resolution_settings
+    {
+        bool enabled = false;
+        /* frame time to stay under, gpu time when timestamp queries are supported & the time between frames otherwise */
+        float target_frame_ms = 16.6f;
+        /* the scale of the target's width & height scenes may be rendered at */
+        float min_scale = 0.5f;
+        float max_scale = 1.f;
+        /* scales are multiples of this, so render textures are only reallocated when a bucket changes */
+        float scale_step = 0.125f;
+        /* consecutive frames over budget before lowering the scale, & under budget * headroom before raising it */
+        std::uint32_t frames_to_lower = 4;
+        std::uint32_t frames_to_raise = 60;
+        float headroom = 0.8f;
+    };
+
+    /*
+    renderer options that can change from frame to frame (e.g. per scene), read by the active renderer when a pass begins
+    */
+    struct render_settings
+    {
+        /*
+        lay down depth in a depth only pass first, then shade with an Equal depth test & depth writes off
+        every pixel is shaded once, which pays off when overdraw is high & fragments are expensive (many lights), at the cost of transforming every vertex twice
+        */
+        bool depth_prepass = false;
+        /*
+        skip gpu driven instances hidden behind what was already drawn (see gpu_driven_renderer), tested against a hi-z pyramid of the frame's depth
+        pays off when much of the scene is occluded, otherwise it costs the pyramid & a second culling pass for little
+        */
+        bool occlusion_culling = true;
+        /*
+        pack same sized textures of materials into shared texture arrays & pass each draw's layer with its uniforms
+        materials that only differ by their texture then share a bind group, consecutive draws of different materials don't rebind it
+        arrays are allocated in large blocks that are only freed when this is turned off again, compressed textures keep a texture of their own
+        */
+        bool texture_arrays = false;
+        dynamic_resolution_settings dynamic_resolution{};
+    };
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "fae/duration.hpp"
+
+namespace fae
+{
+    /*
+    per frame cpu side renderer metrics (see gpu_frame_stats for the gpu side), published by the active renderer once a frame has been submitted
+    */
+    struct render_stats
+    {
+        /* cpu time from beginning the frame's render pass to submitting it (recording commands & uploads included) */
+        duration cpu_encode_time{};
+
+        /* bytes written to gpu buffers & textures during the last frame */
+        std::size_t bytes_uploaded = 0;
+
+        /* gpu memory held by resident textures (including their mip chains) */
+        std::size_t texture_bytes_resident = 0;
+        /* 0 when texture eviction is disabled */
+        std::size_t texture_budget_bytes = 0;
+        std::size_t textures_resident = 0;
+        /* with render_settings::texture_arrays: textures packed into arrays, how many arrays hold them & their gpu memory */
+        std::size_t texture_array_layers = 0;
+        std::size_t texture_arrays = 0;
+        std::size_t texture_array_bytes = 0;
+        /* draws of the default pipeline & how many of them bound a different material than the draw before */
+        std::size_t draws = 0;
+        std::size_t material_binds = 0;
+
+        /* passes declared in the frame's render graph & how many of those were culled because nothing used their results */
+        std::size_t graph_passes = 0;
+        std::size_t graph_passes_culled = 0;
+        /* transient textures the graph's passes used & gpu textures backing them (fewer when aliased) */
+        std::size_t graph_transient_textures = 0;
+        std::size_t graph_allocated_textures = 0;
+
+        /* bytes that went through the staging belt during the last frame, staging memory allocated now & the most it ever was */
+        std::size_t staging_bytes = 0;
+        std::size_t staging_bytes_allocated = 0;
+        std::size_t staging_bytes_high_water = 0;
+
+        /* frames submitted but not finished by the gpu yet & how many may be */
+        std::size_t frames_in_flight = 0;
+        std::size_t max_frames_in_flight = 0;
+        /* from beginning a frame to the gpu finishing it, for the latest finished frame (grows with frames in flight) */
+        duration frame_latency{};
+        /* how long beginning this frame waited for the gpu because too many frames were in flight */
+        duration frame_pacing_wait{};
+
+        /* the resolution scenes were rendered at before being upscaled to the target (see render_settings::dynamic_resolution) */
+        float resolution_scale = 1.f;
+        std::uint32_t render_width = 0;
+        std::uint32_t render_height = 0;
+
+        /* gpu driven instances outside the frustum, hidden behind others (with render_settings::occlusion_culling) & drawn, read back a few frames late */
+        std::size_t gpu_driven_frustum_culled = 0;
+        std::size_t gpu_driven_occluded = 0;
+        std::size_t gpu_driven_drawn = 0;
+    };
+}
@@ -18,6 +18,8 @@ namespace fae
         std::function<const color&()> get_clear_color;
         std::function<void(const color &value)> set_clear_color;
         std::function<render_pass(const render_pipeline&)> begin;
+        /* submits every pass begun this frame at once & presents */
+        std::function<void()> end_frame;
         std::function<std::vector<render_pass>()> get_active_render_passes;
     };
 }
@@ -1,14 +1,21 @@
 #pragma once
 
 #include <concepts>
+#include <filesystem>
 #include <type_traits>
 
+#include "dynamic_resolution.hpp"
+#include "frame_trace.hpp"
+#include "gpu_frame_stats.hpp"
 #include "material.hpp"
 #include "mesh.hpp"
 #include "model.hpp"
 #include "render_pass.hpp"
 #include "render_pipeline.hpp"
+#include "render_settings.hpp"
+#include "render_stats.hpp"
 #include "renderer.hpp"
+#include "static_batching.hpp"
 #include "texture.hpp"
 #include "webgpu_renderer.hpp"
 
@@ -20,6 +27,7 @@ namespace fae
     struct scheduler;
     struct ecs_world;
     struct update_step;
+    struct deinit_step;
     struct window_resized;
 
     struct render_step
@@ -43,10 +51,14 @@ namespace fae
 
     struct rendering_plugin
     {
+        /* when set, frames' cpu & gpu timings are recorded & written there as a chrome trace when the application stops (see frame_trace) */
+        std::filesystem::path trace_path{};
+
         auto init(application& app) const noexcept -> void;
     };
 
     auto update_rendering(const update_step& step) noexcept -> void;
     auto render_models(const render_step& step) noexcept -> void;
     auto resize_active_render_passes(const window_resized& e) noexcept -> void;
+    auto write_frame_trace(const deinit_step& step) noexcept -> void;
 }
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "fae/entity.hpp"
+#include "fae/math.hpp"
+#include "fae/asset_handle.hpp"
+#include "fae/rendering/model.hpp"
+
+namespace fae
+{
+    struct render_step;
+
+    /*
+    marks an entity whose model & transform rarely change
+    static entities with the same material, vertex format & group are pre transformed & merged into one mesh drawn at once (see static_batches)
+    */
+    struct static_model
+    {
+        /* only entities of the same group are merged, e.g. to keep far apart areas of a scene in separate batches */
+        std::uint32_t group = 0;
+    };
+
+    /*
+    the merged meshes of every static_model, a batch is merged again only when one of its members is added, removed, moved, changes model or its mesh is edited (see mesh::version)
+    renderers keep a batch's gpu buffers until its version changes
+    */
+    struct static_batches
+    {
+        struct member
+        {
+            entity id;
+            mat4 transform;
+            /* a reloaded mesh is issued a new handle, a mesh edited in place keeps it & bumps its version */
+            asset_handle<fae::mesh> mesh;
+            std::uint64_t mesh_version = 0;
+
+            [[nodiscard]] auto operator==(const member&) const noexcept -> bool = default;
+        };
+
+        struct batch
+        {
+            std::uint64_t id;
+            std::uint64_t version = 0;
+            std::uint32_t group = 0;
+            /* the members' meshes in world space, drawn with an identity transform */
+            fae::mesh mesh;
+            asset_handle<fae::material> material;
+            std::vector<member> members;
+        };
+
+        std::vector<batch> batches;
+        /* batches merged during the last frame */
+        std::size_t merges = 0;
+        std::uint64_t next_id = 1;
+    };
+
+    /* merges the batches that changed & renders every batch, entities with a static_model are skipped by render_models */
+    auto render_static_batches(const render_step& step) noexcept -> void;
+}
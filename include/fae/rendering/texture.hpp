@@ -3,8 +3,12 @@
 #include <cstdint>
 #include <vector>
 #include <filesystem>
+#include <optional>
 
+#include "fae/asset_handle.hpp"
 #include "fae/color.hpp"
+#include "fae/rendering/compressed_texture.hpp"
+#include "fae/rendering/mip_chain.hpp"
 
 namespace fae
 {
@@ -13,6 +17,12 @@ namespace fae
         std::size_t width;
         std::size_t height;
         std::vector<color> data;
+        /* set when loaded from a .ktx2/.dds file, data is empty then and the blocks are uploaded as they are */
+        std::optional<compressed_texture> compressed{};
+        /* set when loaded cooked (see cooked_texture.hpp) with its mips precomputed, data is empty then and the levels are uploaded as they are */
+        std::optional<mip_chain> mips{};
+        /* set by the asset_manager when loaded through it, identifies the texture's gpu copy */
+        asset_handle<texture> handle{};
 
         static auto load(std::filesystem::path path) -> std::optional<texture>;
     };
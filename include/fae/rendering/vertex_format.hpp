@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "fae/math.hpp"
+
+namespace fae
+{
+    struct vertex;
+
+    /*
+    how a mesh's vertices are laid out in gpu memory, meshes keep full precision vertices on the cpu & are packed when uploaded
+    standard: 48 bytes, every attribute in 32 bit floats
+    compact: 20 bytes, float32 position, octahedral snorm16 normal, half float uv & no vertex color (drawn white)
+    compact_with_color: 24 bytes, compact plus an unorm8 color
+    */
+    enum struct vertex_format
+    {
+        standard,
+        compact,
+        compact_with_color,
+    };
+    constexpr std::size_t vertex_format_count = 3;
+
+    struct compact_vertex
+    {
+        vec3 position;
+        /* octahedral encoded unit normal */
+        std::array<std::int16_t, 2> normal;
+        /* half floats, so uvs outside [0, 1] keep repeating */
+        std::array<std::uint16_t, 2> uv;
+    };
+    static_assert(sizeof(compact_vertex) == 20);
+
+    struct compact_colored_vertex
+    {
+        vec3 position;
+        std::array<std::int16_t, 2> normal;
+        std::array<std::uint16_t, 2> uv;
+        std::array<std::uint8_t, 4> color;
+    };
+    static_assert(sizeof(compact_colored_vertex) == 24);
+
+    [[nodiscard]] auto vertex_stride(vertex_format format) noexcept -> std::size_t;
+    /* maps a unit vector onto the octahedron unfolded into [-1, 1]^2, decoded in the vertex shader */
+    [[nodiscard]] auto octahedral_encode(vec3 normal) noexcept -> std::array<std::int16_t, 2>;
+    [[nodiscard]] auto octahedral_decode(std::array<std::int16_t, 2> encoded) noexcept -> vec3;
+    /* the vertices in format's layout, as uploaded to the gpu */
+    [[nodiscard]] auto pack_vertices(std::span<const vertex> vertices, vertex_format format) -> std::vector<std::uint8_t>;
+}
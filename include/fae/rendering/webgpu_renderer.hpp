@@ -2,9 +2,11 @@
 
 namespace fae
 {
+    struct asset_manager;
     struct ecs_world;
     struct entity_commands;
     struct renderer;
 
-    [[nodiscard]] auto make_webgpu_renderer(ecs_world& ecs_world, entity_commands& global_entity) noexcept -> renderer;
+    /* materials of the models drawn are looked up in assets */
+    [[nodiscard]] auto make_webgpu_renderer(ecs_world& ecs_world, entity_commands& global_entity, asset_manager& assets) noexcept -> renderer;
 }
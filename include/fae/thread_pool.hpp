@@ -0,0 +1,40 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace fae
+{
+    /*
+    runs submitted tasks on worker threads, several at once in submission order
+    without workers (thread_count 0, always the case on the web) tasks run on the submitting thread instead
+    tasks still queued when the pool is destroyed are dropped, running ones are waited for
+    */
+    struct thread_pool
+    {
+        explicit thread_pool(std::size_t thread_count = default_thread_count());
+        thread_pool(const thread_pool&) = delete;
+        auto operator=(const thread_pool&) -> thread_pool& = delete;
+        ~thread_pool();
+
+        auto submit(std::function<void()> task) -> void;
+
+        [[nodiscard]] auto thread_count() const noexcept -> std::size_t;
+        /* one thread less than the hardware has (the main thread keeps one), at least 1 */
+        [[nodiscard]] static auto default_thread_count() noexcept -> std::size_t;
+
+      private:
+        auto work(std::stop_token stop_token) -> void;
+
+        std::mutex m_mutex;
+        std::condition_variable_any m_task_available;
+        std::deque<std::function<void()>> m_tasks;
+        /* last so the workers stop & join before the queue they read goes away */
+        std::vector<std::jthread> m_workers;
+    };
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+
 #include <webgpu/webgpu_cpp.h>
 
 #include "fae/application/application_step.hpp"
@@ -24,10 +26,18 @@ namespace fae
         mat4 model = mat4(1.f);
         mat4 view = mat4(1.f);
         mat4 projection = mat4(1.f);
-        vec4 tint = { 1.f, 1.f, 1.f, 1.f };
+        /* the material's layer of its texture array (see render_settings::texture_arrays), 0 for textures of their own */
+        std::uint32_t texture_layer = 0;
+        std::uint32_t padding[3] = {};
     };
     static_assert(sizeof(local_uniforms_t) % 16 == 0, "uniform buffer must be aligned on 16 bytes");
 
+    struct material_uniforms_t
+    {
+        vec4 base_color = { 1.f, 1.f, 1.f, 1.f };
+    };
+    static_assert(sizeof(material_uniforms_t) % 16 == 0, "uniform buffer must be aligned on 16 bytes");
+
     [[nodiscard]] auto create_default_render_pipeline(ecs_world& ecs_world, entity_commands& global_entity, asset_manager& assets) noexcept -> render_pipeline;
 
     struct webgpu_default_render_pipeline
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include <webgpu/webgpu_cpp.h>
+
+namespace fae
+{
+    /*
+    bounds how many submitted frames the gpu may still be working on & owns a set of per frame buffers for each of them
+    a frame's set is reused once the gpu finished that frame (tracked with OnSubmittedWorkDone), so steady state frames create no buffers
+    more frames in flight lets the cpu run further ahead (throughput), fewer keeps what is drawn closer to the latest input (latency)
+    */
+    struct frame_pacer
+    {
+        /* at least 1 */
+        std::uint32_t max_frames_in_flight = 2;
+
+        /*
+        waits until fewer than max_frames_in_flight frames are still running on the gpu & recycles the buffers of the oldest one
+        natively it blocks in Instance::WaitAny (the instance needs timed waits, see webgpu_plugin) & only polls without them
+        on the web nothing can be waited on, a set whose frame isn't done yet is dropped & its buffers are created again instead
+        */
+        auto begin_frame(const wgpu::Instance& instance) -> void;
+        /* a buffer of at least size bytes (CopyDst added to usage) that belongs to the current frame, valid until its set is reused */
+        [[nodiscard]] auto acquire_buffer(const wgpu::Device& device, std::string_view label, std::uint64_t size, wgpu::BufferUsage usage) -> wgpu::Buffer;
+        /* call right after submitting the frame, began is when its cpu work started */
+        auto submitted(const wgpu::Queue& queue, std::chrono::steady_clock::time_point began) -> void;
+
+        /* submitted frames the gpu hasn't finished yet */
+        [[nodiscard]] auto frames_in_flight() const noexcept -> std::uint64_t;
+        /* cpu begin to gpu completion of the last completed frame, observed when events are processed (at least once per frame) */
+        [[nodiscard]] auto latest_latency() const noexcept -> std::chrono::nanoseconds;
+        /* how long the current frame's begin_frame waited on the gpu */
+        [[nodiscard]] auto wait_time() const noexcept -> std::chrono::nanoseconds;
+        /* gpu memory of every set's buffers */
+        [[nodiscard]] auto allocated_bytes() const noexcept -> std::uint64_t;
+
+      private:
+        struct pooled_buffer
+        {
+            wgpu::Buffer buffer;
+            wgpu::BufferUsage usage;
+            std::uint64_t size;
+            bool used = false;
+        };
+        struct frame_set
+        {
+            /* the frame (counted in submitted frames) that last used the set */
+            std::optional<std::uint64_t> frame;
+            /* completes with that frame's work done callback, begin_frame waits on it */
+            wgpu::Future work_done{};
+            std::vector<pooled_buffer> buffers;
+        };
+        /* shared with the work done callbacks, which may outlive (or see a moved) frame_pacer */
+        struct shared_state
+        {
+            /* frames whose work is done, callbacks complete in submission order */
+            std::uint64_t frames_completed = 0;
+            std::chrono::nanoseconds latest_latency{};
+        };
+
+        std::shared_ptr<shared_state> m_state = std::make_shared<shared_state>();
+        std::vector<frame_set> m_sets;
+        std::size_t m_current = 0;
+        std::uint64_t m_frames_submitted = 0;
+        std::chrono::nanoseconds m_wait_time{};
+    };
+}
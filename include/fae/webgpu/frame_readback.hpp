@@ -0,0 +1,65 @@
+#pragma once
+
+#ifndef FAE_PLATFORM_WEB
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <webgpu/webgpu_cpp.h>
+
+namespace fae
+{
+    /* one frame of the offscreen render target copied back to the cpu */
+    struct readback_frame
+    {
+        /* webgpu::frames_submitted when the frame was recorded */
+        std::uint64_t frame;
+        std::uint32_t width;
+        std::uint32_t height;
+        /* tightly packed rows of 4 byte texels, in the render target's format */
+        std::vector<std::uint8_t> pixels;
+    };
+
+    /*
+    copies frames into a ring of mappable buffers and maps them asynchronously, so reading frames back never stalls the cpu
+    frames are dropped (not waited for) while every buffer is still in flight
+    */
+    struct frame_readback
+    {
+        std::size_t max_frames_in_flight = 3;
+
+        /* records a copy of texture (needs the CopySrc usage) into the next free buffer. returns false if the frame was dropped */
+        auto record(const wgpu::Device& device, const wgpu::CommandEncoder& command_encoder, const wgpu::Texture& texture, std::uint64_t frame) -> bool;
+        /* call once the encoder passed to record was submitted, starts mapping its buffer */
+        auto submitted() -> void;
+        /* frames whose buffers finished mapping since the last call, oldest first (mapping completes while the instance processes events) */
+        [[nodiscard]] auto take_completed() -> std::vector<readback_frame>;
+        [[nodiscard]] auto frames_in_flight() const noexcept -> std::size_t;
+        [[nodiscard]] auto frames_dropped() const noexcept -> std::size_t;
+
+      private:
+        struct slot
+        {
+            wgpu::Buffer buffer;
+            std::uint64_t size = 0;
+            std::uint32_t width = 0;
+            std::uint32_t height = 0;
+            std::uint32_t padded_bytes_per_row = 0;
+            std::uint64_t frame = 0;
+            bool in_flight = false;
+        };
+        /* shared with the map callbacks, which may outlive (or see a moved) frame_readback */
+        struct shared_state
+        {
+            std::vector<std::unique_ptr<slot>> slots;
+            std::vector<readback_frame> completed;
+        };
+        std::shared_ptr<shared_state> m_state = std::make_shared<shared_state>();
+        slot* m_recorded = nullptr;
+        std::size_t m_frames_dropped = 0;
+    };
+}
+
+#endif
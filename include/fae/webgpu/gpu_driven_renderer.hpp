@@ -0,0 +1,263 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <webgpu/webgpu_cpp.h>
+
+#include "fae/math.hpp"
+#include "fae/color.hpp"
+#include "fae/rendering/texture.hpp"
+#include "fae/rendering/mesh.hpp"
+#include "fae/rendering/model.hpp"
+#include "fae/webgpu/staging_belt.hpp"
+#include "fae/webgpu/texture_residency.hpp"
+
+namespace fae
+{
+    /*
+    draws many instances of a few models without per object cpu work
+    instance transforms live in a storage buffer, a compute pass frustum culls them every frame and writes one DrawIndexedIndirect per model
+    instances are only uploaded when added or moved, so a frame costs the same on the cpu for 100 or 1'000'000 instances
+    models with meshlets (see build_meshlets) are also culled per meshlet against the frustum & their normal cone, with one indirect draw per meshlet
+    the culled instances of every draw are compacted into one visible list (count, prefix sum & scatter passes), each draw reading its range through firstInstance
+    with occlusion culling, culling runs in two phases: the early phase draws what was visible last frame, a hi-z pyramid is built from the depth
+    that leaves & the late phase draws the instances that pass a test against it (what became visible), remembering every instance's visibility
+    the late phase culls after the early phase's draws, so it reuses their indirect draws & visible list
+    */
+    struct gpu_driven_renderer
+    {
+        /* what instances are drawn with, the mesh is merged into shared vertex & index buffers. the texture is kept resident by its handle, load or add it through the asset_manager */
+        [[nodiscard]] auto add_model(const mesh& mesh, const texture& diffuse = texture{ .width = 1, .height = 1, .data = { colors::white } }, color base_color = colors::white) -> std::uint32_t;
+        [[nodiscard]] auto add_instance(std::uint32_t model_index, const transform& transform) -> std::uint32_t;
+        auto set_transform(std::uint32_t instance_index, const transform& transform) noexcept -> void;
+        /* drops every model & instance */
+        auto clear() noexcept -> void;
+
+        [[nodiscard]] auto model_count() const noexcept -> std::size_t;
+        [[nodiscard]] auto instance_count() const noexcept -> std::size_t;
+        /* indirect draws per frame, one per meshlet or per model without meshlets */
+        [[nodiscard]] auto cluster_count() const noexcept -> std::size_t;
+
+        enum struct cull_phase
+        {
+            early,
+            /* only with occlusion culling, after the early phase's draws & record_hiz */
+            late,
+        };
+
+        struct frame
+        {
+            mat4 view;
+            mat4 projection;
+            vec3 camera_world_position;
+            float time;
+            wgpu::Buffer ambient_light_info_buffer;
+            wgpu::Buffer directional_light_info_buffer;
+            /* the depth buffer record_hiz gets, needed with occlusion culling */
+            std::uint32_t depth_width = 0;
+            std::uint32_t depth_height = 0;
+            bool occlusion_culling = false;
+        };
+        /* uploads what changed for the frame, returns false if there is nothing to draw or setup failed */
+        [[nodiscard]] auto prepare(const wgpu::Device& device, texture_residency& textures, staging_belt& uploads, wgpu::TextureFormat color_format, wgpu::TextureFormat depth_format, const frame& frame) noexcept -> bool;
+        /* a culling compute pass, each must be recorded before the render pass that draws its phase */
+        auto record_culling(const wgpu::CommandEncoder& command_encoder, cull_phase phase = cull_phase::early) noexcept -> void;
+        /* builds the hi-z pyramid from the depth the early phase was drawn into (which needs the TextureBinding usage) */
+        auto record_hiz(const wgpu::Device& device, const wgpu::CommandEncoder& command_encoder, const wgpu::TextureView& depth) noexcept -> void;
+        /* draws the instances a phase's cull let through into an open render pass (this changes the pass' pipeline) */
+        auto draw(const wgpu::RenderPassEncoder& render_pass_encoder, cull_phase phase = cull_phase::early) noexcept -> void;
+        /* call once the frame's culling was submitted, starts reading its counts back */
+        auto submitted() -> void;
+
+        /* instance counts of a recent frame's culling, read back asynchronously so they describe a frame a few frames old */
+        struct cull_stats
+        {
+            std::uint32_t frustum_culled = 0;
+            std::uint32_t occluded = 0;
+            std::uint32_t drawn_early = 0;
+            std::uint32_t drawn_late = 0;
+            /* meshlet instances that didn't fit the visible list (see rebuild_buffers) and weren't drawn */
+            std::uint32_t dropped = 0;
+        };
+        [[nodiscard]] auto latest_cull_stats() const noexcept -> cull_stats;
+
+        /* bytes written to the queue since the last call */
+        [[nodiscard]] auto take_bytes_uploaded() noexcept -> std::size_t;
+
+      private:
+        struct gpu_instance
+        {
+            mat4 model;
+            std::uint32_t model_index;
+            std::uint32_t padding0 = 0;
+            std::uint32_t padding1 = 0;
+            std::uint32_t padding2 = 0;
+        };
+        static_assert(sizeof(gpu_instance) % 16 == 0, "storage buffer elements must be aligned on 16 bytes");
+
+        struct gpu_model_info
+        {
+            vec4 bounding_sphere;
+            std::uint32_t first_cluster;
+            std::uint32_t cluster_count;
+            std::uint32_t padding0 = 0;
+            std::uint32_t padding1 = 0;
+        };
+
+        struct gpu_cluster_info
+        {
+            vec4 bounding_sphere;
+            vec3 cone_apex;
+            float cone_cutoff;
+            vec3 cone_axis;
+            std::uint32_t padding0 = 0;
+        };
+        static_assert(sizeof(gpu_cluster_info) % 16 == 0, "storage buffer elements must be aligned on 16 bytes");
+
+        struct draw_indexed_indirect
+        {
+            std::uint32_t index_count;
+            std::uint32_t instance_count;
+            std::uint32_t first_index;
+            std::int32_t base_vertex;
+            std::uint32_t first_instance;
+        };
+
+        struct cull_uniforms
+        {
+            std::array<vec4, 6> planes;
+            vec4 camera_position;
+            mat4 view_projection;
+            vec2 hiz_size;
+            std::uint32_t instance_count;
+            std::uint32_t dispatch_width;
+            std::uint32_t hiz_mip_count;
+            std::uint32_t occlusion_culling;
+            std::uint32_t phase;
+            std::uint32_t visible_capacity;
+            std::uint32_t indirect_first_instance;
+            std::uint32_t padding0 = 0;
+            std::uint32_t padding1 = 0;
+            std::uint32_t padding2 = 0;
+        };
+        static_assert(sizeof(cull_uniforms) % 16 == 0, "uniform buffers must be sized in multiples of 16 bytes");
+
+        static constexpr std::size_t stats_readback_count = 3;
+        /* shared with the map callbacks, which may outlive (or see a moved) gpu_driven_renderer */
+        struct stats_state
+        {
+            std::array<bool, stats_readback_count> busy{};
+            cull_stats latest{};
+        };
+
+        struct frame_uniforms
+        {
+            mat4 view;
+            mat4 projection;
+            vec3 camera_world_position;
+            float time;
+        };
+
+        /* a meshlet, or a whole model without meshlets */
+        struct cluster_entry
+        {
+            std::uint32_t index_count;
+            std::uint32_t first_index;
+            std::int32_t base_vertex;
+            vec4 bounding_sphere;
+            vec3 cone_apex;
+            vec3 cone_axis;
+            float cone_cutoff;
+        };
+
+        struct model_entry
+        {
+            vec4 bounding_sphere;
+            std::uint32_t first_cluster;
+            std::uint32_t cluster_count;
+            texture diffuse;
+            color base_color;
+            wgpu::Buffer material_uniform_buffer;
+            wgpu::BindGroup material_bind_group;
+            wgpu::TextureView bound_texture_view;
+            std::uint32_t instance_count = 0;
+        };
+
+        auto create_pipelines(const wgpu::Device& device, wgpu::TextureFormat color_format, wgpu::TextureFormat depth_format) noexcept -> bool;
+        /* false (with an error logged) when the buffers would exceed the device's limits, nothing is drawn until the layout changes again */
+        auto rebuild_buffers(const wgpu::Device& device, staging_belt& uploads) noexcept -> bool;
+        /* (re)creates the pyramid & its bind groups for a depth buffer of that size */
+        auto create_hiz(const wgpu::Device& device, std::uint32_t width, std::uint32_t height) noexcept -> void;
+
+        std::vector<vertex> m_vertices{};
+        std::vector<std::uint32_t> m_indices{};
+        std::vector<model_entry> m_models{};
+        std::vector<cluster_entry> m_clusters{};
+        std::vector<gpu_instance> m_instances{};
+        /* instances [m_dirty_begin, m_dirty_end) changed since the last upload */
+        std::size_t m_dirty_begin = 0;
+        std::size_t m_dirty_end = 0;
+        bool m_layout_changed = false;
+        std::size_t m_bytes_uploaded = 0;
+        /* in elements of visible_instances, every visible meshlet of every instance up to the storage binding limit */
+        std::uint32_t m_visible_capacity = 0;
+        /* draws read their range of the visible list through firstInstance, without the feature through m_draw_index_buffer */
+        bool m_indirect_first_instance = false;
+        std::uint32_t m_draw_index_stride = 0;
+        bool m_occlusion_culling = false;
+
+        wgpu::TextureFormat m_color_format = wgpu::TextureFormat::Undefined;
+        wgpu::BindGroupLayout m_cull_bind_group_layout;
+        wgpu::BindGroupLayout m_hiz_bind_group_layout;
+        wgpu::ComputePipeline m_cull_pipeline;
+        wgpu::ComputePipeline m_prefix_sum_pipeline;
+        wgpu::ComputePipeline m_scatter_pipeline;
+        wgpu::RenderPipeline m_render_pipeline;
+        wgpu::BindGroupLayout m_frame_bind_group_layout;
+        wgpu::BindGroupLayout m_instances_bind_group_layout;
+        wgpu::BindGroupLayout m_material_bind_group_layout;
+        wgpu::Sampler m_sampler;
+
+        wgpu::Buffer m_vertex_buffer;
+        wgpu::Buffer m_index_buffer;
+        wgpu::Buffer m_instance_buffer;
+        wgpu::Buffer m_model_info_buffer;
+        wgpu::Buffer m_cluster_info_buffer;
+        wgpu::Buffer m_draw_buffer;
+        wgpu::Buffer m_visible_buffer;
+        /* each draw's count, cursor & first entry */
+        wgpu::Buffer m_compaction_buffer;
+        /* each draw's index at m_draw_index_stride, bound with a dynamic offset when firstInstance can't be used */
+        wgpu::Buffer m_draw_index_buffer;
+        wgpu::Buffer m_cull_uniform_buffer;
+        wgpu::Buffer m_late_cull_uniform_buffer;
+        wgpu::Buffer m_visibility_buffer;
+        wgpu::Buffer m_stats_buffer;
+        std::array<wgpu::Buffer, stats_readback_count> m_stats_readback_buffers;
+        std::shared_ptr<stats_state> m_stats_state = std::make_shared<stats_state>();
+        /* the readback buffer this frame's counts are copied into, if one was free */
+        std::optional<std::size_t> m_stats_pending;
+        wgpu::Buffer m_frame_uniform_buffer;
+        wgpu::BindGroup m_cull_bind_group;
+        wgpu::BindGroup m_late_cull_bind_group;
+
+        wgpu::ComputePipeline m_hiz_copy_pipeline;
+        wgpu::ComputePipeline m_hiz_downsample_pipeline;
+        wgpu::Texture m_hiz_texture;
+        /* the whole pyramid, read by the late phase */
+        wgpu::BindGroup m_hiz_bind_group;
+        /* level n - 1 into level n, the first is unused (level 0 is copied from the depth buffer) */
+        std::vector<wgpu::BindGroup> m_hiz_downsample_bind_groups;
+        wgpu::TextureView m_hiz_level_0_view;
+        wgpu::BindGroup m_instances_bind_group;
+        wgpu::BindGroup m_frame_bind_group;
+        wgpu::Buffer m_bound_ambient_light_info_buffer;
+        std::uint32_t m_workgroups_x = 0;
+        std::uint32_t m_workgroups_y = 0;
+    };
+}
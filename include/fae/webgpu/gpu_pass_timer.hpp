@@ -0,0 +1,65 @@
+#pragma once
+
+#ifndef FAE_PLATFORM_WEB
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <webgpu/webgpu_cpp.h>
+
+#include "fae/rendering/gpu_frame_stats.hpp"
+
+namespace fae
+{
+    /*
+    measures how long render passes take on the gpu with timestamp queries (needs the TimestampQuery feature)
+    each frame resolves into its own readback buffer of a small ring, so results arrive a few frames late without stalling,
+    frames are only skipped when every buffer of the ring is still being read
+    */
+    struct gpu_pass_timer
+    {
+        static constexpr std::uint32_t max_passes = 8;
+        static constexpr std::size_t readback_slots = 3;
+
+        /* timestamp writes to put in the next pass' descriptor, null if the pass can't be timed this frame */
+        [[nodiscard]] auto timestamp_writes(const wgpu::Device& device, std::string label) -> const wgpu::RenderPassTimestampWrites*;
+        /* resolves the frame's timestamps, record into an encoder submitted after every timed pass */
+        auto resolve(const wgpu::CommandEncoder& command_encoder) -> void;
+        /* call once the encoder passed to resolve was submitted, starts mapping the results. frame identifies it in the results */
+        auto submitted(std::uint64_t frame) -> void;
+        /* the last frame whose timings were read back, supported & frames_late are left to the caller */
+        [[nodiscard]] auto latest() const noexcept -> const gpu_frame_stats&;
+
+      private:
+        auto create_buffers(const wgpu::Device& device) -> void;
+
+        struct slot
+        {
+            wgpu::Buffer readback_buffer;
+            bool mapping = false;
+            std::vector<std::string> labels;
+            std::uint64_t frame = 0;
+        };
+        /* shared with the map callbacks, which may outlive (or see a moved) gpu_pass_timer */
+        struct shared_state
+        {
+            std::array<slot, readback_slots> slots;
+            gpu_frame_stats latest;
+        };
+        std::shared_ptr<shared_state> m_state = std::make_shared<shared_state>();
+        wgpu::QuerySet m_query_set;
+        wgpu::Buffer m_resolve_buffer;
+        std::array<wgpu::RenderPassTimestampWrites, max_passes> m_timestamp_writes{};
+        std::vector<std::string> m_labels;
+        /* the slot this frame resolves into */
+        std::size_t m_slot = 0;
+        bool m_resolved = false;
+        bool m_unsupported = false;
+    };
+}
+
+#endif
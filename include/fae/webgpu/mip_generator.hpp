@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include <webgpu/webgpu_cpp.h>
+
+namespace fae
+{
+    /*
+    generates the mip chain of an rgba8 texture on the gpu with a compute pass
+    (the texture needs TextureBinding & StorageBinding usages and level 0 must already be written)
+    the compute pipeline compiles asynchronously, until it is ready (or if it fails) callers build the chain on the cpu instead
+    */
+    struct mip_generator
+    {
+        /* starts compiling the compute pipeline unless it already is, it completes while the instance processes events */
+        auto prepare(const wgpu::Device& device) noexcept -> void;
+        [[nodiscard]] auto ready() const noexcept -> bool;
+        /* the pipeline could not be created, generate never succeeds */
+        [[nodiscard]] auto failed() const noexcept -> bool;
+        /* records & submits the dispatches, returns false (submitting nothing) while the pipeline compiles or if it could not be created */
+        auto generate(const wgpu::Device& device, const wgpu::Texture& texture) noexcept -> bool;
+
+      private:
+        enum struct pipeline_state
+        {
+            none,
+            compiling,
+            ready,
+            failed,
+        };
+        /* shared with the pipeline creation callback, which may outlive (or see a moved) mip_generator */
+        struct shared_state
+        {
+            pipeline_state state = pipeline_state::none;
+            wgpu::ComputePipeline pipeline;
+        };
+
+        std::shared_ptr<shared_state> m_state = std::make_shared<shared_state>();
+        wgpu::BindGroupLayout m_bind_group_layout;
+    };
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#ifndef FAE_PLATFORM_WEB
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+
+#include <webgpu/webgpu_cpp.h>
+
+namespace fae
+{
+    /*
+    on disk store for the blobs dawn caches (compiled shaders & backend pipeline caches), one file per key
+    dawn's keys already hash the shader source & pipeline state, isolation_key keeps blobs of different adapters apart
+    dawn may call load & store from its worker threads while pipelines compile asynchronously
+    */
+    struct pipeline_cache
+    {
+        std::filesystem::path directory;
+        /* e.g. backend, vendor & device id of the adapter (see make_isolation_key) */
+        std::string isolation_key;
+
+        std::atomic<std::size_t> hits = 0;
+        std::atomic<std::size_t> misses = 0;
+        std::atomic<std::size_t> stores = 0;
+
+        [[nodiscard]] static auto make_isolation_key(const wgpu::Adapter& adapter) noexcept -> std::string;
+
+        /* chain into a DeviceDescriptor, this pipeline_cache must outlive the device */
+        [[nodiscard]] auto device_descriptor() noexcept -> wgpu::DawnCacheDeviceDescriptor;
+
+        /* dawn's load protocol: returns the blob's size, copies it only when value_size is large enough. 0 on a miss */
+        auto load(const void* key, std::size_t key_size, void* value, std::size_t value_size) noexcept -> std::size_t;
+        auto store(const void* key, std::size_t key_size, const void* value, std::size_t value_size) noexcept -> void;
+
+      private:
+        [[nodiscard]] auto path_for(const void* key, std::size_t key_size) const noexcept -> std::filesystem::path;
+
+        /* serializes stores, two threads may store the same key */
+        std::mutex m_store_mutex;
+    };
+}
+
+#endif
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <webgpu/webgpu_cpp.h>
+
+namespace fae
+{
+    struct gpu_pass_timer;
+
+    /*
+    a frame's passes declared with the resources they read & write, executed as a whole
+    passes are ordered by their dependencies, passes whose results nothing uses are culled, transient textures whose lifetimes
+    don't overlap share memory, and everything is recorded into one command encoder (submitted once per frame)
+    declare, execute, then reset for the next frame. transient textures are pooled across frames
+    */
+    struct render_graph
+    {
+        using resource_id = std::uint32_t;
+
+        struct texture_desc
+        {
+            wgpu::TextureFormat format = wgpu::TextureFormat::Undefined;
+            std::uint32_t width = 0;
+            std::uint32_t height = 0;
+            wgpu::TextureUsage usage = wgpu::TextureUsage::RenderAttachment;
+
+            [[nodiscard]] auto operator==(const texture_desc&) const noexcept -> bool = default;
+        };
+
+        struct color_attachment
+        {
+            resource_id texture;
+            wgpu::LoadOp load_op = wgpu::LoadOp::Clear;
+            wgpu::Color clear_value = { 0, 0, 0, 1 };
+        };
+
+        struct depth_attachment
+        {
+            resource_id texture;
+            wgpu::LoadOp load_op = wgpu::LoadOp::Clear;
+            float clear_value = 1.f;
+            /* depth is tested but not written */
+            bool read_only = false;
+        };
+
+        struct pass
+        {
+            std::string name;
+            /* render passes have attachments, passes without any get the command encoder instead (compute, copies) */
+            std::vector<color_attachment> color_attachments{};
+            std::optional<depth_attachment> depth_attachment{};
+            /* resources used besides the attachments: sampled textures, buffers */
+            std::vector<resource_id> reads{};
+            std::vector<resource_id> writes{};
+            /* never culled, e.g. copies back to the cpu */
+            bool has_side_effects = false;
+            std::function<void(const wgpu::RenderPassEncoder&)> record_render_pass{};
+            std::function<void(const wgpu::CommandEncoder&)> record_commands{};
+        };
+
+        /* a texture owned outside the graph (e.g. the surface's), writes to it are kept when marked as an output */
+        auto import_texture(std::string name, wgpu::TextureView view, const texture_desc& desc) -> resource_id;
+        /* only orders the passes that use it, buffers are not managed by the graph */
+        auto import_buffer(std::string name) -> resource_id;
+        /* allocated by the graph for this frame only */
+        auto create_texture(std::string name, const texture_desc& desc) -> resource_id;
+        auto mark_output(resource_id resource) -> void;
+        auto add_pass(pass pass) -> void;
+
+        [[nodiscard]] auto texture_desc_of(resource_id resource) const noexcept -> const texture_desc&;
+        /* the view a pass' texture resolves to, valid while the graph executes */
+        [[nodiscard]] auto texture_view(resource_id resource) const noexcept -> wgpu::TextureView;
+
+        /* records every pass that contributes to an output, returns null if nothing was recorded */
+        [[nodiscard]] auto execute(const wgpu::Device& device, gpu_pass_timer* timer = nullptr) -> wgpu::CommandBuffer;
+        /* drops the frame's passes & resources, keeps pooled textures */
+        auto reset() noexcept -> void;
+
+        [[nodiscard]] auto pass_count() const noexcept -> std::size_t;
+        [[nodiscard]] auto passes_culled() const noexcept -> std::size_t;
+        /* transient textures declared during the last execution & gpu textures backing them */
+        [[nodiscard]] auto transient_texture_count() const noexcept -> std::size_t;
+        [[nodiscard]] auto allocated_texture_count() const noexcept -> std::size_t;
+
+      private:
+        enum struct resource_type
+        {
+            imported_texture,
+            transient_texture,
+            buffer,
+        };
+        struct resource
+        {
+            std::string name;
+            resource_type type;
+            texture_desc desc;
+            wgpu::TextureView view;
+            bool output = false;
+            /* index into m_pool while executing */
+            std::optional<std::size_t> pooled_texture;
+        };
+        struct pooled_texture
+        {
+            texture_desc desc;
+            wgpu::Texture texture;
+            wgpu::TextureView view;
+            std::uint64_t last_used_frame = 0;
+        };
+
+        [[nodiscard]] auto order_passes() const -> std::vector<std::size_t>;
+        [[nodiscard]] auto cull_passes(const std::vector<std::size_t>& order) const -> std::vector<std::size_t>;
+        auto allocate_transient_textures(const wgpu::Device& device, const std::vector<std::size_t>& passes) -> void;
+
+        std::vector<resource> m_resources;
+        std::vector<pass> m_passes;
+        std::vector<pooled_texture> m_pool;
+        std::uint64_t m_frame = 0;
+        std::size_t m_passes_culled = 0;
+        std::size_t m_transient_texture_count = 0;
+    };
+}
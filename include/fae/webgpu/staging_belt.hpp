@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <webgpu/webgpu_cpp.h>
+
+namespace fae
+{
+    /*
+    batches a frame's uploads: data is written into large mapped staging buffers (chunks) and copied into its destinations by one command buffer
+    submitted ahead of the frame's commands. once the copies ran, chunks are mapped again asynchronously & reused, so steady state frames allocate nothing
+    on the web chunks are never recycled (no event processing to complete the maps) and writes go through the queue instead
+    */
+    struct staging_belt
+    {
+        /* bytes of each chunk, larger writes get a chunk of their own that is released instead of recycled */
+        std::uint64_t chunk_size = 4 * 1024 * 1024;
+        /* mapped chunks kept around for reuse, the rest are released when they come back */
+        std::size_t max_free_chunks = 8;
+
+        /* size must be a multiple of 4, destination needs the CopyDst usage */
+        auto write_buffer(const wgpu::Device& device, const wgpu::Buffer& destination, std::uint64_t offset, const void* data, std::uint64_t size) -> void;
+        /* rows of bytes_per_row bytes (texel block rows for compressed formats), rows_per_image rows per layer of extent */
+        auto write_texture(const wgpu::Device& device, const wgpu::ImageCopyTexture& destination, const void* data, std::uint32_t bytes_per_row, std::uint32_t rows_per_image, const wgpu::Extent3D& extent) -> void;
+
+        /* unmaps the chunks written since the last call & records their copies, null if nothing was written. submit it before anything using the destinations */
+        [[nodiscard]] auto finish(const wgpu::Device& device) -> wgpu::CommandBuffer;
+        /* call once the command buffer returned by finish was submitted, starts mapping its chunks for reuse */
+        auto submitted() -> void;
+
+        /* bytes written during the frame finish was last called for */
+        [[nodiscard]] auto frame_bytes() const noexcept -> std::uint64_t;
+        /* staging memory currently allocated (mapped, written or in flight) & the most it ever was */
+        [[nodiscard]] auto allocated_bytes() const noexcept -> std::uint64_t;
+        [[nodiscard]] auto high_water_bytes() const noexcept -> std::uint64_t;
+
+      private:
+        struct chunk
+        {
+            wgpu::Buffer buffer;
+            std::uint64_t size = 0;
+            std::uint64_t offset = 0;
+            std::uint8_t* mapped = nullptr;
+        };
+        struct buffer_copy
+        {
+            wgpu::Buffer source;
+            std::uint64_t source_offset;
+            wgpu::Buffer destination;
+            std::uint64_t destination_offset;
+            std::uint64_t size;
+        };
+        struct texture_copy
+        {
+            wgpu::ImageCopyBuffer source;
+            wgpu::ImageCopyTexture destination;
+            wgpu::Extent3D extent;
+        };
+        /* shared with the map callbacks, which may outlive (or see a moved) staging_belt */
+        struct shared_state
+        {
+            std::vector<chunk> free_chunks;
+            std::uint64_t allocated_bytes = 0;
+            std::uint64_t high_water_bytes = 0;
+        };
+
+        /* room for size bytes at an offset aligned to alignment, the returned chunk stays valid until the next allocation */
+        [[nodiscard]] auto allocate(const wgpu::Device& device, std::uint64_t size, std::uint64_t alignment) -> std::pair<chunk*, std::uint64_t>;
+
+        std::shared_ptr<shared_state> m_state = std::make_shared<shared_state>();
+        /* being written this frame, the last one is the one allocations come from */
+        std::vector<chunk> m_active_chunks;
+        /* copied by the last finished command buffer, mapped again once submitted */
+        std::vector<chunk> m_closed_chunks;
+        std::vector<buffer_copy> m_buffer_copies;
+        std::vector<texture_copy> m_texture_copies;
+        std::uint64_t m_bytes_written = 0;
+        std::uint64_t m_frame_bytes = 0;
+    };
+}
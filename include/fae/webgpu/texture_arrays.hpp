@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include <webgpu/webgpu_cpp.h>
+
+#include "fae/asset_handle.hpp"
+#include "fae/rendering/mip_chain.hpp"
+#include "fae/rendering/texture.hpp"
+#include "fae/webgpu/staging_belt.hpp"
+
+namespace fae
+{
+    /*
+    packs same sized rgba8 textures into the layers of shared 2d array textures (see render_settings::texture_arrays), keyed by their asset handle
+    materials whose textures share an array can share a bind group & pick their layer per draw, so drawing them doesn't rebind anything
+    arrays are allocated whole (up to max_array_bytes) & never shrink, a released texture's layer is reused by the next one of its size
+    */
+    struct texture_arrays
+    {
+        /* gpu memory of one array (mip chains included), it gets as many layers as fit & at least one */
+        std::size_t max_array_bytes = 64 * 1024 * 1024;
+        /* clamped to the device's maxTextureArrayLayers */
+        std::uint32_t max_layers_per_array = 256;
+        mip_chain_options mip_options{};
+
+        struct slot
+        {
+            /* index of the array, see view */
+            std::uint32_t array = 0;
+            std::uint32_t layer = 0;
+        };
+
+        /* the layer handle's texture is in, uploading it through uploads first. null for textures that can't be packed (compressed or without a handle) */
+        [[nodiscard]] auto acquire(const wgpu::Device& device, const texture& texture, asset_handle<fae::texture> handle, staging_belt& uploads) -> std::optional<slot>;
+        /* a 2d array view of every layer of the array */
+        [[nodiscard]] auto view(std::uint32_t array) const noexcept -> const wgpu::TextureView&;
+        /* frees handle's layer (if packed) */
+        auto release(asset_handle<texture> handle) noexcept -> void;
+        /* destroys every array */
+        auto clear() noexcept -> void;
+
+        [[nodiscard]] auto array_count() const noexcept -> std::size_t;
+        [[nodiscard]] auto layers_used() const noexcept -> std::size_t;
+        /* gpu memory of every array, free layers included */
+        [[nodiscard]] auto allocated_bytes() const noexcept -> std::size_t;
+        /* bytes uploaded since the last call */
+        [[nodiscard]] auto take_bytes_uploaded() noexcept -> std::size_t;
+
+      private:
+        struct array
+        {
+            wgpu::Texture texture;
+            wgpu::TextureView view;
+            std::size_t width = 0;
+            std::size_t height = 0;
+            std::uint32_t layer_count = 0;
+            std::size_t size_in_bytes = 0;
+            std::vector<std::uint32_t> free_layers;
+        };
+
+        [[nodiscard]] auto create_array(const wgpu::Device& device, std::size_t width, std::size_t height) -> std::uint32_t;
+
+        std::vector<array> m_arrays{};
+        std::unordered_map<asset_handle<texture>, slot> m_slots{};
+        std::size_t m_allocated_bytes = 0;
+        std::size_t m_bytes_uploaded = 0;
+    };
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <webgpu/webgpu_cpp.h>
+
+#include "fae/asset_handle.hpp"
+#include "fae/rendering/mip_chain.hpp"
+#include "fae/rendering/texture.hpp"
+#include "fae/webgpu/mip_generator.hpp"
+#include "fae/webgpu/utils.hpp"
+
+namespace fae
+{
+    /*
+    owns the gpu copies of textures, keyed by their asset handle
+    textures are uploaded on first use and evicted least recently used first once the resident bytes exceed the budget
+    compressed textures are uploaded as they are when the device supports their format and decoded on the cpu otherwise
+    */
+    struct texture_residency
+    {
+        /* 0 disables eviction */
+        std::size_t budget_bytes = 512 * 1024 * 1024;
+        /* upload only level 0 and build mips with a compute pass instead of on the cpu */
+        bool generate_mips_on_gpu = false;
+        /* used when mips are built on the cpu */
+        mip_chain_options mip_options{};
+
+        /* returns the gpu copy of texture, uploading it (through uploads when given) if it is not resident yet */
+        [[nodiscard]] auto acquire(const wgpu::Device& device, const texture& texture, staging_belt* uploads = nullptr) noexcept -> texture_and_view;
+        /* same, keyed by handle instead of the texture's own, for textures owned by another asset (e.g. a material's texture without a file) */
+        [[nodiscard]] auto acquire(const wgpu::Device& device, const texture& texture, asset_handle<fae::texture> handle, staging_belt* uploads = nullptr) noexcept -> texture_and_view;
+        /* destroys the gpu copy of handle (if resident) */
+        auto release(asset_handle<texture> handle) noexcept -> void;
+        /* destroys every gpu copy */
+        auto clear() noexcept -> void;
+        /* call once the frame's commands were submitted. drops transient uploads & evicts down to the budget */
+        auto end_frame() noexcept -> void;
+
+        [[nodiscard]] auto resident_bytes() const noexcept -> std::size_t;
+        [[nodiscard]] auto resident_count() const noexcept -> std::size_t;
+        /* bytes uploaded since the last end_frame */
+        [[nodiscard]] auto frame_bytes_uploaded() const noexcept -> std::size_t;
+
+      private:
+        struct resident_texture
+        {
+            texture_and_view gpu;
+            std::size_t size_in_bytes;
+            std::uint64_t last_used_frame;
+        };
+
+        [[nodiscard]] auto upload(const wgpu::Device& device, const texture& texture, staging_belt* uploads) noexcept -> resident_texture;
+        std::unordered_map<asset_handle<texture>, resident_texture> m_textures{};
+        /* textures without an asset handle cannot be tracked across frames, they live until end_frame */
+        std::vector<texture_and_view> m_transient_textures{};
+        std::size_t m_resident_bytes = 0;
+        std::size_t m_frame_bytes_uploaded = 0;
+        std::uint64_t m_frame = 0;
+        mip_generator m_mip_generator{};
+    };
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <webgpu/webgpu_cpp.h>
+
+namespace fae
+{
+    /*
+    draws a texture stretched over a whole render pass' attachment with bilinear filtering, used to upscale scenes rendered at a lower resolution
+    (the source needs the TextureBinding usage)
+    */
+    struct upscaler
+    {
+        /* records one draw into the pass, whose color attachment has the given format. returns false if the pipeline could not be created */
+        auto record(const wgpu::Device& device, const wgpu::RenderPassEncoder& render_pass_encoder, const wgpu::TextureView& source, wgpu::TextureFormat target_format) noexcept -> bool;
+
+      private:
+        auto create_pipeline(const wgpu::Device& device, wgpu::TextureFormat target_format) noexcept -> bool;
+
+        wgpu::TextureFormat m_target_format = wgpu::TextureFormat::Undefined;
+        wgpu::BindGroupLayout m_bind_group_layout;
+        wgpu::RenderPipeline m_pipeline;
+        wgpu::Sampler m_sampler;
+    };
+}
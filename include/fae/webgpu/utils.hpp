@@ -3,41 +3,109 @@
 #include <string_view>
 #include <optional>
 #include <filesystem>
+#include <functional>
+#include <vector>
 
 #include <webgpu/webgpu_cpp.h>
 
+#include "fae/rendering/compressed_texture.hpp"
+#include "fae/rendering/mip_chain.hpp"
 #include "fae/rendering/texture.hpp"
+#include "fae/rendering/vertex_format.hpp"
 
 namespace fae
 {
+    struct mip_generator;
+    struct staging_belt;
+
     [[nodiscard]] auto request_adapter_sync(wgpu::Instance instance, wgpu::RequestAdapterOptions adapter_options = {}) noexcept -> wgpu::Adapter;
     [[nodiscard]] auto request_device_sync(wgpu::Adapter adapter, wgpu::DeviceDescriptor device_descriptor = {}) noexcept -> wgpu::Device;
     [[nodiscard]] wgpu::Buffer create_buffer(const wgpu::Device& device,
         std::string_view label,
         std::size_t size,
         wgpu::BufferUsage usage);
+    /* with uploads the data is copied when the staging belt's commands are submitted, otherwise written through the queue */
     [[nodiscard]] wgpu::Buffer create_buffer_with_data(const wgpu::Device& device,
         std::string_view label,
         const void* data,
         std::size_t size,
-        wgpu::BufferUsage usage);
+        wgpu::BufferUsage usage,
+        staging_belt* uploads = nullptr);
     [[nodiscard]] wgpu::ShaderModule create_shader_module_from_str(const wgpu::Device& device,
         std::string_view label,
         std::string_view src);
     [[nodiscard]] std::optional<wgpu::ShaderModule> create_shader_module_from_path(const wgpu::Device& device,
         std::string_view label,
         const std::filesystem::path& path);
+    /*
+    compiles the pipeline without blocking, on_created gets it (null on failure) while the instance processes events
+    the web has no such callback mode here, the pipeline is created synchronously & on_created runs before returning
+    */
+    auto create_render_pipeline_async(const wgpu::Device& device,
+        const wgpu::RenderPipelineDescriptor& descriptor,
+        std::function<void(wgpu::RenderPipeline)> on_created) noexcept -> void;
+    /* like create_render_pipeline_async, a failed pipeline is reported as null instead of an error object */
+    auto create_compute_pipeline_async(const wgpu::Device& device,
+        const wgpu::ComputePipelineDescriptor& descriptor,
+        std::function<void(wgpu::ComputePipeline)> on_created) noexcept -> void;
     [[nodiscard]] wgpu::Texture create_texture(const wgpu::Device& device,
         std::string_view label,
         wgpu::Extent3D extent,
         wgpu::TextureFormat format,
         wgpu::TextureUsage usage);
 
+    /*
+    a vertex_format's attributes at the locations the engine's shaders read them from: 0 position, 1 color, 2 normal, 3 uv
+    compact formats leave out color (unless with color) & hand the octahedral normal over undecoded
+    */
+    struct vertex_layout
+    {
+        std::vector<wgpu::VertexAttribute> attributes;
+        std::uint64_t stride;
+
+        /* points into attributes */
+        [[nodiscard]] auto buffer_layout() const noexcept -> wgpu::VertexBufferLayout;
+    };
+    [[nodiscard]] auto make_vertex_layout(vertex_format format) -> vertex_layout;
+
     struct texture_and_view
     {
         wgpu::Texture texture;
         wgpu::TextureView view;
     };
+    /* builds the mip chain on the cpu (see build_mip_chain) and uploads every level */
     [[nodiscard]] texture_and_view create_texture_with_mips_and_view(const wgpu::Device& device,
-        texture texture);
+        const texture& texture,
+        const mip_chain_options& mip_options = {},
+        staging_belt* uploads = nullptr);
+    /* uploads every level of an rgba8 mip chain */
+    [[nodiscard]] texture_and_view create_texture_from_mip_chain(const wgpu::Device& device,
+        const mip_chain& chain,
+        staging_belt* uploads = nullptr);
+
+    /* compressed textures are sampled as unorm even when the payload is srgb, same as the rgba8 path */
+    [[nodiscard]] auto to_wgpu_texture_format(texture_compression compression) noexcept -> wgpu::TextureFormat;
+    /* the feature a device needs to sample the compression format */
+    [[nodiscard]] auto required_feature(texture_compression compression) noexcept -> wgpu::FeatureName;
+    /* whether the device has the format's feature & the texture is a whole number of blocks (webgpu requires both) */
+    [[nodiscard]] auto can_upload_compressed(const wgpu::Device& device, const compressed_texture& texture) noexcept -> bool;
+    /* uploads the precompressed levels as they are, check can_upload_compressed first */
+    [[nodiscard]] texture_and_view create_compressed_texture_and_view(const wgpu::Device& device,
+        const compressed_texture& texture,
+        staging_belt* uploads = nullptr);
+
+    /* uploads only level 0 and lets the mip_generator build the rest of the chain on the gpu (on the cpu while its pipeline compiles or if it failed) */
+    [[nodiscard]] texture_and_view create_texture_with_gpu_mips_and_view(const wgpu::Device& device,
+        const texture& texture,
+        mip_generator& mip_generator);
+
+#ifndef FAE_PLATFORM_WEB
+    /* blocks until all the work submitted to the device's queue so far has completed */
+    auto wait_for_submitted_work_sync(const wgpu::Instance& instance, const wgpu::Device& device) noexcept -> void;
+    /* copies one mip level of an rgba8 texture (needs the CopySrc usage) back into tightly packed cpu memory */
+    [[nodiscard]] auto read_texture_sync(const wgpu::Instance& instance,
+        const wgpu::Device& device,
+        const wgpu::Texture& texture,
+        std::uint32_t mip_level = 0) noexcept -> std::vector<std::uint8_t>;
+#endif
 }
@@ -2,7 +2,11 @@
 
 #include <array>
 #include <any>
+#include <chrono>
+#include <filesystem>
 #include <memory>
+#include <optional>
+#include <unordered_map>
 
 #include <webgpu/webgpu_cpp.h>
 
@@ -12,12 +16,26 @@
 #include "fae/math.hpp"
 #include "fae/windowing.hpp"
 
+#include "fae/asset_handle.hpp"
+#include "fae/rendering/dynamic_resolution.hpp"
+#include "fae/rendering/material.hpp"
 #include "fae/rendering/mesh.hpp"
 #include "fae/rendering/texture.hpp"
+#include "fae/rendering/vertex_format.hpp"
 #include "fae/rendering/render_pipeline.hpp"
 
+#include "frame_pacer.hpp"
+#include "frame_readback.hpp"
+#include "gpu_pass_timer.hpp"
+#include "pipeline_cache.hpp"
+#include "render_graph.hpp"
+#include "gpu_driven_renderer.hpp"
 #include "sdl_impl.hpp"
+#include "staging_belt.hpp"
 #include "string_utils.hpp"
+#include "texture_arrays.hpp"
+#include "texture_residency.hpp"
+#include "upscaler.hpp"
 #include "utils.hpp"
 
 namespace fae
@@ -30,44 +48,220 @@ namespace fae
         wgpu::Adapter adapter;
         wgpu::Device device;
         wgpu::Surface surface;
+        /* the surface's present mode, one the surface supports */
+        wgpu::PresentMode present_mode = wgpu::PresentMode::Fifo;
 
         wgpu::Color clear_color = { 0, 0, 0, 1 };
 
         wgpu::TextureFormat depth_texture_format = wgpu::TextureFormat::Depth24Plus;
 
+        /* what render passes draw into: the surface's current texture, or an offscreen texture when headless */
+        struct render_target
+        {
+            wgpu::TextureFormat format = wgpu::TextureFormat::Undefined;
+            std::uint32_t width = 0;
+            std::uint32_t height = 0;
+            /* null unless headless */
+            wgpu::Texture offscreen_texture;
+        };
+        render_target target{};
+
         struct render_pipeline
         {
             wgpu::ShaderModule shader_module;
-            wgpu::RenderPipeline render_pipeline;
-            wgpu::Texture depth_texture;
+            /* shared by every pipeline below: the pass' uniforms & lights (group 0), a material (group 1) & a draw's uniforms (group 2) */
+            wgpu::BindGroupLayout frame_bind_group_layout;
+            wgpu::BindGroupLayout material_bind_group_layout;
+            wgpu::BindGroupLayout object_bind_group_layout;
+            /* pipelines are indexed by the vertex_format of what they draw */
+            std::array<wgpu::RenderPipeline, vertex_format_count> render_pipeline;
+            /* vertex only, writes depth for the pre-pass (see render_settings::depth_prepass) */
+            std::array<wgpu::RenderPipeline, vertex_format_count> depth_prepass_render_pipeline;
+            /* render_pipeline with an Equal depth test & depth writes off, shades what the pre-pass left visible */
+            std::array<wgpu::RenderPipeline, vertex_format_count> depth_equal_render_pipeline;
             std::uint32_t uniform_stride;
+
+            /*
+            a material's bind group, baked the first time it is drawn & again only when its texture was evicted & uploaded anew
+            its parameters are written again whenever the material's differ
+            */
+            struct gpu_material
+            {
+                wgpu::Buffer uniform_buffer;
+                wgpu::BindGroup bind_group;
+                /* what bind_group was baked with */
+                wgpu::Texture texture;
+                /* what uniform_buffer holds */
+                std::optional<color> base_color;
+            };
+            std::unordered_map<asset_handle<material>, gpu_material> materials;
+            /* with texture arrays: one per array & base color, shared by every material whose texture is in the array */
+            std::unordered_map<std::uint64_t, gpu_material> array_materials;
         };
         std::vector<render_pipeline> render_pipelines;
+        /* what models without a material & materials without a diffuse texture are drawn with, added to the asset_manager on first use */
+        asset_handle<material> default_material{};
+        asset_handle<texture> white_texture{};
+        /* shared by every material */
+        wgpu::Sampler material_sampler;
+        /* render pipelines still being created asynchronously, passes of a pipeline draw nothing until it is ready */
+        std::size_t pipelines_compiling = 0;
 
         struct render_pass
         {
             std::size_t render_pipeline_id;
-            wgpu::CommandEncoder command_encoder;
-            wgpu::RenderPassEncoder render_pass_encoder;
 
             struct render_command
             {
-                std::vector<vertex> vertex_data;
-                std::vector<std::uint32_t> index_data;
+                /* drawn from mesh_buffers */
+                asset_handle<fae::mesh> mesh;
+                fae::vertex_format vertex_format = fae::vertex_format::standard;
                 std::vector<std::uint8_t> uniform_data;
-                wgpu::TextureView texture_view;
-                wgpu::Sampler sampler;
+                asset_handle<fae::material> material;
+                /* non zero when drawn from static_batch_buffers instead of mesh_buffers */
+                std::uint64_t static_batch_id = 0;
             };
             std::vector<render_command> render_commands;
+            /* the render commands' gpu resources, recorded when the graph executes (twice with a depth pre-pass) */
+            struct draw
+            {
+                wgpu::BindGroup material_bind_group;
+                /* into the pass' object bind group */
+                std::uint32_t uniform_offset;
+                wgpu::Buffer vertex_buffer;
+                fae::vertex_format vertex_format;
+                wgpu::Buffer index_buffer;
+                std::uint32_t count;
+            };
+            std::vector<draw> draws;
+            /* draws that bind a different material than the draw before */
+            std::size_t material_binds = 0;
+            /* bound once for all of the pass' draws */
+            wgpu::BindGroup frame_bind_group;
+            wgpu::BindGroup object_bind_group;
             std::string label;
+            /* a depth only pass runs first & this pass tests against its depth */
+            bool depth_prepass = false;
         };
+        /* passes begun this frame, cleared once the frame is submitted */
         std::vector<render_pass> render_passes;
+
+        /* every pass of the frame, executed & submitted once when the renderer ends the frame */
+        render_graph graph;
+        struct frame_state
+        {
+            bool begun = false;
+            std::chrono::steady_clock::time_point begin_time;
+            /* null when the surface had no texture to give, nothing is drawn then */
+            wgpu::TextureView target_view;
+            render_graph::resource_id target = 0;
+            /* what scene passes draw into: target, or a texture at the dynamic resolution's scale upscaled into target */
+            render_graph::resource_id scene_color = 0;
+            std::uint32_t scene_width = 0;
+            std::uint32_t scene_height = 0;
+            /* sized like scene_color */
+            render_graph::resource_id depth = 0;
+            /* written by the gpu driven culling pass, read by passes that draw its instances */
+            render_graph::resource_id gpu_driven_instances = 0;
+            /* the gpu driven renderer uploaded this frame's data, its passes record nothing otherwise */
+            bool gpu_driven_prepared = false;
+            /* the late culling phase's passes follow the first scene pass, depth is sampled to build the hi-z pyramid */
+            bool occlusion_culling = false;
+            bool gpu_driven_late_declared = false;
+        };
+        frame_state frame{};
+
+        /* the scale scenes are rendered at (see render_settings::dynamic_resolution) & what it was last fed */
+        dynamic_resolution resolution;
+        std::optional<std::uint64_t> resolution_measured_frame;
+        std::optional<std::chrono::steady_clock::time_point> previous_frame_begin;
+        fae::upscaler upscaler;
+
+        /* persistent light buffers, only rewritten when lighting_version changes */
+        wgpu::Buffer ambient_light_info_buffer;
+        wgpu::Buffer directional_light_info_buffer;
+        std::optional<std::uint64_t> uploaded_lighting_version;
+
+        texture_residency textures;
+        /* where material textures are packed with render_settings::texture_arrays, cleared when it is turned off */
+        fae::texture_arrays texture_arrays;
+        /* the frame's buffer & texture writes, copied by one command buffer submitted with the frame */
+        staging_belt uploads;
+        /* frames in flight & the per frame buffers (uniforms, vertices, indices) of each */
+        frame_pacer frames;
+        /* gpu copies of meshes, uploaded the first time a mesh is drawn & kept until it is unloaded */
+        struct gpu_mesh
+        {
+            wgpu::Buffer vertex_buffer;
+            /* null when the mesh has no indices */
+            wgpu::Buffer index_buffer;
+            /* indices, or vertices without them */
+            std::uint32_t count = 0;
+            /* the mesh::version the buffers were uploaded from */
+            std::uint64_t version = 0;
+        };
+        std::unordered_map<asset_handle<mesh>, gpu_mesh> mesh_buffers;
+        /* gpu copies of static batches (see static_batches) by batch id, uploaded again only when a batch's version changes */
+        struct gpu_static_batch
+        {
+            std::uint64_t version = 0;
+            wgpu::Buffer vertex_buffer;
+            wgpu::Buffer index_buffer;
+            std::uint32_t index_count = 0;
+            std::uint64_t last_used_frame = 0;
+        };
+        std::unordered_map<std::uint64_t, gpu_static_batch> static_batch_buffers;
+        /* frames a batch's buffers outlive its last draw */
+        static constexpr std::uint64_t static_batch_frames_kept = 3;
+        /* instanced models drawn with indirect draws after the render commands of each pass, culled on the gpu */
+        gpu_driven_renderer gpu_driven;
+
+        /* bytes written to the queue since the last submitted frame */
+        std::size_t frame_bytes_uploaded = 0;
+        std::uint64_t frames_submitted = 0;
+
+#ifndef FAE_PLATFORM_WEB
+        /* set when frames of the offscreen target are copied back to the cpu (see webgpu_plugin::read_back_frames) */
+        std::optional<frame_readback> readback;
+        /* gpu time of every render pass, when the device supports timestamp queries */
+        gpu_pass_timer pass_timer;
+        /* shared so its address stays stable for dawn's callbacks while webgpu is moved around, null when disabled */
+        std::shared_ptr<fae::pipeline_cache> pipeline_cache;
+#endif
     };
 
     struct webgpu_plugin
     {
         wgpu::RequestAdapterOptions adapter_options{};
         wgpu::DeviceDescriptor device_descriptor{};
+        /* gpu memory textures may occupy before the least recently used ones are evicted (0 disables eviction) */
+        std::size_t texture_memory_budget = 512 * 1024 * 1024;
+        /* generate texture mip chains with a compute pass instead of on the cpu (see mip_generator) */
+        bool generate_mips_on_gpu = false;
+        /* enable every block compression feature (bc, etc2, astc) the adapter supports so ktx2/dds textures upload without decoding */
+        bool request_texture_compression = true;
+        /* enable timestamp queries when the adapter supports them, to measure the gpu time of render passes (native only) */
+        bool request_timestamp_queries = true;
+        /*
+        how frames are presented: Fifo waits for vblank (no tearing, most latency), Mailbox replaces the queued frame with newer ones (no tearing, lower latency)
+        & Immediate presents right away (may tear, lowest latency). falls back to Fifo when the surface doesn't support it
+        */
+        wgpu::PresentMode present_mode = wgpu::PresentMode::Fifo;
+        /* frames the cpu may submit before waiting for the gpu to finish the oldest one, fewer lowers latency & more raises throughput */
+        std::uint32_t max_frames_in_flight = 2;
+        /* where dawn's compiled shaders & pipelines are cached across launches (native only), empty disables the cache */
+        std::filesystem::path pipeline_cache_directory = ".fae_cache/pipelines";
+
+        /*
+        render into an offscreen texture instead of a window's surface, no window is created
+        combine with adapter_options.forceFallbackAdapter (swiftshader) or backendType = Null to run without a gpu, e.g. in ci
+        */
+        bool headless = false;
+        std::uint32_t headless_width = 1280;
+        std::uint32_t headless_height = 720;
+        wgpu::TextureFormat headless_format = wgpu::TextureFormat::RGBA8Unorm;
+        /* copy every headless frame back to the cpu asynchronously (see webgpu::readback, native only) */
+        bool read_back_frames = false;
 
 #ifndef FAE_PLATFORM_WEB
         wgpu::LoggingCallback logging_callback = [](WGPULoggingType cType, WGPUStringView message, void* userdata)
@@ -8,6 +8,8 @@ namespace fae
 {
     auto application::step() -> void
     {
+        // async loads that finished since the last step are visible to every system of this one
+        assets.update();
         scheduler.invoke(pre_update_step{
             .global_entity = global_entity,
             .assets = assets,
@@ -143,6 +143,41 @@ namespace fae
                     auto clear_color = renderer.get_clear_color().to_array();
                     fae::ui::ColorEdit3("Clear Color", clear_color.data());
                     renderer.set_clear_color(fae::color::from_array(clear_color));
+                    step.global_entity.use_component<const fae::render_stats>([&](const fae::render_stats& stats)
+                        {
+                            fae::ui::Text("CPU encode: %.3f ms", stats.cpu_encode_time.seconds_f32() * 1000.f);
+                            fae::ui::Text("Bytes uploaded: %zu", stats.bytes_uploaded);
+                            auto load_progress = step.assets.progress();
+                            fae::ui::Text("Assets loaded: %zu/%zu (%zu failed)", load_progress.finished, load_progress.requested, load_progress.failed);
+                            fae::ui::Text("Textures resident: %zu (%.1f / %.1f MiB)", stats.textures_resident, stats.texture_bytes_resident / (1024.f * 1024.f), stats.texture_budget_bytes / (1024.f * 1024.f));
+                            fae::ui::Text("Texture arrays: %zu layers in %zu (%.1f MiB)", stats.texture_array_layers, stats.texture_arrays, stats.texture_array_bytes / (1024.f * 1024.f));
+                            fae::ui::Text("Draws: %zu, %zu material binds", stats.draws, stats.material_binds);
+                            fae::ui::Text("Render graph: %zu passes (%zu culled), %zu transient textures in %zu", stats.graph_passes, stats.graph_passes_culled, stats.graph_transient_textures, stats.graph_allocated_textures);
+                            fae::ui::Text("Staging: %zu bytes, %.1f MiB allocated (%.1f MiB peak)", stats.staging_bytes, stats.staging_bytes_allocated / (1024.f * 1024.f), stats.staging_bytes_high_water / (1024.f * 1024.f));
+                            fae::ui::Text("Frames in flight: %zu/%zu, latency %.2f ms, waited %.2f ms", stats.frames_in_flight, stats.max_frames_in_flight, stats.frame_latency.seconds_f32() * 1000.f, stats.frame_pacing_wait.seconds_f32() * 1000.f);
+                            fae::ui::Text("Resolution: %ux%u (%.0f%%)", stats.render_width, stats.render_height, stats.resolution_scale * 100.f);
+                            fae::ui::Text("GPU driven: %zu drawn, %zu frustum culled, %zu occluded", stats.gpu_driven_drawn, stats.gpu_driven_frustum_culled, stats.gpu_driven_occluded); });
+                    step.global_entity.use_component<const fae::gpu_frame_stats>([&](const fae::gpu_frame_stats& stats)
+                        {
+                            if (!stats.supported)
+                            {
+                                fae::ui::Text("GPU timings: no timestamp queries");
+                                return;
+                            }
+                            fae::ui::Text("GPU frame: %.3f ms (%llu frames late)", stats.total.seconds_f32() * 1000.f, static_cast<unsigned long long>(stats.frames_late));
+                            for (const auto& pass_time : stats.passes)
+                            {
+                                fae::ui::Text("GPU %s: %.3f ms", pass_time.label.c_str(), pass_time.time.seconds_f32() * 1000.f);
+                            } });
+                    step.global_entity.use_component<const fae::static_batches>([&](const fae::static_batches& static_batches)
+                        { fae::ui::Text("Static batches: %zu (%zu merged this frame)", static_batches.batches.size(), static_batches.merges); });
+                    step.global_entity.use_component<fae::render_settings>([&](fae::render_settings& settings)
+                        {
+                            fae::ui::Checkbox("Depth pre-pass", &settings.depth_prepass);
+                            fae::ui::Checkbox("Occlusion culling", &settings.occlusion_culling);
+                            fae::ui::Checkbox("Texture arrays", &settings.texture_arrays);
+                            fae::ui::Checkbox("Dynamic resolution", &settings.dynamic_resolution.enabled);
+                            fae::ui::SliderFloat("Frame budget (ms)", &settings.dynamic_resolution.target_frame_ms, 4.f, 50.f); });
                 }
             });
         fae::ui::End();
@@ -52,10 +52,9 @@ namespace fae
 
         auto wgpu_init_info = ImGui_ImplWGPU_InitInfo{};
         wgpu_init_info.Device = webgpu.device.Get();
-        auto capabilities = wgpu::SurfaceCapabilities{};
-        webgpu.surface.GetCapabilities(webgpu.adapter, &capabilities);
-        wgpu_init_info.RenderTargetFormat = static_cast<WGPUTextureFormat>(capabilities.formats[0]);
-        wgpu_init_info.DepthStencilFormat = static_cast<WGPUTextureFormat>(webgpu.depth_texture_format);
+        // drawn in its own pass over the scene, without depth
+        wgpu_init_info.RenderTargetFormat = static_cast<WGPUTextureFormat>(webgpu.target.format);
+        wgpu_init_info.DepthStencilFormat = WGPUTextureFormat_Undefined;
         ImGui_ImplWGPU_Init(&wgpu_init_info);
     }
 
@@ -72,13 +71,19 @@ namespace fae
         ImGui::Render();
         step.global_entity.use_component<fae::webgpu>([&](fae::webgpu& webgpu)
             {
-                for (auto &render_pass : webgpu.render_passes)
+                if (!webgpu.frame.begun || !webgpu.frame.target_view)
                 {
-                    if (render_pass.label == "fae_ui_render_pass")
-                    {
-                        ImGui_ImplWGPU_RenderDrawData(ImGui::GetDrawData(), render_pass.render_pass_encoder.Get());
-                    }
-                } });
+                    return;
+                }
+                // declared after the scene's passes & loads the target, so the ui is drawn over them
+                webgpu.graph.add_pass(render_graph::pass{
+                    .name = "fae_ui_render_pass",
+                    .color_attachments = {
+                        render_graph::color_attachment{ .texture = webgpu.frame.target, .load_op = wgpu::LoadOp::Load },
+                    },
+                    .record_render_pass = [](const wgpu::RenderPassEncoder& render_pass_encoder)
+                    { ImGui_ImplWGPU_RenderDrawData(ImGui::GetDrawData(), render_pass_encoder.Get()); },
+                }); });
     }
 
     auto deinit_imgui(const deinit_step& step) noexcept -> void
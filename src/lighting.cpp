@@ -1,40 +1,80 @@
 #include "fae/lighting.hpp"
 
+#include <algorithm>
+
 #include "fae/application/application.hpp"
 
 namespace fae
 {
+    namespace
+    {
+        template <typename t_value>
+        auto assign_if_changed(t_value& destination, const t_value& value) noexcept -> bool
+        {
+            if (destination == value)
+            {
+                return false;
+            }
+            destination = value;
+            return true;
+        }
+
+        /* zeroes the slots left over from a previous frame so stale lights never leak into the uniform buffer */
+        template <std::size_t t_size>
+        auto clear_from(std::array<math::vec4, t_size>& values, std::uint32_t from, std::uint32_t to) noexcept -> void
+        {
+            if (from < to)
+            {
+                std::fill(values.begin() + from, values.begin() + to, math::vec4{ 0.f, 0.f, 0.f, 0.f });
+            }
+        }
+    }
+
     auto lighting_plugin::init(application& app) const noexcept -> void
     {
         app
             .set_global_component(ambient_light_info{})
             .set_global_component(directional_light_info{})
+            .set_global_component(lighting_version{})
             .add_system<update_step>(update_lighting);
     }
 
     auto update_lighting(const update_step& step) noexcept -> void
     {
+        auto changed = false;
+
         step.global_entity.use_component<ambient_light_info>([&](ambient_light_info& info)
             {
-                info.clear();
-                auto i = 0;
+                std::uint32_t i = 0;
                 for (auto& [entity, ambient_light] : step.ecs_world.query<const ambient_light>())
                 {
-                    info.lights.colors[i] = ambient_light.color.to_vec4();
+                    if (i >= max_lights)
+                        break;
+                    changed |= assign_if_changed(info.lights.colors[i], ambient_light.color.to_vec4());
                     i++;
                 }
-                info.lights.count = i; });
+                clear_from(info.lights.colors, i, info.lights.count);
+                changed |= assign_if_changed(info.lights.count, i); });
 
         step.global_entity.use_component<directional_light_info>([&](directional_light_info& info)
             {
-                info.clear();
-                auto i = 0;
+                std::uint32_t i = 0;
                 for (auto& [entity, directional_light] : step.ecs_world.query<const directional_light>())
                 {
-                    info.directions[i] = { directional_light.direction, 0.f };
-                    info.lights.colors[i] = directional_light.color.to_vec4();
+                    if (i >= max_lights)
+                        break;
+                    changed |= assign_if_changed(info.directions[i], math::vec4{ directional_light.direction, 0.f });
+                    changed |= assign_if_changed(info.lights.colors[i], directional_light.color.to_vec4());
                     i++;
                 }
-                info.lights.count = i; });
+                clear_from(info.directions, i, info.lights.count);
+                clear_from(info.lights.colors, i, info.lights.count);
+                changed |= assign_if_changed(info.lights.count, i); });
+
+        if (changed)
+        {
+            step.global_entity.use_component<lighting_version>([&](lighting_version& version)
+                { version.value++; });
+        }
     }
 }
@@ -0,0 +1,153 @@
+#include "fae/mapped_file.hpp"
+
+#include <fstream>
+#include <utility>
+
+#if defined(FAE_PLATFORM_WINDOWS)
+#include <Windows.h>
+#elif !defined(FAE_PLATFORM_WEB)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fae
+{
+    mapped_file::mapped_file(mapped_file&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    auto mapped_file::operator=(mapped_file&& other) noexcept -> mapped_file&
+    {
+        if (this != &other)
+        {
+            close();
+            // a read file's bytes move with the vector, its data pointer stays valid
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+            m_read = std::move(other.m_read);
+#ifdef FAE_PLATFORM_WINDOWS
+            m_file = std::exchange(other.m_file, nullptr);
+            m_mapping = std::exchange(other.m_mapping, nullptr);
+#endif
+        }
+        return *this;
+    }
+
+    mapped_file::~mapped_file()
+    {
+        close();
+    }
+
+    auto mapped_file::open(const std::filesystem::path& path) noexcept -> std::optional<mapped_file>
+    {
+        auto file = mapped_file{};
+#if defined(FAE_PLATFORM_WEB)
+        auto stream = std::ifstream(path, std::ios::binary);
+        auto error = std::error_code{};
+        auto size = std::filesystem::file_size(path, error);
+        if (!stream.is_open() || error)
+        {
+            return std::nullopt;
+        }
+        file.m_read.resize(size);
+        if (!stream.read(reinterpret_cast<char*>(file.m_read.data()), static_cast<std::streamsize>(size)))
+        {
+            return std::nullopt;
+        }
+        file.m_data = file.m_read.data();
+        file.m_size = size;
+#elif defined(FAE_PLATFORM_WINDOWS)
+        file.m_file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file.m_file == INVALID_HANDLE_VALUE)
+        {
+            file.m_file = nullptr;
+            return std::nullopt;
+        }
+        auto size = LARGE_INTEGER{};
+        if (!GetFileSizeEx(file.m_file, &size))
+        {
+            return std::nullopt;
+        }
+        // empty files can't be mapped, they are empty views
+        if (size.QuadPart == 0)
+        {
+            return file;
+        }
+        file.m_mapping = CreateFileMappingW(file.m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!file.m_mapping)
+        {
+            return std::nullopt;
+        }
+        file.m_data = static_cast<const std::uint8_t*>(MapViewOfFile(file.m_mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!file.m_data)
+        {
+            return std::nullopt;
+        }
+        file.m_size = static_cast<std::size_t>(size.QuadPart);
+#else
+        auto descriptor = ::open(path.c_str(), O_RDONLY);
+        if (descriptor < 0)
+        {
+            return std::nullopt;
+        }
+        struct stat status{};
+        if (fstat(descriptor, &status) != 0)
+        {
+            ::close(descriptor);
+            return std::nullopt;
+        }
+        // empty files can't be mapped, they are empty views
+        if (status.st_size == 0)
+        {
+            ::close(descriptor);
+            return file;
+        }
+        auto* data = mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+        // the mapping keeps the file alive
+        ::close(descriptor);
+        if (data == MAP_FAILED)
+        {
+            return std::nullopt;
+        }
+        file.m_data = static_cast<const std::uint8_t*>(data);
+        file.m_size = static_cast<std::size_t>(status.st_size);
+#endif
+        return file;
+    }
+
+    auto mapped_file::bytes() const noexcept -> std::span<const std::uint8_t>
+    {
+        return { m_data, m_size };
+    }
+
+    auto mapped_file::close() noexcept -> void
+    {
+#if defined(FAE_PLATFORM_WINDOWS)
+        if (m_data)
+        {
+            UnmapViewOfFile(m_data);
+        }
+        if (m_mapping)
+        {
+            CloseHandle(m_mapping);
+        }
+        if (m_file)
+        {
+            CloseHandle(m_file);
+        }
+        m_mapping = nullptr;
+        m_file = nullptr;
+#elif !defined(FAE_PLATFORM_WEB)
+        if (m_data)
+        {
+            munmap(const_cast<std::uint8_t*>(m_data), m_size);
+        }
+#endif
+        m_data = nullptr;
+        m_size = 0;
+        m_read.clear();
+    }
+}
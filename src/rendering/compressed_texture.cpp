@@ -0,0 +1,512 @@
+#include "fae/rendering/compressed_texture.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <string>
+
+#include "fae/logging.hpp"
+
+namespace fae
+{
+    namespace
+    {
+        constexpr std::size_t block_dimension = 4;
+
+        template <typename t_value>
+        auto read(std::span<const std::uint8_t> bytes, std::size_t offset) noexcept -> t_value
+        {
+            auto value = t_value{};
+            std::memcpy(&value, bytes.data() + offset, sizeof(t_value));
+            return value;
+        }
+
+        auto blocks_along(std::size_t texels) noexcept -> std::size_t
+        {
+            return std::max<std::size_t>(1, (texels + block_dimension - 1) / block_dimension);
+        }
+
+        /* fills levels (tightly packed from offset 0) and checks that the payload is large enough */
+        auto layout_levels(compressed_texture& texture, std::size_t width, std::size_t height, std::size_t level_count) -> bool
+        {
+            auto offset = std::size_t{ 0 };
+            for (std::size_t level = 0; level < level_count; ++level)
+            {
+                texture.levels.push_back(mip_level{ .width = width, .height = height, .offset = offset });
+                offset += compressed_level_size_in_bytes(texture.compression, width, height);
+                if (width == 1 && height == 1)
+                {
+                    break;
+                }
+                width = std::max<std::size_t>(1, width / 2);
+                height = std::max<std::size_t>(1, height / 2);
+            }
+            return offset <= texture.data.size();
+        }
+
+        auto from_vk_format(std::uint32_t vk_format) noexcept -> std::optional<std::pair<texture_compression, bool>>
+        {
+            switch (vk_format)
+            {
+            case 131: // VK_FORMAT_BC1_RGB_UNORM_BLOCK
+            case 133: // VK_FORMAT_BC1_RGBA_UNORM_BLOCK
+                return std::pair{ texture_compression::bc1, false };
+            case 132:
+            case 134:
+                return std::pair{ texture_compression::bc1, true };
+            case 135:
+                return std::pair{ texture_compression::bc2, false };
+            case 136:
+                return std::pair{ texture_compression::bc2, true };
+            case 137:
+                return std::pair{ texture_compression::bc3, false };
+            case 138:
+                return std::pair{ texture_compression::bc3, true };
+            case 139:
+                return std::pair{ texture_compression::bc4, false };
+            case 141:
+                return std::pair{ texture_compression::bc5, false };
+            case 145:
+                return std::pair{ texture_compression::bc7, false };
+            case 146:
+                return std::pair{ texture_compression::bc7, true };
+            case 147: // VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK
+                return std::pair{ texture_compression::etc2_rgb8, false };
+            case 148:
+                return std::pair{ texture_compression::etc2_rgb8, true };
+            case 149:
+                return std::pair{ texture_compression::etc2_rgb8a1, false };
+            case 150:
+                return std::pair{ texture_compression::etc2_rgb8a1, true };
+            case 151:
+                return std::pair{ texture_compression::etc2_rgba8, false };
+            case 152:
+                return std::pair{ texture_compression::etc2_rgba8, true };
+            case 157: // VK_FORMAT_ASTC_4x4_UNORM_BLOCK
+                return std::pair{ texture_compression::astc_4x4, false };
+            case 158:
+                return std::pair{ texture_compression::astc_4x4, true };
+            default:
+                return std::nullopt;
+            }
+        }
+
+        auto from_dxgi_format(std::uint32_t dxgi_format) noexcept -> std::optional<std::pair<texture_compression, bool>>
+        {
+            switch (dxgi_format)
+            {
+            case 71: // DXGI_FORMAT_BC1_UNORM
+                return std::pair{ texture_compression::bc1, false };
+            case 72:
+                return std::pair{ texture_compression::bc1, true };
+            case 74:
+                return std::pair{ texture_compression::bc2, false };
+            case 75:
+                return std::pair{ texture_compression::bc2, true };
+            case 77:
+                return std::pair{ texture_compression::bc3, false };
+            case 78:
+                return std::pair{ texture_compression::bc3, true };
+            case 80:
+                return std::pair{ texture_compression::bc4, false };
+            case 83:
+                return std::pair{ texture_compression::bc5, false };
+            case 98:
+                return std::pair{ texture_compression::bc7, false };
+            case 99:
+                return std::pair{ texture_compression::bc7, true };
+            default:
+                return std::nullopt;
+            }
+        }
+
+        constexpr auto four_cc(const char (&code)[5]) noexcept -> std::uint32_t
+        {
+            return static_cast<std::uint32_t>(code[0]) | static_cast<std::uint32_t>(code[1]) << 8 | static_cast<std::uint32_t>(code[2]) << 16 | static_cast<std::uint32_t>(code[3]) << 24;
+        }
+
+        using rgba = std::array<std::uint8_t, 4>;
+
+        auto expand_565(std::uint16_t packed) noexcept -> rgba
+        {
+            auto r = static_cast<std::uint8_t>((packed >> 11) & 0x1f);
+            auto g = static_cast<std::uint8_t>((packed >> 5) & 0x3f);
+            auto b = static_cast<std::uint8_t>(packed & 0x1f);
+            return {
+                static_cast<std::uint8_t>(r << 3 | r >> 2),
+                static_cast<std::uint8_t>(g << 2 | g >> 4),
+                static_cast<std::uint8_t>(b << 3 | b >> 2),
+                255,
+            };
+        }
+
+        /* the colour half of bc1 to bc3. bc2 & bc3 always use the 4 colour mode */
+        auto decode_color_block(const std::uint8_t* block, bool allow_punch_through, std::array<rgba, 16>& texels) noexcept -> void
+        {
+            auto c0 = read<std::uint16_t>({ block, 8 }, 0);
+            auto c1 = read<std::uint16_t>({ block, 8 }, 2);
+            auto indices = read<std::uint32_t>({ block, 8 }, 4);
+
+            auto palette = std::array<rgba, 4>{ expand_565(c0), expand_565(c1) };
+            for (std::size_t channel = 0; channel < 3; ++channel)
+            {
+                auto a = palette[0][channel];
+                auto b = palette[1][channel];
+                if (c0 > c1 || !allow_punch_through)
+                {
+                    palette[2][channel] = static_cast<std::uint8_t>((2 * a + b + 1) / 3);
+                    palette[3][channel] = static_cast<std::uint8_t>((a + 2 * b + 1) / 3);
+                }
+                else
+                {
+                    palette[2][channel] = static_cast<std::uint8_t>((a + b + 1) / 2);
+                    palette[3][channel] = 0;
+                }
+            }
+            palette[2][3] = 255;
+            palette[3][3] = c0 > c1 || !allow_punch_through ? 255 : 0;
+
+            for (std::size_t i = 0; i < 16; ++i)
+            {
+                texels[i] = palette[(indices >> (2 * i)) & 0x3];
+            }
+        }
+
+        /* the 8 byte single channel block of bc3 (alpha), bc4 & bc5 */
+        auto decode_channel_block(const std::uint8_t* block, std::array<rgba, 16>& texels, std::size_t channel) noexcept -> void
+        {
+            auto v0 = static_cast<std::uint32_t>(block[0]);
+            auto v1 = static_cast<std::uint32_t>(block[1]);
+            auto values = std::array<std::uint8_t, 8>{ static_cast<std::uint8_t>(v0), static_cast<std::uint8_t>(v1) };
+            if (v0 > v1)
+            {
+                for (std::uint32_t i = 1; i < 7; ++i)
+                {
+                    values[i + 1] = static_cast<std::uint8_t>(((7 - i) * v0 + i * v1 + 3) / 7);
+                }
+            }
+            else
+            {
+                for (std::uint32_t i = 1; i < 5; ++i)
+                {
+                    values[i + 1] = static_cast<std::uint8_t>(((5 - i) * v0 + i * v1 + 2) / 5);
+                }
+                values[6] = 0;
+                values[7] = 255;
+            }
+
+            auto indices = std::uint64_t{ 0 };
+            std::memcpy(&indices, block + 2, 6);
+            for (std::size_t i = 0; i < 16; ++i)
+            {
+                texels[i][channel] = values[(indices >> (3 * i)) & 0x7];
+            }
+        }
+
+        auto decode_block(texture_compression compression, const std::uint8_t* block, std::array<rgba, 16>& texels) noexcept -> void
+        {
+            switch (compression)
+            {
+            case texture_compression::bc1:
+                decode_color_block(block, true, texels);
+                break;
+            case texture_compression::bc2:
+                decode_color_block(block + 8, false, texels);
+                for (std::size_t i = 0; i < 16; ++i)
+                {
+                    auto alpha = static_cast<std::uint8_t>((block[i / 2] >> (4 * (i % 2))) & 0xf);
+                    texels[i][3] = static_cast<std::uint8_t>(alpha * 17);
+                }
+                break;
+            case texture_compression::bc3:
+                decode_color_block(block + 8, false, texels);
+                decode_channel_block(block, texels, 3);
+                break;
+            case texture_compression::bc4:
+                texels.fill({ 0, 0, 0, 255 });
+                decode_channel_block(block, texels, 0);
+                break;
+            case texture_compression::bc5:
+                texels.fill({ 0, 0, 0, 255 });
+                decode_channel_block(block, texels, 0);
+                decode_channel_block(block + 8, texels, 1);
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    auto block_size_in_bytes(texture_compression compression) noexcept -> std::size_t
+    {
+        switch (compression)
+        {
+        case texture_compression::bc1:
+        case texture_compression::bc4:
+        case texture_compression::etc2_rgb8:
+        case texture_compression::etc2_rgb8a1:
+            return 8;
+        default:
+            return 16;
+        }
+    }
+
+    auto compressed_level_size_in_bytes(texture_compression compression, std::size_t width, std::size_t height) noexcept -> std::size_t
+    {
+        return blocks_along(width) * blocks_along(height) * block_size_in_bytes(compression);
+    }
+
+    auto has_cpu_decoder(texture_compression compression) noexcept -> bool
+    {
+        switch (compression)
+        {
+        case texture_compression::bc1:
+        case texture_compression::bc2:
+        case texture_compression::bc3:
+        case texture_compression::bc4:
+        case texture_compression::bc5:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    auto compressed_texture::level_data(std::size_t level) const noexcept -> std::span<const std::uint8_t>
+    {
+        const auto& mip = levels[level];
+        return std::span(data).subspan(mip.offset, compressed_level_size_in_bytes(compression, mip.width, mip.height));
+    }
+
+    auto compressed_texture::load(const std::filesystem::path& path) -> std::optional<compressed_texture>
+    {
+        auto file = std::ifstream(path, std::ios::binary);
+        if (!file.is_open())
+        {
+            fae::log_error(std::format("Failed to open compressed texture {}", path.string()));
+            return std::nullopt;
+        }
+        auto bytes = std::vector<std::uint8_t>(std::filesystem::file_size(path));
+        file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+
+        auto extension = path.extension().string();
+        std::ranges::transform(extension, extension.begin(), [](unsigned char c)
+            { return static_cast<char>(std::tolower(c)); });
+        auto maybe_texture = extension == ".dds" ? parse_dds(bytes) : parse_ktx2(bytes);
+        if (!maybe_texture)
+        {
+            fae::log_error(std::format("Failed to load compressed texture {}", path.string()));
+        }
+        return maybe_texture;
+    }
+
+    auto compressed_texture::parse_ktx2(std::span<const std::uint8_t> file) -> std::optional<compressed_texture>
+    {
+        constexpr auto identifier = std::array<std::uint8_t, 12>{ 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+        constexpr std::size_t header_size = 80;
+        constexpr std::size_t level_index_entry_size = 24;
+        if (file.size() < header_size || !std::equal(identifier.begin(), identifier.end(), file.begin()))
+        {
+            fae::log_error("not a ktx2 file");
+            return std::nullopt;
+        }
+
+        auto vk_format = read<std::uint32_t>(file, 12);
+        auto width = read<std::uint32_t>(file, 20);
+        auto height = read<std::uint32_t>(file, 24);
+        auto depth = read<std::uint32_t>(file, 28);
+        auto layer_count = read<std::uint32_t>(file, 32);
+        auto face_count = read<std::uint32_t>(file, 36);
+        auto level_count = std::max(read<std::uint32_t>(file, 40), 1u);
+        auto supercompression_scheme = read<std::uint32_t>(file, 44);
+
+        auto format = from_vk_format(vk_format);
+        if (!format)
+        {
+            fae::log_error(std::format("unsupported ktx2 vkFormat {}", vk_format));
+            return std::nullopt;
+        }
+        if (supercompression_scheme != 0)
+        {
+            fae::log_error(std::format("unsupported ktx2 supercompression scheme {} (basis universal & zstd payloads must be transcoded offline)", supercompression_scheme));
+            return std::nullopt;
+        }
+        if (width == 0 || height == 0 || depth > 1 || layer_count > 1 || face_count != 1)
+        {
+            fae::log_error("only single 2d ktx2 textures are supported");
+            return std::nullopt;
+        }
+        if (level_count > (file.size() - header_size) / level_index_entry_size)
+        {
+            fae::log_error("truncated ktx2 level index");
+            return std::nullopt;
+        }
+
+        auto texture = compressed_texture{ .compression = format->first, .srgb = format->second };
+        // ktx2 stores levels smallest first with padding in between, repack them largest first
+        auto level_width = std::size_t{ width };
+        auto level_height = std::size_t{ height };
+        for (std::uint32_t level = 0; level < level_count; ++level)
+        {
+            auto entry = header_size + level * level_index_entry_size;
+            auto byte_offset = read<std::uint64_t>(file, entry);
+            auto byte_length = read<std::uint64_t>(file, entry + 8);
+            auto expected_length = compressed_level_size_in_bytes(texture.compression, level_width, level_height);
+            // the offset comes from the file, compared without adding to it so a huge one can't wrap around
+            if (byte_length < expected_length || byte_offset > file.size() || expected_length > file.size() - byte_offset)
+            {
+                fae::log_error(std::format("ktx2 level {} is truncated", level));
+                return std::nullopt;
+            }
+            texture.levels.push_back(mip_level{ .width = level_width, .height = level_height, .offset = texture.data.size() });
+            texture.data.insert(texture.data.end(), file.begin() + byte_offset, file.begin() + byte_offset + expected_length);
+            if (level_width == 1 && level_height == 1)
+            {
+                break;
+            }
+            level_width = std::max<std::size_t>(1, level_width / 2);
+            level_height = std::max<std::size_t>(1, level_height / 2);
+        }
+        return texture;
+    }
+
+    auto compressed_texture::parse_dds(std::span<const std::uint8_t> file) -> std::optional<compressed_texture>
+    {
+        constexpr std::size_t magic_size = 4;
+        constexpr std::size_t header_size = 124;
+        constexpr std::size_t dx10_header_size = 20;
+        if (file.size() < magic_size + header_size || read<std::uint32_t>(file, 0) != four_cc("DDS "))
+        {
+            fae::log_error("not a dds file");
+            return std::nullopt;
+        }
+
+        auto height = read<std::uint32_t>(file, magic_size + 8);
+        auto width = read<std::uint32_t>(file, magic_size + 12);
+        auto level_count = std::max(read<std::uint32_t>(file, magic_size + 24), 1u);
+        auto pixel_format_four_cc = read<std::uint32_t>(file, magic_size + 80);
+        auto data_offset = magic_size + header_size;
+
+        auto format = std::optional<std::pair<texture_compression, bool>>{};
+        if (pixel_format_four_cc == four_cc("DX10"))
+        {
+            if (file.size() < data_offset + dx10_header_size)
+            {
+                fae::log_error("truncated dds dx10 header");
+                return std::nullopt;
+            }
+            auto dxgi_format = read<std::uint32_t>(file, data_offset);
+            auto array_size = read<std::uint32_t>(file, data_offset + 12);
+            if (array_size > 1)
+            {
+                fae::log_error("dds texture arrays are not supported");
+                return std::nullopt;
+            }
+            format = from_dxgi_format(dxgi_format);
+            data_offset += dx10_header_size;
+        }
+        else if (pixel_format_four_cc == four_cc("DXT1"))
+        {
+            format = std::pair{ texture_compression::bc1, false };
+        }
+        else if (pixel_format_four_cc == four_cc("DXT2") || pixel_format_four_cc == four_cc("DXT3"))
+        {
+            format = std::pair{ texture_compression::bc2, false };
+        }
+        else if (pixel_format_four_cc == four_cc("DXT4") || pixel_format_four_cc == four_cc("DXT5"))
+        {
+            format = std::pair{ texture_compression::bc3, false };
+        }
+        else if (pixel_format_four_cc == four_cc("ATI1") || pixel_format_four_cc == four_cc("BC4U"))
+        {
+            format = std::pair{ texture_compression::bc4, false };
+        }
+        else if (pixel_format_four_cc == four_cc("ATI2") || pixel_format_four_cc == four_cc("BC5U"))
+        {
+            format = std::pair{ texture_compression::bc5, false };
+        }
+        if (!format)
+        {
+            fae::log_error("unsupported dds pixel format (only bc1-5 & bc7 are supported)");
+            return std::nullopt;
+        }
+        if (width == 0 || height == 0)
+        {
+            fae::log_error("dds texture has no texels");
+            return std::nullopt;
+        }
+
+        auto texture = compressed_texture{
+            .compression = format->first,
+            .srgb = format->second,
+            .data = std::vector<std::uint8_t>(file.begin() + data_offset, file.end()),
+        };
+        if (!layout_levels(texture, width, height, level_count))
+        {
+            fae::log_error("dds mip levels are truncated");
+            return std::nullopt;
+        }
+        auto used_size = texture.levels.back().offset + compressed_level_size_in_bytes(texture.compression, texture.levels.back().width, texture.levels.back().height);
+        texture.data.resize(used_size);
+        return texture;
+    }
+
+    auto is_compressed_texture_path(const std::filesystem::path& path) noexcept -> bool
+    {
+        auto extension = path.extension().string();
+        std::ranges::transform(extension, extension.begin(), [](unsigned char c)
+            { return static_cast<char>(std::tolower(c)); });
+        return extension == ".ktx2" || extension == ".dds";
+    }
+
+    auto decompress_level(const compressed_texture& texture, std::size_t level) -> std::optional<std::vector<std::uint8_t>>
+    {
+        if (!has_cpu_decoder(texture.compression))
+        {
+            return std::nullopt;
+        }
+
+        const auto& mip = texture.levels[level];
+        auto blocks = texture.level_data(level);
+        auto block_size = block_size_in_bytes(texture.compression);
+        auto blocks_wide = blocks_along(mip.width);
+        auto blocks_high = blocks_along(mip.height);
+        auto pixels = std::vector<std::uint8_t>(mip.width * mip.height * 4);
+        auto texels = std::array<rgba, 16>{};
+        for (std::size_t block_y = 0; block_y < blocks_high; ++block_y)
+        {
+            for (std::size_t block_x = 0; block_x < blocks_wide; ++block_x)
+            {
+                decode_block(texture.compression, blocks.data() + (block_y * blocks_wide + block_x) * block_size, texels);
+                // blocks hanging over the edge of levels that aren't a multiple of 4 are clipped
+                auto x_end = std::min(block_dimension, mip.width - block_x * block_dimension);
+                auto y_end = std::min(block_dimension, mip.height - block_y * block_dimension);
+                for (std::size_t y = 0; y < y_end; ++y)
+                {
+                    auto row = (block_y * block_dimension + y) * mip.width + block_x * block_dimension;
+                    std::memcpy(pixels.data() + row * 4, texels.data() + y * block_dimension, x_end * 4);
+                }
+            }
+        }
+        return pixels;
+    }
+
+    auto decompress(const compressed_texture& texture) -> std::optional<mip_chain>
+    {
+        if (!has_cpu_decoder(texture.compression))
+        {
+            return std::nullopt;
+        }
+
+        auto chain = mip_chain{};
+        for (std::size_t level = 0; level < texture.levels.size(); ++level)
+        {
+            auto pixels = *decompress_level(texture, level);
+            chain.levels.push_back(mip_level{ .width = texture.levels[level].width, .height = texture.levels[level].height, .offset = chain.data.size() });
+            chain.data.insert(chain.data.end(), pixels.begin(), pixels.end());
+        }
+        return chain;
+    }
+}
@@ -0,0 +1,185 @@
+#include "fae/rendering/cooked_mesh.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <type_traits>
+
+#include "fae/logging.hpp"
+#include "fae/mapped_file.hpp"
+
+namespace fae
+{
+    static_assert(std::is_trivially_copyable_v<vertex> && std::is_trivially_copyable_v<meshlet>, "cooked meshes store vertices & meshlets as raw bytes");
+    static_assert(std::is_trivially_copyable_v<cooked_mesh_header>);
+
+    namespace
+    {
+        constexpr auto align_up(std::uint64_t offset) noexcept -> std::uint64_t
+        {
+            return (offset + cooked_mesh_header::blob_alignment - 1) / cooked_mesh_header::blob_alignment * cooked_mesh_header::blob_alignment;
+        }
+
+        /* whether [offset, offset + count * size) lies within a file of file_size bytes */
+        constexpr auto blob_fits(std::uint64_t offset, std::uint64_t count, std::uint64_t size, std::uint64_t file_size) noexcept -> bool
+        {
+            return offset % cooked_mesh_header::blob_alignment == 0 && offset <= file_size && count <= (file_size - offset) / size;
+        }
+    }
+
+    auto cooked_mesh_view::parse(std::span<const std::uint8_t> bytes) noexcept -> std::optional<cooked_mesh_view>
+    {
+        auto header = cooked_mesh_header{};
+        if (bytes.size() < sizeof(cooked_mesh_header))
+        {
+            fae::log_error("cooked mesh is smaller than its header");
+            return std::nullopt;
+        }
+        std::memcpy(&header, bytes.data(), sizeof(cooked_mesh_header));
+        if (header.magic != cooked_mesh_header::expected_magic)
+        {
+            fae::log_error("not a cooked mesh");
+            return std::nullopt;
+        }
+        if (header.version != cooked_mesh_header::current_version || header.vertex_size != sizeof(vertex) || header.meshlet_size != sizeof(meshlet))
+        {
+            fae::log_error(std::format("cooked mesh version {} (vertex {} bytes, meshlet {} bytes) doesn't match version {} ({} bytes, {} bytes), cook it again",
+                header.version, header.vertex_size, header.meshlet_size, cooked_mesh_header::current_version, sizeof(vertex), sizeof(meshlet)));
+            return std::nullopt;
+        }
+        if (!blob_fits(header.vertices_offset, header.vertex_count, sizeof(vertex), bytes.size()) ||
+            !blob_fits(header.indices_offset, header.index_count, sizeof(std::uint32_t), bytes.size()) ||
+            !blob_fits(header.meshlets_offset, header.meshlet_count, sizeof(meshlet), bytes.size()))
+        {
+            fae::log_error("cooked mesh is truncated");
+            return std::nullopt;
+        }
+        // the format picks a pipeline from an array of vertex_format_count
+        if (header.format >= vertex_format_count)
+        {
+            fae::log_error(std::format("cooked mesh has an unknown vertex format {}", header.format));
+            return std::nullopt;
+        }
+        auto view = cooked_mesh_view{
+            .header = header,
+            .vertices = { reinterpret_cast<const vertex*>(bytes.data() + header.vertices_offset), header.vertex_count },
+            .indices = { reinterpret_cast<const std::uint32_t*>(bytes.data() + header.indices_offset), header.index_count },
+            .meshlets = { reinterpret_cast<const meshlet*>(bytes.data() + header.meshlets_offset), header.meshlet_count },
+        };
+        // indices & meshlet ranges are used without checks (build_meshlets, gpu_driven_renderer::add_model), they must stay in range
+        if (std::ranges::any_of(view.indices, [&](std::uint32_t index)
+                { return index >= header.vertex_count; }))
+        {
+            fae::log_error("cooked mesh has an index past its vertices");
+            return std::nullopt;
+        }
+        if (std::ranges::any_of(view.meshlets, [&](const meshlet& meshlet)
+                { return meshlet.first_index > header.index_count || meshlet.index_count > header.index_count - meshlet.first_index; }))
+        {
+            fae::log_error("cooked mesh has a meshlet past its indices");
+            return std::nullopt;
+        }
+        return view;
+    }
+
+    auto cooked_mesh_view::bounds_min() const noexcept -> vec3
+    {
+        return { header.bounds_min[0], header.bounds_min[1], header.bounds_min[2] };
+    }
+
+    auto cooked_mesh_view::bounds_max() const noexcept -> vec3
+    {
+        return { header.bounds_max[0], header.bounds_max[1], header.bounds_max[2] };
+    }
+
+    auto cooked_mesh_view::to_mesh() const -> mesh
+    {
+        return mesh{
+            .vertices = std::vector<vertex>(vertices.begin(), vertices.end()),
+            .indices = std::vector<std::uint32_t>(indices.begin(), indices.end()),
+            .format = static_cast<vertex_format>(header.format),
+            .meshlets = std::vector<meshlet>(meshlets.begin(), meshlets.end()),
+        };
+    }
+
+    auto cook_mesh(const mesh& mesh) -> std::vector<std::uint8_t>
+    {
+        auto header = cooked_mesh_header{
+            .format = static_cast<std::uint32_t>(mesh.format),
+            .vertex_count = static_cast<std::uint32_t>(mesh.vertices.size()),
+            .index_count = static_cast<std::uint32_t>(mesh.indices.size()),
+            .meshlet_count = static_cast<std::uint32_t>(mesh.meshlets.size()),
+        };
+        auto bounds_min = mesh.vertices.empty() ? vec3(0.f) : vec3(std::numeric_limits<float>::max());
+        auto bounds_max = mesh.vertices.empty() ? vec3(0.f) : vec3(std::numeric_limits<float>::lowest());
+        for (const auto& vertex : mesh.vertices)
+        {
+            bounds_min = math::min(bounds_min, vertex.position);
+            bounds_max = math::max(bounds_max, vertex.position);
+        }
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            header.bounds_min[axis] = bounds_min[axis];
+            header.bounds_max[axis] = bounds_max[axis];
+        }
+        header.vertices_offset = align_up(sizeof(cooked_mesh_header));
+        header.indices_offset = align_up(header.vertices_offset + sizeof(vertex) * mesh.vertices.size());
+        header.meshlets_offset = align_up(header.indices_offset + sizeof(std::uint32_t) * mesh.indices.size());
+
+        // padding between blobs stays zeroed so cooking the same mesh twice gives the same bytes
+        auto bytes = std::vector<std::uint8_t>(header.meshlets_offset + sizeof(meshlet) * mesh.meshlets.size(), 0);
+        std::memcpy(bytes.data(), &header, sizeof(cooked_mesh_header));
+        std::memcpy(bytes.data() + header.vertices_offset, mesh.vertices.data(), sizeof(vertex) * mesh.vertices.size());
+        std::memcpy(bytes.data() + header.indices_offset, mesh.indices.data(), sizeof(std::uint32_t) * mesh.indices.size());
+        std::memcpy(bytes.data() + header.meshlets_offset, mesh.meshlets.data(), sizeof(meshlet) * mesh.meshlets.size());
+        return bytes;
+    }
+
+    auto write_cooked_mesh(const mesh& mesh, const std::filesystem::path& path) -> bool
+    {
+        auto bytes = cook_mesh(mesh);
+        auto file = std::ofstream(path, std::ios::binary | std::ios::trunc);
+        if (!file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size())))
+        {
+            fae::log_error(std::format("failed to write cooked mesh {}", path.string()));
+            return false;
+        }
+        return true;
+    }
+
+    auto load_cooked_mesh(const std::filesystem::path& path) -> std::optional<mesh>
+    {
+        auto file = mapped_file::open(path);
+        if (!file)
+        {
+            fae::log_error(std::format("failed to open cooked mesh {}", path.string()));
+            return std::nullopt;
+        }
+        auto view = cooked_mesh_view::parse(file->bytes());
+        if (!view)
+        {
+            fae::log_error(std::format("failed to load cooked mesh {}", path.string()));
+            return std::nullopt;
+        }
+        return view->to_mesh();
+    }
+
+    auto is_cooked_mesh_path(const std::filesystem::path& path) noexcept -> bool
+    {
+        auto extension = path.extension().string();
+        std::ranges::transform(extension, extension.begin(), [](unsigned char c)
+            { return static_cast<char>(std::tolower(c)); });
+        return extension == cooked_mesh_extension;
+    }
+
+    auto cooked_mesh_path(const std::filesystem::path& source) -> std::filesystem::path
+    {
+        auto path = source;
+        path += cooked_mesh_extension;
+        return path;
+    }
+}
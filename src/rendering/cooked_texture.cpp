@@ -0,0 +1,233 @@
+#include "fae/rendering/cooked_texture.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <span>
+#include <string>
+#include <type_traits>
+
+#include <magic_enum.hpp>
+
+#include "fae/color.hpp"
+#include "fae/logging.hpp"
+#include "fae/mapped_file.hpp"
+
+namespace fae
+{
+    static_assert(std::is_trivially_copyable_v<cooked_texture_header> && std::is_trivially_copyable_v<cooked_texture_level>);
+    static_assert(sizeof(color) == 4, "cooked textures store rgba8 texels");
+
+    namespace
+    {
+        constexpr auto align_up(std::uint64_t offset) noexcept -> std::uint64_t
+        {
+            return (offset + cooked_texture_header::level_alignment - 1) / cooked_texture_header::level_alignment * cooked_texture_header::level_alignment;
+        }
+
+        auto level_size_in_bytes(const cooked_texture_header& header, std::size_t width, std::size_t height) noexcept -> std::size_t
+        {
+            if (header.compression == cooked_texture_header::uncompressed)
+            {
+                return width * height * sizeof(color);
+            }
+            return compressed_level_size_in_bytes(static_cast<texture_compression>(header.compression), width, height);
+        }
+    }
+
+    auto cooked_texture_view::parse(std::span<const std::uint8_t> bytes) -> std::optional<cooked_texture_view>
+    {
+        auto view = cooked_texture_view{ .bytes = bytes };
+        auto& header = view.header;
+        if (bytes.size() < sizeof(cooked_texture_header))
+        {
+            fae::log_error("cooked texture is smaller than its header");
+            return std::nullopt;
+        }
+        std::memcpy(&header, bytes.data(), sizeof(cooked_texture_header));
+        if (header.magic != cooked_texture_header::expected_magic)
+        {
+            fae::log_error("not a cooked texture");
+            return std::nullopt;
+        }
+        if (header.version != cooked_texture_header::current_version)
+        {
+            fae::log_error(std::format("cooked texture version {} doesn't match version {}, cook it again", header.version, cooked_texture_header::current_version));
+            return std::nullopt;
+        }
+        if (header.compression != cooked_texture_header::uncompressed && !magic_enum::enum_cast<texture_compression>(static_cast<std::underlying_type_t<texture_compression>>(header.compression)))
+        {
+            fae::log_error(std::format("cooked texture has an unknown compression {}", header.compression));
+            return std::nullopt;
+        }
+        if (header.width == 0 || header.height == 0 || header.level_count == 0 || header.level_count > mip_level_count(header.width, header.height))
+        {
+            fae::log_error(std::format("cooked texture has an invalid size {}x{} or level count {}", header.width, header.height, header.level_count));
+            return std::nullopt;
+        }
+        auto table_size = sizeof(cooked_texture_header) + sizeof(cooked_texture_level) * header.level_count;
+        if (bytes.size() < table_size)
+        {
+            fae::log_error("cooked texture is truncated");
+            return std::nullopt;
+        }
+
+        view.levels.resize(header.level_count);
+        std::memcpy(view.levels.data(), bytes.data() + sizeof(cooked_texture_header), sizeof(cooked_texture_level) * header.level_count);
+        auto width = std::size_t{ header.width };
+        auto height = std::size_t{ header.height };
+        for (const auto& level : view.levels)
+        {
+            // levels must follow the mip chain & lie within the file, a level that doesn't is never uploaded
+            if (level.width != width || level.height != height || level.size != level_size_in_bytes(header, width, height) ||
+                level.offset % cooked_texture_header::level_alignment != 0 || level.offset > bytes.size() || level.size > bytes.size() - level.offset)
+            {
+                fae::log_error("cooked texture has an invalid or truncated level");
+                return std::nullopt;
+            }
+            width = std::max<std::size_t>(width / 2, 1);
+            height = std::max<std::size_t>(height / 2, 1);
+        }
+        return view;
+    }
+
+    auto cooked_texture_view::level_data(std::size_t level) const noexcept -> std::span<const std::uint8_t>
+    {
+        return bytes.subspan(levels[level].offset, levels[level].size);
+    }
+
+    auto cooked_texture_view::to_texture() const -> texture
+    {
+        // levels are packed back to back, like mip_chain & compressed_texture expect
+        auto data = std::vector<std::uint8_t>();
+        auto mip_levels = std::vector<mip_level>();
+        for (std::size_t level = 0; level < levels.size(); ++level)
+        {
+            auto level_bytes = level_data(level);
+            mip_levels.push_back(mip_level{ .width = levels[level].width, .height = levels[level].height, .offset = data.size() });
+            data.insert(data.end(), level_bytes.begin(), level_bytes.end());
+        }
+
+        auto result = texture{
+            .width = header.width,
+            .height = header.height,
+        };
+        if (header.compression == cooked_texture_header::uncompressed)
+        {
+            result.mips = mip_chain{ .data = std::move(data), .levels = std::move(mip_levels) };
+            return result;
+        }
+        result.compressed = compressed_texture{
+            .compression = static_cast<texture_compression>(header.compression),
+            .srgb = header.srgb != 0,
+            .data = std::move(data),
+            .levels = std::move(mip_levels),
+        };
+        return result;
+    }
+
+    auto cook_texture(const texture& texture, const mip_chain_options& mip_options) -> std::vector<std::uint8_t>
+    {
+        auto header = cooked_texture_header{
+            .width = static_cast<std::uint32_t>(texture.width),
+            .height = static_cast<std::uint32_t>(texture.height),
+        };
+        // every source ends up as packed levels: compressed blocks as they are, rgba8 with its chain built now instead of at upload
+        auto chain = mip_chain{};
+        const auto* levels = &chain.levels;
+        auto level_bytes = std::function<std::span<const std::uint8_t>(std::size_t)>([&](std::size_t level)
+            { return chain.level_data(level); });
+        if (texture.compressed)
+        {
+            header.compression = static_cast<std::uint32_t>(texture.compressed->compression);
+            header.srgb = texture.compressed->srgb ? 1 : 0;
+            levels = &texture.compressed->levels;
+            level_bytes = [&](std::size_t level)
+            { return texture.compressed->level_data(level); };
+        }
+        else if (texture.mips)
+        {
+            header.srgb = mip_options.srgb ? 1 : 0;
+            levels = &texture.mips->levels;
+            level_bytes = [&](std::size_t level)
+            { return texture.mips->level_data(level); };
+        }
+        else
+        {
+            header.srgb = mip_options.srgb ? 1 : 0;
+            chain = build_mip_chain(std::span(reinterpret_cast<const std::uint8_t*>(texture.data.data()), texture.data.size() * sizeof(color)), texture.width, texture.height, mip_options);
+        }
+        header.level_count = static_cast<std::uint32_t>(levels->size());
+
+        auto table = std::vector<cooked_texture_level>(levels->size());
+        auto offset = align_up(sizeof(cooked_texture_header) + sizeof(cooked_texture_level) * table.size());
+        for (std::size_t level = 0; level < table.size(); ++level)
+        {
+            table[level] = cooked_texture_level{
+                .width = static_cast<std::uint32_t>((*levels)[level].width),
+                .height = static_cast<std::uint32_t>((*levels)[level].height),
+                .offset = offset,
+                .size = level_bytes(level).size(),
+            };
+            offset = align_up(offset + table[level].size);
+        }
+
+        // padding between levels stays zeroed so cooking the same texture twice gives the same bytes
+        auto bytes = std::vector<std::uint8_t>(offset, 0);
+        std::memcpy(bytes.data(), &header, sizeof(cooked_texture_header));
+        std::memcpy(bytes.data() + sizeof(cooked_texture_header), table.data(), sizeof(cooked_texture_level) * table.size());
+        for (std::size_t level = 0; level < table.size(); ++level)
+        {
+            auto data = level_bytes(level);
+            std::memcpy(bytes.data() + table[level].offset, data.data(), data.size());
+        }
+        return bytes;
+    }
+
+    auto write_cooked_texture(const texture& texture, const std::filesystem::path& path, const mip_chain_options& mip_options) -> bool
+    {
+        auto bytes = cook_texture(texture, mip_options);
+        auto file = std::ofstream(path, std::ios::binary | std::ios::trunc);
+        if (!file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size())))
+        {
+            fae::log_error(std::format("failed to write cooked texture {}", path.string()));
+            return false;
+        }
+        return true;
+    }
+
+    auto load_cooked_texture(const std::filesystem::path& path) -> std::optional<texture>
+    {
+        auto file = mapped_file::open(path);
+        if (!file)
+        {
+            fae::log_error(std::format("failed to open cooked texture {}", path.string()));
+            return std::nullopt;
+        }
+        auto view = cooked_texture_view::parse(file->bytes());
+        if (!view)
+        {
+            fae::log_error(std::format("failed to load cooked texture {}", path.string()));
+            return std::nullopt;
+        }
+        return view->to_texture();
+    }
+
+    auto is_cooked_texture_path(const std::filesystem::path& path) noexcept -> bool
+    {
+        auto extension = path.extension().string();
+        std::ranges::transform(extension, extension.begin(), [](unsigned char c)
+            { return static_cast<char>(std::tolower(c)); });
+        return extension == cooked_texture_extension;
+    }
+
+    auto cooked_texture_path(const std::filesystem::path& source) -> std::filesystem::path
+    {
+        auto path = source;
+        path += cooked_texture_extension;
+        return path;
+    }
+}
@@ -0,0 +1,56 @@
+#include "fae/rendering/dynamic_resolution.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace fae
+{
+    auto dynamic_resolution::update(float frame_ms, const dynamic_resolution_settings& settings) noexcept -> bool
+    {
+        if (frame_ms > settings.target_frame_ms)
+        {
+            frames_over_budget++;
+            frames_under_budget = 0;
+        }
+        else if (frame_ms < settings.target_frame_ms * settings.headroom)
+        {
+            frames_under_budget++;
+            frames_over_budget = 0;
+        }
+        else
+        {
+            frames_over_budget = 0;
+            frames_under_budget = 0;
+        }
+
+        auto step = std::clamp(settings.scale_step, 0.01f, 1.f);
+        auto next_scale = scale;
+        if (frames_over_budget >= std::max(settings.frames_to_lower, 1u))
+        {
+            next_scale -= step;
+            frames_over_budget = 0;
+        }
+        else if (frames_under_budget >= std::max(settings.frames_to_raise, 1u))
+        {
+            next_scale += step;
+            frames_under_budget = 0;
+        }
+        // snapped to a bucket & kept within the allowed range (also when the settings changed)
+        auto min_scale = std::clamp(settings.min_scale, step, 1.f);
+        auto max_scale = std::clamp(settings.max_scale, min_scale, 1.f);
+        next_scale = std::clamp(std::round(next_scale / step) * step, min_scale, max_scale);
+        auto changed = next_scale != scale;
+        scale = next_scale;
+        return changed;
+    }
+
+    auto dynamic_resolution::reset() noexcept -> void
+    {
+        *this = dynamic_resolution{};
+    }
+
+    auto scaled_extent(std::uint32_t size, float scale) noexcept -> std::uint32_t
+    {
+        return std::max(static_cast<std::uint32_t>(std::lround(size * scale)), 1u);
+    }
+}
@@ -0,0 +1,131 @@
+#include "fae/rendering/frame_trace.hpp"
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+#include "fae/logging.hpp"
+
+namespace fae
+{
+    namespace
+    {
+        /* escapes a string for use inside a json string literal */
+        auto escape_json(std::string_view text) -> std::string
+        {
+            auto escaped = std::string();
+            escaped.reserve(text.size());
+            for (auto c : text)
+            {
+                switch (c)
+                {
+                case '"':
+                    escaped += "\\\"";
+                    break;
+                case '\\':
+                    escaped += "\\\\";
+                    break;
+                case '\n':
+                    escaped += "\\n";
+                    break;
+                case '\r':
+                    escaped += "\\r";
+                    break;
+                case '\t':
+                    escaped += "\\t";
+                    break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20)
+                    {
+                        escaped += std::format("\\u{:04x}", static_cast<unsigned int>(static_cast<unsigned char>(c)));
+                    }
+                    else
+                    {
+                        escaped += c;
+                    }
+                }
+            }
+            return escaped;
+        }
+    }
+
+    auto frame_trace::add_cpu_frame(std::uint64_t frame, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point submitted) -> void
+    {
+        m_events.push_back(event{
+            .name = std::format("frame {}", frame),
+            .frame = frame,
+            .track = 1,
+            .begin = begin,
+            .duration = submitted - begin,
+        });
+        m_submissions.push_back(submission{ .frame = frame, .submitted = submitted });
+        drop_old_frames();
+    }
+
+    auto frame_trace::add_gpu_frame(const gpu_frame_stats& stats) -> void
+    {
+        auto it = std::ranges::find(m_submissions, stats.frame, &submission::frame);
+        if (it == m_submissions.end() || it->gpu_added)
+        {
+            return;
+        }
+        it->gpu_added = true;
+        for (const auto& pass : stats.passes)
+        {
+            m_events.push_back(event{
+                .name = pass.label,
+                .frame = stats.frame,
+                .track = 2,
+                .begin = it->submitted + pass.start.nanoseconds(),
+                .duration = pass.time.nanoseconds(),
+            });
+        }
+    }
+
+    auto frame_trace::write() const -> bool
+    {
+        if (m_events.empty())
+        {
+            return true;
+        }
+        auto file = std::ofstream(path, std::ios::trunc);
+        if (!file.is_open())
+        {
+            fae::log_error(std::format("failed to open frame trace {}", path.string()));
+            return false;
+        }
+
+        auto origin = std::ranges::min(m_events, {}, &event::begin).begin;
+        auto microseconds = [](auto duration)
+        { return std::chrono::duration<double, std::micro>(duration).count(); };
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"cpu encode\"}},\n";
+        file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"gpu\"}}";
+        for (const auto& event : m_events)
+        {
+            // pass labels are user defined, so they may hold quotes or backslashes
+            file << std::format(",\n{{\"name\":\"{}\",\"cat\":\"{}\",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f},\"args\":{{\"frame\":{}}}}}",
+                escape_json(event.name), event.track == 1 ? "cpu" : "gpu", event.track, microseconds(event.begin - origin), microseconds(event.duration), event.frame);
+        }
+        file << "\n]}\n";
+        if (!file)
+        {
+            fae::log_error(std::format("failed to write frame trace {}", path.string()));
+            return false;
+        }
+        return true;
+    }
+
+    auto frame_trace::drop_old_frames() -> void
+    {
+        while (m_submissions.size() > max_frames)
+        {
+            auto oldest = m_submissions.front().frame;
+            m_submissions.pop_front();
+            std::erase_if(m_events, [&](const event& event)
+                { return event.frame <= oldest; });
+        }
+    }
+}
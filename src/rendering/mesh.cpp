@@ -1,8 +1,15 @@
 #include "fae/rendering/mesh.hpp"
+
+#include <format>
+#include <string_view>
+
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 
+#include "fae/logging.hpp"
+#include "fae/rendering/cooked_mesh.hpp"
+
 namespace fae
 {
     auto meshes::cube(float size) -> mesh
@@ -16,8 +23,19 @@ namespace fae
         return mesh;
     }
 
-    auto mesh::load(std::filesystem::path path) -> std::optional<mesh>
+    auto mesh::load(std::filesystem::path path, const mesh_import_options& options) -> std::optional<mesh>
     {
+        // optimized when cooked, only meshlets may still be missing
+        if (is_cooked_mesh_path(path))
+        {
+            auto cooked = load_cooked_mesh(path);
+            if (cooked && options.build_meshlets && cooked->meshlets.empty())
+            {
+                build_meshlets(*cooked, options.meshlets);
+            }
+            return cooked;
+        }
+
         auto importer = Assimp::Importer{};
         const auto scene = importer.ReadFile(path.string(), aiProcess_Triangulate | aiProcess_JoinIdenticalVertices | aiProcess_SortByPType);
         if (!scene)
@@ -65,6 +83,33 @@ namespace fae
             }
         }
 
+        auto log_statistics = [&](std::string_view stage)
+        {
+            auto statistics = analyze_mesh(result);
+            fae::log_info(std::format("mesh {} {}: {} vertices, {} triangles, acmr {:.3f}, atvr {:.3f}, overdraw {:.3f}, overfetch {:.3f}",
+                path.filename().string(), stage, result.vertices.size(), result.indices.size() / 3, statistics.acmr, statistics.atvr, statistics.overdraw, statistics.overfetch));
+        };
+        if (options.log_statistics)
+        {
+            log_statistics("imported");
+        }
+        if (options.optimize)
+        {
+            optimize_mesh(result, options.optimization);
+            if (options.log_statistics)
+            {
+                log_statistics("optimized");
+            }
+        }
+        if (options.build_meshlets)
+        {
+            build_meshlets(result, options.meshlets);
+            if (options.log_statistics)
+            {
+                fae::log_info(std::format("mesh {}: {} meshlets", path.filename().string(), result.meshlets.size()));
+            }
+        }
+
         return result;
     }
 }
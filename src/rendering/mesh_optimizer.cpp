@@ -0,0 +1,130 @@
+#include "fae/rendering/mesh_optimizer.hpp"
+
+#include <cstddef>
+#include <numeric>
+#include <vector>
+
+#include <meshoptimizer.h>
+
+#include "fae/rendering/mesh.hpp"
+
+namespace fae
+{
+    namespace
+    {
+        auto index_if_needed(mesh& mesh) -> void
+        {
+            if (mesh.has_indices() || mesh.vertices.empty())
+            {
+                return;
+            }
+            auto remap = std::vector<unsigned int>(mesh.vertices.size());
+            auto unique_vertex_count = meshopt_generateVertexRemap(remap.data(), nullptr, mesh.vertices.size(), mesh.vertices.data(), mesh.vertices.size(), sizeof(vertex));
+            mesh.indices.resize(mesh.vertices.size());
+            meshopt_remapIndexBuffer(mesh.indices.data(), nullptr, mesh.vertices.size(), remap.data());
+            auto vertices = std::vector<vertex>(unique_vertex_count);
+            meshopt_remapVertexBuffer(vertices.data(), mesh.vertices.data(), mesh.vertices.size(), sizeof(vertex), remap.data());
+            mesh.vertices = std::move(vertices);
+        }
+
+        /* index view of a mesh, non indexed meshes use every vertex once in order */
+        auto indices_of(const mesh& mesh) -> std::vector<std::uint32_t>
+        {
+            if (mesh.has_indices())
+            {
+                return mesh.indices;
+            }
+            auto indices = std::vector<std::uint32_t>(mesh.vertices.size());
+            std::iota(indices.begin(), indices.end(), 0u);
+            return indices;
+        }
+    }
+
+    auto optimize_mesh(mesh& mesh, const mesh_optimization_options& options) -> void
+    {
+        mesh.meshlets.clear();
+        index_if_needed(mesh);
+        if (mesh.indices.empty())
+        {
+            return;
+        }
+
+        auto index_count = mesh.indices.size();
+        auto vertex_count = mesh.vertices.size();
+        if (options.vertex_cache)
+        {
+            meshopt_optimizeVertexCache(mesh.indices.data(), mesh.indices.data(), index_count, vertex_count);
+        }
+        if (options.overdraw)
+        {
+            meshopt_optimizeOverdraw(mesh.indices.data(), mesh.indices.data(), index_count,
+                &mesh.vertices.front().position.x, vertex_count, sizeof(vertex), options.overdraw_threshold);
+        }
+        if (options.vertex_fetch)
+        {
+            // vertices no triangle uses are dropped from the end
+            mesh.vertices.resize(meshopt_optimizeVertexFetch(mesh.vertices.data(), mesh.indices.data(), index_count, mesh.vertices.data(), vertex_count, sizeof(vertex)));
+        }
+    }
+
+    auto build_meshlets(mesh& mesh, const meshlet_options& options) -> void
+    {
+        mesh.meshlets.clear();
+        index_if_needed(mesh);
+        if (mesh.indices.empty())
+        {
+            return;
+        }
+
+        auto max_meshlets = meshopt_buildMeshletsBound(mesh.indices.size(), options.max_vertices, options.max_triangles);
+        auto meshlets = std::vector<meshopt_Meshlet>(max_meshlets);
+        auto meshlet_vertices = std::vector<unsigned int>(max_meshlets * options.max_vertices);
+        auto meshlet_triangles = std::vector<unsigned char>(max_meshlets * options.max_triangles * 3);
+        auto meshlet_count = meshopt_buildMeshlets(meshlets.data(), meshlet_vertices.data(), meshlet_triangles.data(),
+            mesh.indices.data(), mesh.indices.size(), &mesh.vertices.front().position.x, mesh.vertices.size(), sizeof(vertex),
+            options.max_vertices, options.max_triangles, options.cone_weight);
+        meshlets.resize(meshlet_count);
+
+        // meshlets index their own vertex list, expand them back into one index buffer grouped by meshlet
+        auto indices = std::vector<std::uint32_t>();
+        indices.reserve(mesh.indices.size());
+        mesh.meshlets.reserve(meshlet_count);
+        for (const auto& meshlet : meshlets)
+        {
+            meshopt_optimizeMeshlet(&meshlet_vertices[meshlet.vertex_offset], &meshlet_triangles[meshlet.triangle_offset], meshlet.triangle_count, meshlet.vertex_count);
+            auto bounds = meshopt_computeMeshletBounds(&meshlet_vertices[meshlet.vertex_offset], &meshlet_triangles[meshlet.triangle_offset], meshlet.triangle_count,
+                &mesh.vertices.front().position.x, mesh.vertices.size(), sizeof(vertex));
+            mesh.meshlets.push_back(fae::meshlet{
+                .first_index = static_cast<std::uint32_t>(indices.size()),
+                .index_count = meshlet.triangle_count * 3,
+                .bounding_sphere = vec4(bounds.center[0], bounds.center[1], bounds.center[2], bounds.radius),
+                .cone_apex = vec3(bounds.cone_apex[0], bounds.cone_apex[1], bounds.cone_apex[2]),
+                .cone_axis = vec3(bounds.cone_axis[0], bounds.cone_axis[1], bounds.cone_axis[2]),
+                .cone_cutoff = bounds.cone_cutoff,
+            });
+            for (std::size_t i = 0; i < meshlet.triangle_count * 3; ++i)
+            {
+                indices.push_back(meshlet_vertices[meshlet.vertex_offset + meshlet_triangles[meshlet.triangle_offset + i]]);
+            }
+        }
+        mesh.indices = std::move(indices);
+    }
+
+    auto analyze_mesh(const mesh& mesh, std::uint32_t cache_size) -> mesh_statistics
+    {
+        if (mesh.vertices.empty())
+        {
+            return {};
+        }
+        auto indices = indices_of(mesh);
+        auto vertex_cache = meshopt_analyzeVertexCache(indices.data(), indices.size(), mesh.vertices.size(), cache_size, 0, 0);
+        auto overdraw = meshopt_analyzeOverdraw(indices.data(), indices.size(), &mesh.vertices.front().position.x, mesh.vertices.size(), sizeof(vertex));
+        auto vertex_fetch = meshopt_analyzeVertexFetch(indices.data(), indices.size(), mesh.vertices.size(), vertex_stride(mesh.format));
+        return mesh_statistics{
+            .acmr = vertex_cache.acmr,
+            .atvr = vertex_cache.atvr,
+            .overdraw = overdraw.overdraw,
+            .overfetch = vertex_fetch.overfetch,
+        };
+    }
+}
@@ -0,0 +1,297 @@
+#include "fae/rendering/mip_chain.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FAE_MIP_CHAIN_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define FAE_MIP_CHAIN_NEON
+#include <arm_neon.h>
+#endif
+
+namespace fae
+{
+    namespace
+    {
+        constexpr std::size_t bytes_per_texel = 4;
+
+        /* source texels (and their weights) that cover one destination texel along one axis */
+        struct filter_taps
+        {
+            std::array<std::size_t, 3> index{};
+            std::array<float, 3> weight{};
+            std::size_t count = 0;
+        };
+
+        [[nodiscard]] auto make_filter_taps(std::size_t source_size, std::size_t destination_size) -> std::vector<filter_taps>
+        {
+            auto taps = std::vector<filter_taps>(destination_size);
+            for (std::size_t i = 0; i < destination_size; ++i)
+            {
+                if (source_size == 1)
+                {
+                    taps[i] = filter_taps{ .index = { 0, 0, 0 }, .weight = { 1.f, 0.f, 0.f }, .count = 1 };
+                }
+                else if (source_size % 2 == 0)
+                {
+                    taps[i] = filter_taps{ .index = { 2 * i, 2 * i + 1, 0 }, .weight = { .5f, .5f, 0.f }, .count = 2 };
+                }
+                else
+                {
+                    // source_size = 2n + 1 shrinks to n texels, each covering 2 + 1/n source texels
+                    auto n = static_cast<float>(destination_size);
+                    auto size = static_cast<float>(source_size);
+                    auto fi = static_cast<float>(i);
+                    taps[i] = filter_taps{
+                        .index = { 2 * i, 2 * i + 1, 2 * i + 2 },
+                        .weight = { (n - fi) / size, n / size, (fi + 1.f) / size },
+                        .count = 3,
+                    };
+                }
+            }
+            return taps;
+        }
+
+        struct srgb_tables
+        {
+            std::array<float, 256> to_linear{};
+            /* indexed by round(linear * 4095) */
+            std::array<std::uint8_t, 4096> from_linear{};
+        };
+
+        [[nodiscard]] auto get_srgb_tables() noexcept -> const srgb_tables&
+        {
+            static const auto tables = []
+            {
+                auto tables = srgb_tables{};
+                for (std::size_t i = 0; i < tables.to_linear.size(); ++i)
+                {
+                    auto c = static_cast<float>(i) / 255.f;
+                    tables.to_linear[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+                }
+                for (std::size_t i = 0; i < tables.from_linear.size(); ++i)
+                {
+                    auto l = static_cast<float>(i) / static_cast<float>(tables.from_linear.size() - 1);
+                    auto c = l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.f / 2.4f) - 0.055f;
+                    tables.from_linear[i] = static_cast<std::uint8_t>(std::clamp(std::lround(c * 255.f), 0l, 255l));
+                }
+                return tables;
+            }();
+            return tables;
+        }
+
+        /* exact 2x2 box filter of two source rows, (a + b + c + d + 2) / 4 per channel */
+        auto filter_row_box(const std::uint8_t* row0, const std::uint8_t* row1, std::uint8_t* destination, std::size_t destination_width) noexcept -> void
+        {
+            std::size_t x = 0;
+#if defined(FAE_MIP_CHAIN_SSE2)
+            // 8 source texels per row -> 4 destination texels
+            const auto zero = _mm_setzero_si128();
+            const auto two = _mm_set1_epi16(2);
+            for (; x + 4 <= destination_width; x += 4)
+            {
+                auto a0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + x * 2 * bytes_per_texel));
+                auto a1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + x * 2 * bytes_per_texel + 16));
+                auto b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + x * 2 * bytes_per_texel));
+                auto b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + x * 2 * bytes_per_texel + 16));
+
+                // vertical sums widened to 16 bits, two texels per register
+                auto s01 = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(b0, zero));
+                auto s23 = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(b0, zero));
+                auto s45 = _mm_add_epi16(_mm_unpacklo_epi8(a1, zero), _mm_unpacklo_epi8(b1, zero));
+                auto s67 = _mm_add_epi16(_mm_unpackhi_epi8(a1, zero), _mm_unpackhi_epi8(b1, zero));
+
+                // horizontal sums land in the low 64 bits
+                auto d0 = _mm_add_epi16(s01, _mm_srli_si128(s01, 8));
+                auto d1 = _mm_add_epi16(s23, _mm_srli_si128(s23, 8));
+                auto d2 = _mm_add_epi16(s45, _mm_srli_si128(s45, 8));
+                auto d3 = _mm_add_epi16(s67, _mm_srli_si128(s67, 8));
+
+                auto out01 = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(d0, d1), two), 2);
+                auto out23 = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(d2, d3), two), 2);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + x * bytes_per_texel), _mm_packus_epi16(out01, out23));
+            }
+#elif defined(FAE_MIP_CHAIN_NEON)
+            // 4 source texels per row -> 2 destination texels
+            for (; x + 2 <= destination_width; x += 2)
+            {
+                auto a = vld1q_u8(row0 + x * 2 * bytes_per_texel);
+                auto b = vld1q_u8(row1 + x * 2 * bytes_per_texel);
+                auto s01 = vaddl_u8(vget_low_u8(a), vget_low_u8(b));
+                auto s23 = vaddl_u8(vget_high_u8(a), vget_high_u8(b));
+                auto d0 = vadd_u16(vget_low_u16(s01), vget_high_u16(s01));
+                auto d1 = vadd_u16(vget_low_u16(s23), vget_high_u16(s23));
+                vst1_u8(destination + x * bytes_per_texel, vrshrn_n_u16(vcombine_u16(d0, d1), 2));
+            }
+#endif
+            for (; x < destination_width; ++x)
+            {
+                auto p0 = row0 + x * 2 * bytes_per_texel;
+                auto p1 = row1 + x * 2 * bytes_per_texel;
+                for (std::size_t c = 0; c < bytes_per_texel; ++c)
+                {
+                    destination[x * bytes_per_texel + c] = static_cast<std::uint8_t>((p0[c] + p0[c + bytes_per_texel] + p1[c] + p1[c + bytes_per_texel] + 2) >> 2);
+                }
+            }
+        }
+
+        /* weighted filter for odd dimensions and/or srgb filtering */
+        auto filter_row_general(const std::uint8_t* source,
+            std::size_t source_width,
+            std::uint8_t* destination,
+            const filter_taps& y_taps,
+            const std::vector<filter_taps>& x_taps,
+            bool srgb) noexcept -> void
+        {
+            const auto& tables = get_srgb_tables();
+            for (std::size_t x = 0; x < x_taps.size(); ++x)
+            {
+                auto sum = std::array<float, bytes_per_texel>{};
+                for (std::size_t ty = 0; ty < y_taps.count; ++ty)
+                {
+                    auto row = source + y_taps.index[ty] * source_width * bytes_per_texel;
+                    for (std::size_t tx = 0; tx < x_taps[x].count; ++tx)
+                    {
+                        auto weight = y_taps.weight[ty] * x_taps[x].weight[tx];
+                        auto texel = row + x_taps[x].index[tx] * bytes_per_texel;
+                        for (std::size_t c = 0; c < 3; ++c)
+                        {
+                            sum[c] += weight * (srgb ? tables.to_linear[texel[c]] : static_cast<float>(texel[c]));
+                        }
+                        sum[3] += weight * static_cast<float>(texel[3]);
+                    }
+                }
+
+                auto texel = destination + x * bytes_per_texel;
+                for (std::size_t c = 0; c < 3; ++c)
+                {
+                    texel[c] = srgb
+                        ? tables.from_linear[std::clamp<long>(std::lround(sum[c] * static_cast<float>(tables.from_linear.size() - 1)), 0, static_cast<long>(tables.from_linear.size() - 1))]
+                        : static_cast<std::uint8_t>(std::clamp<long>(std::lround(sum[c]), 0, 255));
+                }
+                texel[3] = static_cast<std::uint8_t>(std::clamp<long>(std::lround(sum[3]), 0, 255));
+            }
+        }
+
+        auto filter_level(const std::uint8_t* source,
+            const mip_level& source_level,
+            std::uint8_t* destination,
+            const mip_level& destination_level,
+            const mip_chain_options& options) -> void
+        {
+            const auto use_box_filter = !options.srgb && source_level.width % 2 == 0 && source_level.height % 2 == 0;
+            const auto x_taps = use_box_filter ? std::vector<filter_taps>{} : make_filter_taps(source_level.width, destination_level.width);
+            const auto y_taps = use_box_filter ? std::vector<filter_taps>{} : make_filter_taps(source_level.height, destination_level.height);
+            const auto source_row_size = source_level.width * bytes_per_texel;
+            const auto destination_row_size = destination_level.width * bytes_per_texel;
+
+            auto filter_rows = [&](std::size_t first_row, std::size_t last_row)
+            {
+                for (std::size_t y = first_row; y < last_row; ++y)
+                {
+                    if (use_box_filter)
+                    {
+                        filter_row_box(source + 2 * y * source_row_size, source + (2 * y + 1) * source_row_size, destination + y * destination_row_size, destination_level.width);
+                    }
+                    else
+                    {
+                        filter_row_general(source, source_level.width, destination + y * destination_row_size, y_taps[y], x_taps, options.srgb);
+                    }
+                }
+            };
+
+            std::size_t thread_count = 1;
+#ifndef FAE_PLATFORM_WEB
+            if (options.parallel_texel_threshold != 0 && destination_level.width * destination_level.height >= options.parallel_texel_threshold)
+            {
+                thread_count = std::clamp<std::size_t>(std::thread::hardware_concurrency(), 1, destination_level.height);
+            }
+#endif
+            if (thread_count == 1)
+            {
+                filter_rows(0, destination_level.height);
+                return;
+            }
+
+            auto workers = std::vector<std::jthread>();
+            workers.reserve(thread_count - 1);
+            const auto rows_per_thread = (destination_level.height + thread_count - 1) / thread_count;
+            for (std::size_t first_row = rows_per_thread; first_row < destination_level.height; first_row += rows_per_thread)
+            {
+                workers.emplace_back(filter_rows, first_row, std::min(first_row + rows_per_thread, destination_level.height));
+            }
+            filter_rows(0, std::min(rows_per_thread, destination_level.height));
+        }
+    }
+
+    auto mip_chain::level_data(std::size_t level) const noexcept -> std::span<const std::uint8_t>
+    {
+        const auto& mip = levels[level];
+        return std::span<const std::uint8_t>(data.data() + mip.offset, mip.width * mip.height * bytes_per_texel);
+    }
+
+    auto mip_level_count(std::size_t width, std::size_t height) noexcept -> std::uint32_t
+    {
+        if (width == 0 || height == 0)
+        {
+            return 0;
+        }
+        return static_cast<std::uint32_t>(std::bit_width(std::max(width, height)));
+    }
+
+    auto mip_chain_size_in_bytes(std::size_t width, std::size_t height) noexcept -> std::size_t
+    {
+        std::size_t size = 0;
+        for (std::uint32_t level = 0, count = mip_level_count(width, height); level < count; ++level)
+        {
+            size += std::max<std::size_t>(width >> level, 1) * std::max<std::size_t>(height >> level, 1) * bytes_per_texel;
+        }
+        return size;
+    }
+
+    auto build_mip_chain(std::span<const std::uint8_t> rgba8,
+        std::size_t width,
+        std::size_t height,
+        const mip_chain_options& options) -> mip_chain
+    {
+        auto chain = mip_chain{};
+        if (rgba8.size() < width * height * bytes_per_texel)
+        {
+            return chain;
+        }
+
+        const auto level_count = mip_level_count(width, height);
+        chain.levels.reserve(level_count);
+        std::size_t offset = 0;
+        for (std::uint32_t level = 0; level < level_count; ++level)
+        {
+            auto mip = mip_level{
+                .width = std::max<std::size_t>(width >> level, 1),
+                .height = std::max<std::size_t>(height >> level, 1),
+                .offset = offset,
+            };
+            offset += mip.width * mip.height * bytes_per_texel;
+            chain.levels.push_back(mip);
+        }
+
+        chain.data.resize(offset);
+        if (level_count == 0)
+        {
+            return chain;
+        }
+        std::memcpy(chain.data.data(), rgba8.data(), width * height * bytes_per_texel);
+        for (std::uint32_t level = 1; level < level_count; ++level)
+        {
+            const auto& source = chain.levels[level - 1];
+            const auto& destination = chain.levels[level];
+            filter_level(chain.data.data() + source.offset, source, chain.data.data() + destination.offset, destination, options);
+        }
+        return chain;
+    }
+}
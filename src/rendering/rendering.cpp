@@ -6,6 +6,7 @@
 #include <numbers>
 #include <optional>
 #include <string_view>
+#include <unordered_map>
 #include <variant>
 
 #include "fae/application/application.hpp"
@@ -18,12 +19,65 @@
 #include "fae/rendering/renderer.hpp"
 #include "fae/rendering/render_pipeline.hpp"
 #include "fae/rendering/render_pass.hpp"
+#include "fae/rendering/frame_trace.hpp"
+#include "fae/rendering/gpu_frame_stats.hpp"
+#include "fae/rendering/render_settings.hpp"
+#include "fae/rendering/render_stats.hpp"
 #include "fae/webgpu/default_render_pipeline.hpp"
 
 namespace fae
 {
+    namespace
+    {
+        /* the handles each model component holds a reference to, as they were when the component was set (edits in place aren't seen) */
+        struct model_references
+        {
+            asset_manager& assets;
+            std::unordered_map<entity, model> retained{};
+        };
+
+        auto release_retained(model_references& references, entity id) noexcept -> void
+        {
+            auto previous = references.retained.find(id);
+            if (previous == references.retained.end())
+            {
+                return;
+            }
+            references.assets.release(previous->second.mesh);
+            references.assets.release(previous->second.material);
+            references.retained.erase(previous);
+        }
+
+        /* on_construct & on_update, a replaced model's previous handles are released after the new ones are retained (they may be the same) */
+        auto retain_model_references(entity_registry_t& registry, entity id) noexcept -> void
+        {
+            auto& references = registry.ctx().get<model_references>();
+            const auto& model = registry.get<fae::model>(id);
+            references.assets.retain(model.mesh);
+            references.assets.retain(model.material);
+            release_retained(references, id);
+            references.retained.emplace(id, model);
+        }
+
+        /* on_destroy, when the component is removed or its entity destroyed */
+        auto release_model_references(entity_registry_t& registry, entity id) noexcept -> void
+        {
+            release_retained(registry.ctx().get<model_references>(), id);
+        }
+    }
+
     auto rendering_plugin::init(application& app) const noexcept -> void
     {
+        // models keep their mesh & material loaded, both are unloaded once nothing else references them either
+        auto& registry = app.ecs_world.registry;
+        if (!registry.ctx().contains<model_references>())
+        {
+            registry.ctx().emplace<model_references>(model_references{ .assets = app.assets });
+            registry.on_construct<model>().connect<&retain_model_references>();
+            registry.on_update<model>().connect<&retain_model_references>();
+            registry.on_destroy<model>().connect<&release_model_references>();
+        }
+
         if (!app.global_entity.get_component<renderer>())
         {
             app.add_plugin(webgpu_plugin{});
@@ -36,16 +90,27 @@ namespace fae
             }
             auto webgpu_renderer = *maybe_webgpu_renderer;
             app
+                .set_global_component<render_stats>(render_stats{})
+                .set_global_component<render_settings>(render_settings{})
+                .set_global_component<gpu_frame_stats>(gpu_frame_stats{})
+                .set_global_component<static_batches>(static_batches{})
                 .set_global_component<default_render_pipeline>(default_render_pipeline{
                     .render_pipeline = create_default_render_pipeline(app.ecs_world, app.global_entity, app.assets),
                 })
                 .set_global_component<renderer>(
-                    make_webgpu_renderer(app.ecs_world, app.global_entity));
+                    make_webgpu_renderer(app.ecs_world, app.global_entity, app.assets));
+        }
+
+        if (!trace_path.empty())
+        {
+            app.set_global_component<frame_trace>(frame_trace{ .path = trace_path });
         }
 
         app.add_system<update_step>(update_rendering)
             .add_system<render_step>(render_models)
-            .add_system<window_resized>(resize_active_render_passes);
+            .add_system<render_step>(render_static_batches)
+            .add_system<window_resized>(resize_active_render_passes)
+            .add_system<deinit_step>(write_frame_trace);
     }
 
     auto update_rendering(const update_step& step) noexcept -> void
@@ -65,6 +130,7 @@ namespace fae
                           .render_pass = render_pass,
                       });
                       render_pass.end();
+                      renderer.end_frame();
                       if (!first_render_happened)
                       {
                           step.scheduler.invoke(fae::first_render_end{
@@ -85,7 +151,7 @@ namespace fae
             bool should_render = true;
             entity.use_component<const visibility>([&](const fae::visibility& visibility)
                 { should_render = visibility.visible; });
-            if (!should_render)
+            if (!should_render || entity.has_components<static_model>())
                 continue;
 
             auto transform = fae::transform{};
@@ -105,4 +171,14 @@ namespace fae
                 render_pass.get_render_pipeline().on_window_resized(e);
             } });
     }
+
+    auto write_frame_trace(const deinit_step& step) noexcept -> void
+    {
+        step.global_entity.use_component<const frame_trace>([&](const frame_trace& trace)
+            {
+                if (trace.write())
+                {
+                    fae::log_info(std::format("frame trace written to {}", trace.path.string()));
+                } });
+    }
 }
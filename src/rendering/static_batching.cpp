@@ -0,0 +1,126 @@
+#include "fae/rendering/static_batching.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include "fae/application/application.hpp"
+#include "fae/asset_manager.hpp"
+#include "fae/rendering/rendering.hpp"
+
+namespace fae
+{
+    namespace
+    {
+        auto batch_of(static_batches& static_batches, const mesh& mesh, asset_handle<material> material, std::uint32_t group) -> static_batches::batch&
+        {
+            for (auto& batch : static_batches.batches)
+            {
+                if (batch.group == group && batch.mesh.format == mesh.format && batch.material == material)
+                {
+                    return batch;
+                }
+            }
+            auto& batch = static_batches.batches.emplace_back(static_batches::batch{
+                .id = static_batches.next_id++,
+                .group = group,
+            });
+            batch.material = material;
+            batch.mesh.format = mesh.format;
+            return batch;
+        }
+
+        auto merge(static_batches::batch& batch, asset_manager& assets) -> void
+        {
+            auto& merged = batch.mesh;
+            merged.vertices.clear();
+            merged.indices.clear();
+            for (const auto& member : batch.members)
+            {
+                // members were gathered this frame, their meshes are loaded
+                const auto& mesh = *assets.get(member.mesh);
+                auto base_vertex = static_cast<std::uint32_t>(merged.vertices.size());
+                for (auto vertex : mesh.vertices)
+                {
+                    // the same transform the default shader applies per draw
+                    vertex.position = vec3(member.transform * vec4(vertex.position, 1.f));
+                    vertex.normal = math::normalize(vec3(member.transform * vec4(vertex.normal, 0.f)));
+                    merged.vertices.push_back(vertex);
+                }
+                if (mesh.has_indices())
+                {
+                    for (auto index : mesh.indices)
+                    {
+                        merged.indices.push_back(base_vertex + index);
+                    }
+                }
+                else
+                {
+                    for (std::uint32_t i = 0; i < mesh.vertices.size(); ++i)
+                    {
+                        merged.indices.push_back(base_vertex + i);
+                    }
+                }
+            }
+            batch.version++;
+        }
+    }
+
+    auto render_static_batches(const render_step& step) noexcept -> void
+    {
+        auto& static_batches = step.global_entity.get_or_set_component<fae::static_batches>(fae::static_batches{});
+        static_batches.merges = 0;
+
+        auto members = std::vector<std::vector<static_batches::member>>(static_batches.batches.size());
+        for (auto& [entity, model, static_model] : step.ecs_world.query<const fae::model, const fae::static_model>())
+        {
+            auto visible = true;
+            entity.use_component<const visibility>([&](const fae::visibility& visibility)
+                { visible = visibility.visible; });
+            if (!visible)
+            {
+                continue;
+            }
+            auto maybe_mesh = step.assets.get(model.mesh);
+            if (!maybe_mesh)
+            {
+                continue;
+            }
+            auto transform = fae::transform{};
+            entity.use_component<const fae::transform>([&](const fae::transform& t)
+                { transform = t; });
+
+            auto batch_index = static_cast<std::size_t>(&batch_of(static_batches, *maybe_mesh, model.material, static_model.group) - static_batches.batches.data());
+            members.resize(static_batches.batches.size());
+            members[batch_index].push_back(static_batches::member{
+                .id = entity.id,
+                .transform = transform.to_mat4(),
+                .mesh = model.mesh,
+                .mesh_version = maybe_mesh->version,
+            });
+        }
+
+        for (std::size_t i = 0; i < static_batches.batches.size(); ++i)
+        {
+            auto& batch = static_batches.batches[i];
+            if (batch.members == members[i])
+            {
+                continue;
+            }
+            batch.members = std::move(members[i]);
+            merge(batch, step.assets);
+            static_batches.merges++;
+        }
+        std::erase_if(static_batches.batches, [](const static_batches::batch& batch)
+            { return batch.members.empty(); });
+
+        for (const auto& batch : static_batches.batches)
+        {
+            step.render_pass.render_batch(render_pass::render_batch_args{
+                .mesh = batch.mesh,
+                .material = batch.material,
+                .id = batch.id,
+                .version = batch.version,
+            });
+        }
+    }
+}
@@ -3,11 +3,32 @@
 #include <stb/stb_image.h>
 
 #include "fae/logging.hpp"
+#include "fae/rendering/cooked_texture.hpp"
 
 namespace fae
 {
     auto texture::load(std::filesystem::path path) -> std::optional<texture>
     {
+        if (is_cooked_texture_path(path))
+        {
+            return load_cooked_texture(path);
+        }
+        if (is_compressed_texture_path(path))
+        {
+            auto maybe_compressed = compressed_texture::load(path);
+            if (!maybe_compressed)
+            {
+                return std::nullopt;
+            }
+            auto width = maybe_compressed->levels.front().width;
+            auto height = maybe_compressed->levels.front().height;
+            return texture{
+                .width = width,
+                .height = height,
+                .compressed = std::move(maybe_compressed),
+            };
+        }
+
         int width, height, channels;
         auto *img_data = stbi_load(path.string().c_str(), &width, &height, &channels, 0);
         if (!img_data)
@@ -0,0 +1,90 @@
+#include "fae/rendering/vertex_format.hpp"
+
+#include <cstring>
+
+#include <glm/gtc/packing.hpp>
+
+#include "fae/rendering/mesh.hpp"
+
+namespace fae
+{
+    auto vertex_stride(vertex_format format) noexcept -> std::size_t
+    {
+        switch (format)
+        {
+        case vertex_format::compact:
+            return sizeof(compact_vertex);
+        case vertex_format::compact_with_color:
+            return sizeof(compact_colored_vertex);
+        case vertex_format::standard:
+            break;
+        }
+        return sizeof(vertex);
+    }
+
+    auto octahedral_encode(vec3 normal) noexcept -> std::array<std::int16_t, 2>
+    {
+        auto length = math::abs(normal.x) + math::abs(normal.y) + math::abs(normal.z);
+        if (length == 0.f)
+        {
+            return { 0, 0 };
+        }
+        auto n = normal / length;
+        auto encoded = vec2(n.x, n.y);
+        if (n.z < 0.f)
+        {
+            // fold the lower hemisphere over the diagonals
+            encoded = (1.f - math::abs(vec2(n.y, n.x))) * vec2(n.x >= 0.f ? 1.f : -1.f, n.y >= 0.f ? 1.f : -1.f);
+        }
+        return {
+            static_cast<std::int16_t>(math::packSnorm1x16(encoded.x)),
+            static_cast<std::int16_t>(math::packSnorm1x16(encoded.y)),
+        };
+    }
+
+    auto octahedral_decode(std::array<std::int16_t, 2> encoded) noexcept -> vec3
+    {
+        auto e = vec2(
+            math::unpackSnorm1x16(static_cast<std::uint16_t>(encoded[0])),
+            math::unpackSnorm1x16(static_cast<std::uint16_t>(encoded[1])));
+        auto n = vec3(e.x, e.y, 1.f - math::abs(e.x) - math::abs(e.y));
+        auto t = math::clamp(-n.z, 0.f, 1.f);
+        n.x += n.x >= 0.f ? -t : t;
+        n.y += n.y >= 0.f ? -t : t;
+        return math::normalize(n);
+    }
+
+    auto pack_vertices(std::span<const vertex> vertices, vertex_format format) -> std::vector<std::uint8_t>
+    {
+        auto bytes = std::vector<std::uint8_t>(vertices.size() * vertex_stride(format));
+        if (format == vertex_format::standard)
+        {
+            std::memcpy(bytes.data(), vertices.data(), bytes.size());
+            return bytes;
+        }
+
+        auto stride = vertex_stride(format);
+        for (std::size_t i = 0; i < vertices.size(); ++i)
+        {
+            const auto& vertex = vertices[i];
+            auto packed = compact_colored_vertex{
+                .position = vertex.position,
+                .normal = octahedral_encode(vertex.normal),
+                .uv = { math::packHalf1x16(vertex.uv.x), math::packHalf1x16(vertex.uv.y) },
+            };
+            if (format == vertex_format::compact_with_color)
+            {
+                auto color = math::round(math::clamp(vertex.color, 0.f, 1.f) * 255.f);
+                packed.color = {
+                    static_cast<std::uint8_t>(color.r),
+                    static_cast<std::uint8_t>(color.g),
+                    static_cast<std::uint8_t>(color.b),
+                    static_cast<std::uint8_t>(color.a),
+                };
+            }
+            // compact_vertex is compact_colored_vertex without its trailing color
+            std::memcpy(bytes.data() + i * stride, &packed, stride);
+        }
+        return bytes;
+    }
+}
@@ -1,7 +1,15 @@
 #include "fae/rendering/webgpu_renderer.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <utility>
 
+#include "fae/asset_manager.hpp"
 #include "fae/core/vector.hpp"
 #include "fae/rendering/renderer.hpp"
 #include "fae/math.hpp"
@@ -12,8 +20,12 @@
 #include "fae/rendering/mesh.hpp"
 #include "fae/camera.hpp"
 #include "fae/lighting.hpp"
+#include "fae/rendering/frame_trace.hpp"
+#include "fae/rendering/gpu_frame_stats.hpp"
 #include "fae/rendering/material.hpp"
 #include "fae/rendering/render_pass.hpp"
+#include "fae/rendering/render_settings.hpp"
+#include "fae/rendering/render_stats.hpp"
 #include "fae/rendering/model.hpp"
 #include "fae/ecs_world.hpp"
 
@@ -21,8 +33,208 @@
 
 namespace fae
 {
+    namespace
+    {
+        /* a render command with everything but its geometry, null without an active camera */
+        auto make_render_command(fae::webgpu& webgpu, ecs_world& ecs_world, entity_commands& global_entity, fae::vertex_format vertex_format, asset_handle<material> material, const mat4& model_matrix) -> std::optional<fae::webgpu::render_pass::render_command>
+        {
+            auto render_command = std::optional<fae::webgpu::render_pass::render_command>();
+            global_entity.use_component<fae::active_camera>([&](active_camera active_camera)
+                {
+                    auto camera_entity = ecs_world.get_entity(active_camera.camera_entity);
+                    if (!camera_entity.valid())
+                        return;
+                    auto maybe_camera = camera_entity.get_component<fae::camera>();
+                    auto& camera = *maybe_camera;
+                    auto maybe_transform = camera_entity.get_component<fae::transform>();
+                    auto& camera_transform = *maybe_transform;
+
+                    local_uniforms_t local_uniforms;
+                    local_uniforms.view = math::lookAt(camera_transform.position, camera_transform.position + camera_transform.forward(), fae::vec3(0.f, 1.f, 0.f));
+                    auto aspect_ratio = static_cast<float>(webgpu.target.width) / static_cast<float>(std::max(webgpu.target.height, 1u));
+                    local_uniforms.projection = math::perspective(math::radians(camera.fov), aspect_ratio, camera.near_plane, camera.far_plane);
+                    local_uniforms.model = model_matrix;
+
+                    auto uniform_data = std::vector<std::uint8_t>(sizeof(local_uniforms_t));
+                    std::memcpy(uniform_data.data(), &local_uniforms, sizeof(local_uniforms_t));
+
+                    render_command = fae::webgpu::render_pass::render_command{
+                        .vertex_format = vertex_format,
+                        .uniform_data = uniform_data,
+                        .material = material,
+                    };
+                });
+            return render_command;
+        }
+
+        struct material_binding
+        {
+            wgpu::BindGroup bind_group;
+            /* goes into the draw's uniforms, the layer of the bind group's texture array */
+            std::uint32_t texture_layer = 0;
+        };
+
+        /* materials share an array's bind group when their parameters are equal too */
+        auto array_material_key(std::uint32_t array, const color& base_color) noexcept -> std::uint64_t
+        {
+            return (static_cast<std::uint64_t>(array) << 32) | (static_cast<std::uint64_t>(base_color.r) << 24) | (static_cast<std::uint64_t>(base_color.g) << 16) | (static_cast<std::uint64_t>(base_color.b) << 8) | base_color.a;
+        }
+
+        /* writes the material's parameters into gpu_material's uniform buffer when they differ from what it holds, the bind group stays valid */
+        auto write_material_uniforms(fae::webgpu& webgpu, fae::webgpu::render_pipeline::gpu_material& gpu_material, const material& material) -> void
+        {
+            if (gpu_material.base_color == material.base_color)
+            {
+                return;
+            }
+            auto material_uniforms = material_uniforms_t{ .base_color = material.base_color.to_vec4() };
+            webgpu.uploads.write_buffer(webgpu.device, gpu_material.uniform_buffer, 0, &material_uniforms, sizeof(material_uniforms_t));
+            webgpu.frame_bytes_uploaded += sizeof(material_uniforms_t);
+            gpu_material.base_color = material.base_color;
+        }
+
+        /* bakes the material's parameters, texture & the shared sampler into gpu_material's bind group */
+        auto bake_material(fae::webgpu& webgpu, fae::webgpu::render_pipeline& render_pipeline, fae::webgpu::render_pipeline::gpu_material& gpu_material, const material& material, const wgpu::Texture& texture, const wgpu::TextureView& texture_view) -> void
+        {
+            if (!gpu_material.uniform_buffer)
+            {
+                gpu_material.uniform_buffer = create_buffer(webgpu.device, "fae_material_uniform_buffer", sizeof(material_uniforms_t), wgpu::BufferUsage::Uniform);
+                gpu_material.base_color.reset();
+            }
+            write_material_uniforms(webgpu, gpu_material, material);
+            if (!webgpu.material_sampler)
+            {
+                auto sampler_descriptor = wgpu::SamplerDescriptor{
+                    .addressModeU = wgpu::AddressMode::Repeat,
+                    .addressModeV = wgpu::AddressMode::Repeat,
+                    .addressModeW = wgpu::AddressMode::Repeat,
+                    .magFilter = wgpu::FilterMode::Nearest,
+                    .minFilter = wgpu::FilterMode::Nearest,
+                    .mipmapFilter = wgpu::MipmapFilterMode::Nearest,
+                    .lodMinClamp = 0.f,
+                    .lodMaxClamp = 32.f,
+                    .compare = wgpu::CompareFunction::Undefined,
+                    .maxAnisotropy = 1,
+                };
+                webgpu.material_sampler = webgpu.device.CreateSampler(&sampler_descriptor);
+            }
+
+            auto bind_entries = std::vector<wgpu::BindGroupEntry>{
+                wgpu::BindGroupEntry{
+                    .binding = 0,
+                    .buffer = gpu_material.uniform_buffer,
+                    .size = sizeof(material_uniforms_t),
+                },
+                wgpu::BindGroupEntry{
+                    .binding = 1,
+                    .textureView = texture_view,
+                },
+                wgpu::BindGroupEntry{
+                    .binding = 2,
+                    .sampler = webgpu.material_sampler,
+                },
+            };
+            auto bind_group_descriptor = wgpu::BindGroupDescriptor{
+                .label = "fae_material_bind_group",
+                .layout = render_pipeline.material_bind_group_layout,
+                .entryCount = static_cast<std::size_t>(bind_entries.size()),
+                .entries = bind_entries.data(),
+            };
+            gpu_material.bind_group = webgpu.device.CreateBindGroup(&bind_group_descriptor);
+            gpu_material.texture = texture;
+        }
+
+        /*
+        the material's bind group, baked the first time it is drawn & again only when its texture was evicted & uploaded anew
+        edits to the material through assets.get() are picked up here: a new base color is written into the bound uniform buffer
+        with texture arrays the bind group of the material's array is returned instead, along with its layer
+        null handles & removed materials draw with the default material
+        */
+        auto acquire_material(fae::webgpu& webgpu, asset_manager& assets, fae::webgpu::render_pipeline& render_pipeline, asset_handle<material> handle, bool texture_arrays) -> material_binding
+        {
+            if (!webgpu.default_material.valid())
+            {
+                webgpu.default_material = assets.add(material{});
+                webgpu.white_texture = assets.add(texture{
+                    .width = 1,
+                    .height = 1,
+                    .data = { colors::white },
+                });
+            }
+            auto maybe_material = assets.get(handle);
+            if (!maybe_material)
+            {
+                handle = webgpu.default_material;
+                maybe_material = assets.get(handle);
+            }
+            const auto& material = *maybe_material;
+
+            // textures still loading are drawn white until then, the bind group is baked again once they are ready
+            auto texture_handle = assets.state(material.diffuse) == asset_load_state::ready ? material.diffuse : webgpu.white_texture;
+            const auto& diffuse = *assets.get(texture_handle);
+            if (texture_arrays)
+            {
+                if (auto slot = webgpu.texture_arrays.acquire(webgpu.device, diffuse, texture_handle, webgpu.uploads))
+                {
+                    auto& gpu_material = render_pipeline.array_materials[array_material_key(slot->array, material.base_color)];
+                    if (!gpu_material.bind_group)
+                    {
+                        // arrays never move, the bind group stays valid as long as the array does
+                        bake_material(webgpu, render_pipeline, gpu_material, material, nullptr, webgpu.texture_arrays.view(slot->array));
+                    }
+                    return material_binding{ .bind_group = gpu_material.bind_group, .texture_layer = slot->layer };
+                }
+            }
+
+            auto resident = webgpu.textures.acquire(webgpu.device, diffuse, texture_handle, &webgpu.uploads);
+            auto& gpu_material = render_pipeline.materials[handle];
+            if (!gpu_material.bind_group || gpu_material.texture.Get() != resident.texture.Get())
+            {
+                // the shader samples a texture array, textures of their own are its only layer
+                auto view_descriptor = wgpu::TextureViewDescriptor{ .dimension = wgpu::TextureViewDimension::e2DArray };
+                bake_material(webgpu, render_pipeline, gpu_material, material, resident.texture, resident.texture.CreateView(&view_descriptor));
+            }
+            else
+            {
+                write_material_uniforms(webgpu, gpu_material, material);
+            }
+            return material_binding{ .bind_group = gpu_material.bind_group };
+        }
+
+        /* feeds the frame's time to the dynamic resolution, gpu time when measured with timestamps & the time between frames otherwise */
+        auto update_dynamic_resolution(fae::webgpu& webgpu, entity_commands& global_entity) -> void
+        {
+            const auto& settings = global_entity.get_or_set_component<fae::render_settings>(fae::render_settings{}).dynamic_resolution;
+            auto previous_frame_begin = std::exchange(webgpu.previous_frame_begin, webgpu.frame.begin_time);
+            if (!settings.enabled)
+            {
+                webgpu.resolution.reset();
+                return;
+            }
+            auto gpu_timed = false;
+            auto frame_ms = std::optional<float>();
+            global_entity.use_component<const fae::gpu_frame_stats>([&](const fae::gpu_frame_stats& stats)
+                {
+                    gpu_timed = stats.supported;
+                    // timings are republished until a newer frame is measured, each frame is fed once
+                    if (stats.supported && !stats.passes.empty() && webgpu.resolution_measured_frame != stats.frame)
+                    {
+                        webgpu.resolution_measured_frame = stats.frame;
+                        frame_ms = stats.total.seconds_f32() * 1000.f;
+                    } });
+            if (!gpu_timed && previous_frame_begin)
+            {
+                frame_ms = std::chrono::duration<float, std::milli>(webgpu.frame.begin_time - *previous_frame_begin).count();
+            }
+            if (frame_ms)
+            {
+                webgpu.resolution.update(*frame_ms, settings);
+            }
+        }
+    }
+
     [[nodiscard]] auto
-    make_webgpu_renderer(ecs_world& ecs_world, entity_commands& global_entity) noexcept -> renderer
+    make_webgpu_renderer(ecs_world& ecs_world, entity_commands& global_entity, asset_manager& assets) noexcept -> renderer
     {
         return renderer{
             .get_clear_color =
@@ -66,23 +278,154 @@ namespace fae
                 global_entity.use_component<fae::webgpu>(
                     [&](webgpu& webgpu)
                     {
+                        // the first pass of a frame sets up the frame's render graph, end_frame executes it
+                        if (!webgpu.frame.begun)
+                        {
+                            webgpu.graph.reset();
+                            webgpu.frame = webgpu::frame_state{
+                                .begun = true,
+                                .begin_time = std::chrono::steady_clock::now(),
+                            };
+                            // blocks while max_frames_in_flight frames are still on the gpu, counted in the frame's latency
+                            webgpu.frames.begin_frame(webgpu.instance);
+                            // materials go back to textures of their own, the arrays' blocks are freed
+                            if (!global_entity.get_or_set_component<fae::render_settings>(fae::render_settings{}).texture_arrays && webgpu.texture_arrays.array_count() > 0)
+                            {
+                                webgpu.texture_arrays.clear();
+                                for (auto& pipeline : webgpu.render_pipelines)
+                                {
+                                    pipeline.array_materials.clear();
+                                }
+                            }
+                            if (webgpu.target.offscreen_texture)
+                            {
+                                webgpu.frame.target_view = webgpu.target.offscreen_texture.CreateView();
+                            }
+                            else
+                            {
+                                wgpu::SurfaceTexture surface_texture;
+                                webgpu.surface.GetCurrentTexture(&surface_texture);
+                                if (surface_texture.status == wgpu::SurfaceGetCurrentTextureStatus::Success)
+                                {
+                                    webgpu.frame.target_view = surface_texture.texture.CreateView();
+                                }
+                            }
+                            if (webgpu.frame.target_view)
+                            {
+                                webgpu.frame.target = webgpu.graph.import_texture("fae_target", webgpu.frame.target_view,
+                                    render_graph::texture_desc{ .format = webgpu.target.format, .width = webgpu.target.width, .height = webgpu.target.height });
+                                webgpu.graph.mark_output(webgpu.frame.target);
+                                // scaled scenes get their own color texture, its size only changes with the scale's bucket so the pooled textures are reused
+                                auto scale = global_entity.get_or_set_component<fae::render_settings>(fae::render_settings{}).dynamic_resolution.enabled ? webgpu.resolution.scale : 1.f;
+                                webgpu.frame.scene_width = scaled_extent(webgpu.target.width, scale);
+                                webgpu.frame.scene_height = scaled_extent(webgpu.target.height, scale);
+                                webgpu.frame.scene_color = webgpu.frame.target;
+                                if (webgpu.frame.scene_width != webgpu.target.width || webgpu.frame.scene_height != webgpu.target.height)
+                                {
+                                    webgpu.frame.scene_color = webgpu.graph.create_texture("fae_scene_color",
+                                        render_graph::texture_desc{
+                                            .format = webgpu.target.format,
+                                            .width = webgpu.frame.scene_width,
+                                            .height = webgpu.frame.scene_height,
+                                            .usage = wgpu::TextureUsage::RenderAttachment | wgpu::TextureUsage::TextureBinding,
+                                        });
+                                }
+                                webgpu.frame.occlusion_culling = webgpu.gpu_driven.instance_count() > 0 && global_entity.get_or_set_component<fae::render_settings>(fae::render_settings{}).occlusion_culling;
+                                webgpu.frame.depth = webgpu.graph.create_texture("fae_depth",
+                                    render_graph::texture_desc{
+                                        .format = webgpu.depth_texture_format,
+                                        .width = webgpu.frame.scene_width,
+                                        .height = webgpu.frame.scene_height,
+                                        .usage = webgpu.frame.occlusion_culling ? wgpu::TextureUsage::RenderAttachment | wgpu::TextureUsage::TextureBinding : wgpu::TextureUsage::RenderAttachment,
+                                    });
+                                if (webgpu.gpu_driven.instance_count() > 0)
+                                {
+                                    webgpu.frame.gpu_driven_instances = webgpu.graph.import_buffer("fae_gpu_driven_visible_instances");
+                                    webgpu.graph.add_pass(render_graph::pass{
+                                        .name = "fae_gpu_driven_cull",
+                                        .writes = { webgpu.frame.gpu_driven_instances },
+                                        .record_commands = [&webgpu](const wgpu::CommandEncoder& command_encoder)
+                                        {
+                                            if (webgpu.frame.gpu_driven_prepared)
+                                            {
+                                                webgpu.gpu_driven.record_culling(command_encoder);
+                                            }
+                                        },
+                                    });
+                                }
+                            }
+                        }
+
                         auto webgpu_render_pass = webgpu::render_pass{
                             .render_pipeline_id = render_pipeline.get_id(),
                             .render_commands = std::vector<webgpu::render_pass::render_command>(),
                             .label = "fae_render_pass",
+                            .depth_prepass = global_entity.get_or_set_component<fae::render_settings>(fae::render_settings{}).depth_prepass,
                         };
                         id = webgpu.render_passes.size();
                         webgpu.render_passes.push_back(webgpu_render_pass);
-                        render_pipeline.prepare_render_pass(id);
-
-                        // auto ui_render_pass = webgpu::render_pass{
-                        //     .render_pipeline_id = render_pipeline.get_id(),
-                        //     .render_commands = std::vector<webgpu::render_pass::render_command>(),
-                        //     .label = "fae_ui_render_pass",
-                        // };
-                        // id = webgpu.render_passes.size();
-                        // webgpu.render_passes.push_back(ui_render_pass);
-                        // render_pipeline.prepare_render_pass(id);
+                        if (webgpu.frame.target_view)
+                        {
+                            render_pipeline.prepare_render_pass(id);
+                            // the first scene pass drew what was visible last frame, its depth is what the rest is tested against
+                            if (webgpu.frame.occlusion_culling && !webgpu.frame.gpu_driven_late_declared)
+                            {
+                                webgpu.frame.gpu_driven_late_declared = true;
+                                auto hiz = webgpu.graph.import_buffer("fae_hiz");
+                                webgpu.graph.add_pass(render_graph::pass{
+                                    .name = "fae_hiz_build",
+                                    .reads = { webgpu.frame.depth },
+                                    .writes = { hiz },
+                                    .record_commands = [&webgpu, depth = webgpu.frame.depth](const wgpu::CommandEncoder& command_encoder)
+                                    {
+                                        if (webgpu.frame.gpu_driven_prepared)
+                                        {
+                                            webgpu.gpu_driven.record_hiz(webgpu.device, command_encoder, webgpu.graph.texture_view(depth));
+                                        }
+                                    },
+                                });
+                                webgpu.graph.add_pass(render_graph::pass{
+                                    .name = "fae_gpu_driven_cull_late",
+                                    .reads = { hiz },
+                                    .writes = { webgpu.frame.gpu_driven_instances },
+                                    .record_commands = [&webgpu](const wgpu::CommandEncoder& command_encoder)
+                                    {
+                                        if (webgpu.frame.gpu_driven_prepared)
+                                        {
+                                            webgpu.gpu_driven.record_culling(command_encoder, fae::gpu_driven_renderer::cull_phase::late);
+                                        }
+                                    },
+                                });
+                                webgpu.graph.add_pass(render_graph::pass{
+                                    .name = "fae_gpu_driven_late",
+                                    .color_attachments = {
+                                        render_graph::color_attachment{ .texture = webgpu.frame.scene_color, .load_op = wgpu::LoadOp::Load },
+                                    },
+                                    .depth_attachment = render_graph::depth_attachment{ .texture = webgpu.frame.depth, .load_op = wgpu::LoadOp::Load },
+                                    .reads = { webgpu.frame.gpu_driven_instances },
+                                    .record_render_pass = [&webgpu](const wgpu::RenderPassEncoder& render_pass_encoder)
+                                    {
+                                        if (webgpu.frame.gpu_driven_prepared)
+                                        {
+                                            webgpu.gpu_driven.draw(render_pass_encoder, fae::gpu_driven_renderer::cull_phase::late);
+                                        }
+                                    },
+                                });
+                            }
+                            // declared after the pass' scene passes & before the ui's, which draws over the upscaled scene at full resolution
+                            if (webgpu.frame.scene_color != webgpu.frame.target)
+                            {
+                                webgpu.graph.add_pass(render_graph::pass{
+                                    .name = "fae_upscale",
+                                    .color_attachments = {
+                                        render_graph::color_attachment{ .texture = webgpu.frame.target, .clear_value = webgpu.clear_color },
+                                    },
+                                    .reads = { webgpu.frame.scene_color },
+                                    .record_render_pass = [&webgpu, scene_color = webgpu.frame.scene_color](const wgpu::RenderPassEncoder& render_pass_encoder)
+                                    { webgpu.upscaler.record(webgpu.device, render_pass_encoder, webgpu.graph.texture_view(scene_color), webgpu.target.format); },
+                                });
+                            }
+                        }
                     });
 
                 return fae::render_pass{
@@ -101,6 +444,26 @@ namespace fae
                               auto& render_pass = webgpu.render_passes[id];
                               auto& render_pipeline = webgpu.render_pipelines[render_pass.render_pipeline_id];
 
+                              if (!webgpu.ambient_light_info_buffer)
+                              {
+                                  webgpu.ambient_light_info_buffer = create_buffer(webgpu.device, "fae_ambient_light_info_buffer", sizeof(fae::ambient_light_info), wgpu::BufferUsage::Uniform);
+                                  webgpu.directional_light_info_buffer = create_buffer(webgpu.device, "fae_directional_light_info_buffer", sizeof(fae::directional_light_info), wgpu::BufferUsage::Uniform);
+                              }
+                              auto lighting_version = global_entity.get_or_set_component<fae::lighting_version>(fae::lighting_version{}).value;
+                              if (webgpu.uploaded_lighting_version != lighting_version)
+                              {
+                                  global_entity.use_component<fae::ambient_light_info>([&](const fae::ambient_light_info& info)
+                                      {
+                                          webgpu.uploads.write_buffer(webgpu.device, webgpu.ambient_light_info_buffer, 0, &info, sizeof(fae::ambient_light_info));
+                                          webgpu.frame_bytes_uploaded += sizeof(fae::ambient_light_info); });
+                                  global_entity.use_component<fae::directional_light_info>([&](const fae::directional_light_info& info)
+                                      {
+                                          webgpu.uploads.write_buffer(webgpu.device, webgpu.directional_light_info_buffer, 0, &info, sizeof(fae::directional_light_info));
+                                          webgpu.frame_bytes_uploaded += sizeof(fae::directional_light_info); });
+                                  webgpu.uploaded_lighting_version = lighting_version;
+                              }
+
+                              // pipelines compile asynchronously, draws are skipped when the graph records them until their pipeline is ready
                               if (!render_pass.render_commands.empty())
                               {
                                   global_entity.use_component<fae::active_camera>([&](active_camera active_camera)
@@ -119,170 +482,353 @@ namespace fae
                             auto t = time.elapsed().seconds_f32();
                             global_uniforms.time = t;
 
-                            auto global_uniforms_buffer = create_buffer(webgpu.device, "fae_global_uniforms_buffer", sizeof(global_uniforms_t), wgpu::BufferUsage::Uniform);
+                            auto global_uniforms_buffer = webgpu.frames.acquire_buffer(webgpu.device, "fae_global_uniforms_buffer", sizeof(global_uniforms_t), wgpu::BufferUsage::Uniform);
+
+                            // materials first, with texture arrays their layer goes into the draw's uniforms
+                            auto texture_arrays = global_entity.get_or_set_component<fae::render_settings>(fae::render_settings{}).texture_arrays;
+                            auto material_bindings = std::vector<material_binding>();
+                            material_bindings.reserve(render_pass.render_commands.size());
+                            for (const auto& render_command : render_pass.render_commands)
+                            {
+                                material_bindings.push_back(acquire_material(webgpu, assets, render_pipeline, render_command.material, texture_arrays));
+                            }
+                            webgpu.frame_bytes_uploaded += webgpu.texture_arrays.take_bytes_uploaded();
 
                             std::vector<std::uint8_t> local_uniform_data;
-                            for (auto& render_command : render_pass.render_commands)
+                            for (std::size_t i = 0; i < render_pass.render_commands.size(); ++i)
                             {
                                 auto data = std::vector<std::uint8_t>(render_pipeline.uniform_stride, 0);
-                                std::memcpy(data.data(), render_command.uniform_data.data(), sizeof(local_uniforms_t));
+                                std::memcpy(data.data(), render_pass.render_commands[i].uniform_data.data(), sizeof(local_uniforms_t));
+                                std::memcpy(data.data() + offsetof(local_uniforms_t, texture_layer), &material_bindings[i].texture_layer, sizeof(std::uint32_t));
                                 local_uniform_data.insert(local_uniform_data.end(), data.begin(), data.end());
                             }
-                            auto sizeof_uniforms = local_uniform_data.size() * render_pipeline.uniform_stride;
-                            auto local_uniforms_buffer = create_buffer(webgpu.device, "fae_local_uniforms_buffer", sizeof_uniforms, wgpu::BufferUsage::Uniform);
+                            auto local_uniforms_buffer = webgpu.frames.acquire_buffer(webgpu.device, "fae_local_uniforms_buffer", sizeof_data(local_uniform_data), wgpu::BufferUsage::Uniform);
 
-                            auto queue = webgpu.device.GetQueue();
+                            webgpu.uploads.write_buffer(webgpu.device, global_uniforms_buffer, 0, &global_uniforms, sizeof(global_uniforms_t));
+                            webgpu.uploads.write_buffer(webgpu.device, local_uniforms_buffer, 0, local_uniform_data.data(), sizeof_data(local_uniform_data));
 
-                            queue.WriteBuffer(global_uniforms_buffer, 0, &global_uniforms, sizeof(global_uniforms_t));
-                            queue.WriteBuffer(local_uniforms_buffer, 0, local_uniform_data.data(), sizeof_data(local_uniform_data));
+                            webgpu.frame_bytes_uploaded += sizeof(global_uniforms_t) + sizeof_data(local_uniform_data);
 
-                            auto ambient_light_info_buffer = create_buffer(webgpu.device, "ambient_light_info_buffer", sizeof(fae::directional_light_info), wgpu::BufferUsage::Uniform);
-                            global_entity.use_component<fae::ambient_light_info>([&](fae::ambient_light_info info)
-                                { queue.WriteBuffer(ambient_light_info_buffer, 0, &info, sizeof(fae::ambient_light_info)); });
-
-                            auto directional_light_info_buffer = create_buffer(webgpu.device, "fae_directional_light_info_buffer", sizeof(fae::directional_light_info), wgpu::BufferUsage::Uniform);
-                            global_entity.use_component<fae::directional_light_info>([&](fae::directional_light_info info)
-                                { queue.WriteBuffer(directional_light_info_buffer, 0, &info, sizeof(fae::directional_light_info)); });
+                            auto frame_entries = std::vector<wgpu::BindGroupEntry>{
+                                wgpu::BindGroupEntry{
+                                    .binding = 0,
+                                    .buffer = global_uniforms_buffer,
+                                    .size = sizeof(global_uniforms_t),
+                                },
+                                wgpu::BindGroupEntry{
+                                    .binding = 1,
+                                    .buffer = webgpu.ambient_light_info_buffer,
+                                    .size = sizeof(fae::ambient_light_info),
+                                },
+                                wgpu::BindGroupEntry{
+                                    .binding = 2,
+                                    .buffer = webgpu.directional_light_info_buffer,
+                                    .size = sizeof(fae::directional_light_info),
+                                },
+                            };
+                            auto frame_bind_group_descriptor = wgpu::BindGroupDescriptor{
+                                .label = "fae_frame_bind_group",
+                                .layout = render_pipeline.frame_bind_group_layout,
+                                .entryCount = static_cast<std::size_t>(frame_entries.size()),
+                                .entries = frame_entries.data(),
+                            };
+                            render_pass.frame_bind_group = webgpu.device.CreateBindGroup(&frame_bind_group_descriptor);
+                            auto object_entry = wgpu::BindGroupEntry{
+                                .binding = 0,
+                                .buffer = local_uniforms_buffer,
+                                .size = sizeof(local_uniforms_t),
+                            };
+                            auto object_bind_group_descriptor = wgpu::BindGroupDescriptor{
+                                .label = "fae_object_bind_group",
+                                .layout = render_pipeline.object_bind_group_layout,
+                                .entryCount = 1,
+                                .entries = &object_entry,
+                            };
+                            render_pass.object_bind_group = webgpu.device.CreateBindGroup(&object_bind_group_descriptor);
 
                             std::uint32_t uniform_offset = 0;
-                            for (auto& render_command : render_pass.render_commands)
+                            auto previous_material = static_cast<WGPUBindGroup>(nullptr);
+                            for (std::size_t i = 0; i < render_pass.render_commands.size(); ++i)
                             {
-                                auto bind_entries = std::vector<wgpu::BindGroupEntry>{
-                                    wgpu::BindGroupEntry{
-                                        .binding = 0,
-                                        .buffer = global_uniforms_buffer,
-                                        .size = sizeof(global_uniforms_t),
-                                    },
-                                    wgpu::BindGroupEntry{
-                                        .binding = 1,
-                                        .buffer = local_uniforms_buffer,
-                                        .size = sizeof(local_uniforms_t),
-                                    },
-                                    wgpu::BindGroupEntry{
-                                        .binding = 2,
-                                        .textureView = render_command.texture_view,
-                                    },
-                                    wgpu::BindGroupEntry{
-                                        .binding = 3,
-                                        .sampler = render_command.sampler,
-                                    },
-                                    wgpu::BindGroupEntry{
-                                        .binding = 4,
-                                        .buffer = ambient_light_info_buffer,
-                                        .size = sizeof(fae::ambient_light_info),
-                                    },
-                                    wgpu::BindGroupEntry{
-                                        .binding = 5,
-                                        .buffer = directional_light_info_buffer,
-                                        .size = sizeof(fae::directional_light_info),
-                                    },
-                                };
-                                auto bind_group_descriptor = wgpu::BindGroupDescriptor{
-                                    .label = "fae_bind_group",
-                                    .layout = render_pipeline.render_pipeline.GetBindGroupLayout(0),
-                                    .entryCount = static_cast<std::size_t>(bind_entries.size()),
-                                    .entries = bind_entries.data(),
-                                };
-
-                                auto uniform_bind_group = webgpu.device.CreateBindGroup(&bind_group_descriptor);
-                                render_pass.render_pass_encoder.SetBindGroup(0, uniform_bind_group, 1, &uniform_offset);
-                                uniform_offset += render_pipeline.uniform_stride;
-
-                                const auto vertex_buffer = create_buffer_with_data(
-                                    webgpu.device, "indexed_render_data_vertex_buffer", render_command.vertex_data.data(), sizeof_data(render_command.vertex_data),
-                                    wgpu::BufferUsage::Vertex);
-                                render_pass.render_pass_encoder.SetVertexBuffer(0, vertex_buffer);
-                                if (!render_command.index_data.empty())
+                                const auto& render_command = render_pass.render_commands[i];
+                                auto material_bind_group = std::move(material_bindings[i].bind_group);
+                                if (material_bind_group.Get() != previous_material)
                                 {
-                                    const auto index_buffer = create_buffer_with_data(
-                                        webgpu.device, "indexed_render_data_index_buffer", render_command.index_data.data(), sizeof_data(render_command.index_data),
-                                        wgpu::BufferUsage::Index);
-                                    render_pass.render_pass_encoder.SetIndexBuffer(index_buffer, wgpu::IndexFormat::Uint32);
-                                    render_pass.render_pass_encoder.DrawIndexed(render_command.index_data.size());
+                                    render_pass.material_binds++;
+                                    previous_material = material_bind_group.Get();
                                 }
-                                else
+                                if (render_command.static_batch_id != 0)
                                 {
-                                    render_pass.render_pass_encoder.Draw(render_command.vertex_data.size());
+                                    const auto& buffers = webgpu.static_batch_buffers[render_command.static_batch_id];
+                                    render_pass.draws.push_back(webgpu::render_pass::draw{
+                                        .material_bind_group = std::move(material_bind_group),
+                                        .uniform_offset = uniform_offset,
+                                        .vertex_buffer = buffers.vertex_buffer,
+                                        .vertex_format = render_command.vertex_format,
+                                        .index_buffer = buffers.index_buffer,
+                                        .count = buffers.index_count,
+                                    });
+                                    uniform_offset += render_pipeline.uniform_stride;
+                                    continue;
                                 }
+
+                                // unloaded since it was rendered
+                                auto buffers = webgpu.mesh_buffers.find(render_command.mesh);
+                                if (buffers != webgpu.mesh_buffers.end())
+                                {
+                                    render_pass.draws.push_back(webgpu::render_pass::draw{
+                                        .material_bind_group = std::move(material_bind_group),
+                                        .uniform_offset = uniform_offset,
+                                        .vertex_buffer = buffers->second.vertex_buffer,
+                                        .vertex_format = render_command.vertex_format,
+                                        .index_buffer = buffers->second.index_buffer,
+                                        .count = buffers->second.count,
+                                    });
+                                }
+                                uniform_offset += render_pipeline.uniform_stride;
                             } });
                               }
 
-                              render_pass.render_pass_encoder.End();
-                              auto command_buffer = render_pass.command_encoder.Finish();
+                              // uploads the instances' data, the frame's graph records the culling & draws
+                              if (webgpu.gpu_driven.instance_count() > 0)
+                              {
+                                  global_entity.use_component<fae::active_camera>([&](active_camera active_camera)
+                                      {
+                                          auto camera_entity = ecs_world.get_entity(active_camera.camera_entity);
+                                          if (!camera_entity.valid())
+                                              return;
+                                          auto maybe_camera = camera_entity.get_component<fae::camera>();
+                                          auto& camera = *maybe_camera;
+                                          auto maybe_camera_transform = camera_entity.get_component<fae::transform>();
+                                          auto& camera_transform = *maybe_camera_transform;
+                                          auto aspect_ratio = static_cast<float>(webgpu.target.width) / static_cast<float>(std::max(webgpu.target.height, 1u));
+                                          auto time = global_entity.get_or_set_component<fae::time>(fae::time{});
 
-                              auto commands = std::vector<wgpu::CommandBuffer>{ command_buffer };
-                              webgpu.device.GetQueue().Submit(commands.size(), commands.data());
-#ifndef FAE_PLATFORM_WEB
-                              webgpu.surface.Present();
-                              webgpu.instance.ProcessEvents();
-#endif
-                              webgpu.render_passes.erase(webgpu.render_passes.begin() + id);
+                                          webgpu.frame.gpu_driven_prepared = webgpu.gpu_driven.prepare(webgpu.device, webgpu.textures, webgpu.uploads, webgpu.target.format, webgpu.depth_texture_format,
+                                              fae::gpu_driven_renderer::frame{
+                                                  .view = math::lookAt(camera_transform.position, camera_transform.position + camera_transform.forward(), fae::vec3(0.f, 1.f, 0.f)),
+                                                  .projection = math::perspective(math::radians(camera.fov), aspect_ratio, camera.near_plane, camera.far_plane),
+                                                  .camera_world_position = camera_transform.position,
+                                                  .time = time.elapsed().seconds_f32(),
+                                                  .ambient_light_info_buffer = webgpu.ambient_light_info_buffer,
+                                                  .directional_light_info_buffer = webgpu.directional_light_info_buffer,
+                                                  .depth_width = webgpu.frame.scene_width,
+                                                  .depth_height = webgpu.frame.scene_height,
+                                                  .occlusion_culling = webgpu.frame.occlusion_culling,
+                                              }); });
+                                  webgpu.frame_bytes_uploaded += webgpu.gpu_driven.take_bytes_uploaded();
+                              }
                           }); },
                     .render_model = [&, id](const fae::render_pass::render_model_args& args)
                     { global_entity.use_component<fae::webgpu>([&, id](fae::webgpu& webgpu)
                           {
-                            auto &render_pass = webgpu.render_passes[id];
-
-                        local_uniforms_t local_uniforms;
-                        global_entity.use_component<fae::active_camera>([&](active_camera active_camera)
+                              auto maybe_mesh = assets.get(args.model.mesh);
+                              if (!maybe_mesh || maybe_mesh->vertices.empty())
+                              {
+                                  return;
+                              }
+                              const auto& mesh = *maybe_mesh;
+                              auto render_command = make_render_command(webgpu, ecs_world, global_entity, mesh.format, args.model.material, args.transform.to_mat4());
+                              if (!render_command)
+                              {
+                                  return;
+                              }
+                              // uploaded once (& again when the mesh's version changes), every model using the mesh draws from the same buffers
+                              auto& buffers = webgpu.mesh_buffers[args.model.mesh];
+                              if (!buffers.vertex_buffer || buffers.version != mesh.version)
+                              {
+                                  // not destroyed, draws recorded this frame may still use the previous buffers
+                                  buffers = fae::webgpu::gpu_mesh{ .version = mesh.version };
+                                  // standard vertices are uploaded as they are, compact ones packed first
+                                  auto packed_vertices = std::vector<std::uint8_t>();
+                                  auto vertex_bytes = std::span<const std::uint8_t>(reinterpret_cast<const std::uint8_t*>(mesh.vertices.data()), sizeof_data(mesh.vertices));
+                                  if (mesh.format != vertex_format::standard)
+                                  {
+                                      packed_vertices = pack_vertices(mesh.vertices, mesh.format);
+                                      vertex_bytes = packed_vertices;
+                                  }
+                                  buffers.vertex_buffer = create_buffer_with_data(webgpu.device, "fae_mesh_vertex_buffer", vertex_bytes.data(), vertex_bytes.size(), wgpu::BufferUsage::Vertex, &webgpu.uploads);
+                                  buffers.count = static_cast<std::uint32_t>(mesh.vertices.size());
+                                  webgpu.frame_bytes_uploaded += vertex_bytes.size();
+                                  if (mesh.has_indices())
+                                  {
+                                      buffers.index_buffer = create_buffer_with_data(webgpu.device, "fae_mesh_index_buffer", mesh.indices.data(), sizeof_data(mesh.indices), wgpu::BufferUsage::Index, &webgpu.uploads);
+                                      buffers.count = static_cast<std::uint32_t>(mesh.indices.size());
+                                      webgpu.frame_bytes_uploaded += sizeof_data(mesh.indices);
+                                  }
+                              }
+                              render_command->mesh = args.model.mesh;
+                              webgpu.render_passes[id].render_commands.push_back(std::move(*render_command)); }); },
+                    .render_batch = [&, id](const fae::render_pass::render_batch_args& args)
+                    { global_entity.use_component<fae::webgpu>([&, id](fae::webgpu& webgpu)
+                          {
+                              auto render_command = make_render_command(webgpu, ecs_world, global_entity, args.mesh.format, args.material, mat4{ 1.f });
+                              if (!render_command || args.mesh.indices.empty())
+                              {
+                                  return;
+                              }
+                              // the merged mesh is only uploaded when the batch changed, other frames draw from its gpu copy
+                              auto& buffers = webgpu.static_batch_buffers[args.id];
+                              if (!buffers.vertex_buffer || buffers.version != args.version)
+                              {
+                                  auto packed_vertices = std::vector<std::uint8_t>();
+                                  auto vertex_bytes = std::span<const std::uint8_t>(reinterpret_cast<const std::uint8_t*>(args.mesh.vertices.data()), sizeof_data(args.mesh.vertices));
+                                  if (args.mesh.format != vertex_format::standard)
+                                  {
+                                      packed_vertices = pack_vertices(args.mesh.vertices, args.mesh.format);
+                                      vertex_bytes = packed_vertices;
+                                  }
+                                  for (auto* buffer : { &buffers.vertex_buffer, &buffers.index_buffer })
+                                  {
+                                      if (*buffer)
+                                      {
+                                          buffer->Destroy();
+                                      }
+                                  }
+                                  buffers.vertex_buffer = create_buffer_with_data(webgpu.device, "fae_static_batch_vertex_buffer", vertex_bytes.data(), vertex_bytes.size(), wgpu::BufferUsage::Vertex, &webgpu.uploads);
+                                  buffers.index_buffer = create_buffer_with_data(webgpu.device, "fae_static_batch_index_buffer", args.mesh.indices.data(), sizeof_data(args.mesh.indices), wgpu::BufferUsage::Index, &webgpu.uploads);
+                                  buffers.index_count = static_cast<std::uint32_t>(args.mesh.indices.size());
+                                  buffers.version = args.version;
+                                  webgpu.frame_bytes_uploaded += vertex_bytes.size() + sizeof_data(args.mesh.indices);
+                              }
+                              buffers.last_used_frame = webgpu.frames_submitted;
+                              render_command->static_batch_id = args.id;
+                              webgpu.render_passes[id].render_commands.push_back(std::move(*render_command)); }); },
+                };
+            },
+            .end_frame =
+                [&]()
+            {
+                global_entity.use_component<fae::webgpu>(
+                    [&](webgpu& webgpu)
+                    {
+                        if (!webgpu.frame.begun)
                         {
-                            auto camera_entity = ecs_world.get_entity(active_camera.camera_entity);
-                            if (!camera_entity.valid())
-                                return;
-                                auto maybe_camera = camera_entity.get_component<fae::camera>();
-                            auto &camera = *maybe_camera;
-                            auto maybe_transform = camera_entity.get_component<fae::transform>();
-                            auto &camera_transform = *maybe_transform;
-
-                            local_uniforms.view = math::lookAt(camera_transform.position, camera_transform.position + camera_transform.forward(), fae::vec3(0.f, 1.f, 0.f));
-                            global_entity.use_component<fae::primary_window>([&](fae::primary_window primary_window)
+                            return;
+                        }
+                        // the frame's uploads are copied ahead of its passes, in the same submit
+                        auto upload_commands = webgpu.uploads.finish(webgpu.device);
+                        if (upload_commands && !webgpu.frame.target_view)
                         {
-                            if (!global_entity.registry.valid(primary_window.window_entity))
-                                return;
-                            auto maybe_window =  ecs_world.get_entity(primary_window.window_entity).get_component<fae::window>();
-                            auto& window = *maybe_window;
-                            auto window_size = window.get_size();
-                            auto aspect_ratio = static_cast<float>(window_size.width) / static_cast<float>(window_size.height);
-
-                            local_uniforms.projection = math::perspective(math::radians(camera.fov), aspect_ratio, camera.near_plane, camera.far_plane); });
-                            local_uniforms.model = args.transform.to_mat4();
-
-                            static auto cache = std::unordered_map<const texture*, texture_and_view>();
-                            auto maybe_texture_and_view = cache.find(&args.model.material.diffuse);
-                            if (maybe_texture_and_view == cache.end())
+                            webgpu.device.GetQueue().Submit(1, &upload_commands);
+                            webgpu.uploads.submitted();
+                        }
+                        if (webgpu.frame.target_view)
+                        {
+#ifndef FAE_PLATFORM_WEB
+                            auto read_back = webgpu.readback && webgpu.target.offscreen_texture;
+                            if (read_back)
                             {
-                                maybe_texture_and_view = cache.insert({ &args.model.material.diffuse, create_texture_with_mips_and_view(webgpu.device, args.model.material.diffuse) }).first;
+                                webgpu.graph.add_pass(render_graph::pass{
+                                    .name = "fae_readback",
+                                    .reads = { webgpu.frame.target },
+                                    .has_side_effects = true,
+                                    .record_commands = [&webgpu](const wgpu::CommandEncoder& command_encoder)
+                                    { webgpu.readback->record(webgpu.device, command_encoder, webgpu.target.offscreen_texture, webgpu.frames_submitted); },
+                                });
                             }
-                            auto texture_and_view = maybe_texture_and_view->second;
-
-                            auto sample_descriptor = wgpu::SamplerDescriptor
+                            auto command_buffer = webgpu.graph.execute(webgpu.device, &webgpu.pass_timer);
+#else
+                            auto command_buffer = webgpu.graph.execute(webgpu.device);
+#endif
+                            auto command_buffers = std::vector<wgpu::CommandBuffer>();
+                            for (auto& commands : { upload_commands, command_buffer })
                             {
-                                .addressModeU = wgpu::AddressMode::Repeat,
-                                .addressModeV = wgpu::AddressMode::Repeat,
-                                .addressModeW = wgpu::AddressMode::Repeat,
-                                .magFilter = wgpu::FilterMode::Nearest,
-                                .minFilter = wgpu::FilterMode::Nearest,
-                                .mipmapFilter = wgpu::MipmapFilterMode::Nearest,
-                                .lodMinClamp = 0.f,
-                                .lodMaxClamp = 32.f,
-                                .compare = wgpu::CompareFunction::Undefined,
-                                .maxAnisotropy = 1,
-                            };
-
-                            auto sampler = webgpu.device.CreateSampler(&sample_descriptor);
-
-                        auto uniform_data = std::vector<std::uint8_t>(sizeof(local_uniforms_t));
-                        std::memcpy(uniform_data.data(), &local_uniforms, sizeof(local_uniforms_t));
-
-                        render_pass.render_commands.push_back(fae::webgpu::render_pass::render_command{
-                            .vertex_data = args.model.mesh.vertices,
-                            .index_data = args.model.mesh.indices,
-                            .uniform_data = uniform_data,
-                            .texture_view = texture_and_view.view,
-                            .sampler = sampler,
-                  }); }); }); },
-                };
+                                if (commands)
+                                {
+                                    command_buffers.push_back(commands);
+                                }
+                            }
+                            if (!command_buffers.empty())
+                            {
+                                webgpu.device.GetQueue().Submit(command_buffers.size(), command_buffers.data());
+                                webgpu.uploads.submitted();
+                            }
+                            if (command_buffer)
+                            {
+                                auto submitted = std::chrono::steady_clock::now();
+                                webgpu.frames.submitted(webgpu.device.GetQueue(), webgpu.frame.begin_time);
+                                webgpu.gpu_driven.submitted();
+#ifndef FAE_PLATFORM_WEB
+                                if (read_back)
+                                {
+                                    webgpu.readback->submitted();
+                                }
+                                webgpu.pass_timer.submitted(webgpu.frames_submitted);
+#endif
+                                global_entity.use_component<fae::frame_trace>([&](fae::frame_trace& trace)
+                                    { trace.add_cpu_frame(webgpu.frames_submitted, webgpu.frame.begin_time, submitted); });
+                                webgpu.frames_submitted++;
+                            }
+                        }
+                        global_entity.use_component<fae::render_stats>([&](fae::render_stats& stats)
+                            {
+                                stats.cpu_encode_time = fae::duration(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - webgpu.frame.begin_time));
+                                stats.bytes_uploaded = webgpu.frame_bytes_uploaded + webgpu.textures.frame_bytes_uploaded();
+                                stats.texture_bytes_resident = webgpu.textures.resident_bytes();
+                                stats.texture_budget_bytes = webgpu.textures.budget_bytes;
+                                stats.textures_resident = webgpu.textures.resident_count();
+                                stats.texture_array_layers = webgpu.texture_arrays.layers_used();
+                                stats.texture_arrays = webgpu.texture_arrays.array_count();
+                                stats.texture_array_bytes = webgpu.texture_arrays.allocated_bytes();
+                                stats.draws = 0;
+                                stats.material_binds = 0;
+                                for (const auto& render_pass : webgpu.render_passes)
+                                {
+                                    stats.draws += render_pass.draws.size();
+                                    stats.material_binds += render_pass.material_binds;
+                                }
+                                stats.graph_passes = webgpu.graph.pass_count();
+                                stats.graph_passes_culled = webgpu.graph.passes_culled();
+                                stats.graph_transient_textures = webgpu.graph.transient_texture_count();
+                                stats.graph_allocated_textures = webgpu.graph.allocated_texture_count();
+                                stats.staging_bytes = webgpu.uploads.frame_bytes();
+                                stats.staging_bytes_allocated = webgpu.uploads.allocated_bytes();
+                                stats.staging_bytes_high_water = webgpu.uploads.high_water_bytes();
+                                stats.frames_in_flight = webgpu.frames.frames_in_flight();
+                                stats.max_frames_in_flight = webgpu.frames.max_frames_in_flight;
+                                stats.frame_latency = fae::duration(webgpu.frames.latest_latency());
+                                stats.frame_pacing_wait = fae::duration(webgpu.frames.wait_time());
+                                stats.resolution_scale = static_cast<float>(webgpu.frame.scene_width) / static_cast<float>(std::max(webgpu.target.width, 1u));
+                                stats.render_width = webgpu.frame.scene_width;
+                                stats.render_height = webgpu.frame.scene_height;
+                                auto cull_stats = webgpu.gpu_driven.latest_cull_stats();
+                                stats.gpu_driven_frustum_culled = cull_stats.frustum_culled;
+                                stats.gpu_driven_occluded = cull_stats.occluded;
+                                stats.gpu_driven_drawn = cull_stats.drawn_early + cull_stats.drawn_late;
+                            });
+#ifndef FAE_PLATFORM_WEB
+                        // timings arrive a few frames late, the latest ones are republished until newer ones are read back
+                        global_entity.use_component<fae::gpu_frame_stats>([&](fae::gpu_frame_stats& stats)
+                            {
+                                stats = webgpu.pass_timer.latest();
+                                stats.supported = webgpu.device.HasFeature(wgpu::FeatureName::TimestampQuery);
+                                stats.frames_late = stats.passes.empty() ? 0 : webgpu.frames_submitted - stats.frame;
+                            });
+                        global_entity.use_component<fae::frame_trace>([&](fae::frame_trace& trace)
+                            { trace.add_gpu_frame(webgpu.pass_timer.latest()); });
+#endif
+                        update_dynamic_resolution(webgpu, global_entity);
+                        webgpu.frame_bytes_uploaded = 0;
+                        webgpu.textures.end_frame();
+                        // batches that were merged away or stopped being drawn
+                        std::erase_if(webgpu.static_batch_buffers, [&](const auto& entry)
+                            { return webgpu.frames_submitted - entry.second.last_used_frame > webgpu::static_batch_frames_kept; });
+#ifndef FAE_PLATFORM_WEB
+                        if (webgpu.frame.target_view && !webgpu.target.offscreen_texture)
+                        {
+                            webgpu.surface.Present();
+                        }
+                        webgpu.instance.ProcessEvents();
+#endif
+                        webgpu.render_passes.clear();
+                        webgpu.frame.begun = false;
+                    });
             },
+            // passes are only open between begin & end_frame, nothing needs resizing in between
+            .get_active_render_passes =
+                [&]()
+            { return std::vector<fae::render_pass>(); },
         };
     }
 }
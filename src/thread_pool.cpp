@@ -0,0 +1,74 @@
+#include "fae/thread_pool.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace fae
+{
+    thread_pool::thread_pool(std::size_t thread_count)
+    {
+#ifdef FAE_PLATFORM_WEB
+        thread_count = 0;
+#endif
+        m_workers.reserve(thread_count);
+        for (std::size_t i = 0; i < thread_count; ++i)
+        {
+            m_workers.emplace_back([this](std::stop_token stop_token)
+                { work(stop_token); });
+        }
+    }
+
+    thread_pool::~thread_pool()
+    {
+        for (auto& worker : m_workers)
+        {
+            worker.request_stop();
+        }
+        m_workers.clear();
+    }
+
+    auto thread_pool::submit(std::function<void()> task) -> void
+    {
+        if (m_workers.empty())
+        {
+            task();
+            return;
+        }
+        {
+            auto lock = std::scoped_lock(m_mutex);
+            m_tasks.push_back(std::move(task));
+        }
+        m_task_available.notify_one();
+    }
+
+    auto thread_pool::work(std::stop_token stop_token) -> void
+    {
+        while (true)
+        {
+            auto task = std::function<void()>();
+            {
+                auto lock = std::unique_lock(m_mutex);
+                // queued tasks are dropped once stopping
+                if (!m_task_available.wait(lock, stop_token, [&]
+                        { return !m_tasks.empty(); }) ||
+                    stop_token.stop_requested())
+                {
+                    return;
+                }
+                task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    auto thread_pool::thread_count() const noexcept -> std::size_t
+    {
+        return m_workers.size();
+    }
+
+    auto thread_pool::default_thread_count() noexcept -> std::size_t
+    {
+        return std::max<std::size_t>(std::thread::hardware_concurrency(), 2) - 1;
+    }
+}
@@ -1,14 +1,83 @@
 #include "fae/webgpu/default_render_pipeline.hpp"
 
+#include <algorithm>
+#include <array>
+#include <optional>
+
 #include "fae/application/application.hpp"
 #include "fae/asset_manager.hpp"
-#include "fae/core/offset_of.hpp"
 #include "fae/windowing.hpp"
 #include "fae/webgpu/webgpu.hpp"
 #include "fae/lighting.hpp"
 #include "fae/rendering/render_pipeline.hpp"
 #include "fae/rendering/render_pass.hpp"
 
+namespace
+{
+    /* switches pipelines when the vertex format changes & materials when they do, draws whose pipeline is still compiling are skipped */
+    auto record_draws(const wgpu::RenderPassEncoder& render_pass_encoder, const fae::webgpu::render_pass& render_pass,
+        const std::array<wgpu::RenderPipeline, fae::vertex_format_count>& pipelines) noexcept -> void
+    {
+        if (render_pass.draws.empty())
+        {
+            return;
+        }
+        render_pass_encoder.SetBindGroup(0, render_pass.frame_bind_group);
+        auto bound_format = std::optional<fae::vertex_format>();
+        auto bound_material = static_cast<WGPUBindGroup>(nullptr);
+        for (const auto& draw : render_pass.draws)
+        {
+            const auto& pipeline = pipelines[static_cast<std::size_t>(draw.vertex_format)];
+            if (!pipeline)
+            {
+                continue;
+            }
+            if (bound_format != draw.vertex_format)
+            {
+                render_pass_encoder.SetPipeline(pipeline);
+                bound_format = draw.vertex_format;
+            }
+            if (bound_material != draw.material_bind_group.Get())
+            {
+                render_pass_encoder.SetBindGroup(1, draw.material_bind_group);
+                bound_material = draw.material_bind_group.Get();
+            }
+            render_pass_encoder.SetBindGroup(2, render_pass.object_bind_group, 1, &draw.uniform_offset);
+            render_pass_encoder.SetVertexBuffer(0, draw.vertex_buffer);
+            if (draw.index_buffer)
+            {
+                render_pass_encoder.SetIndexBuffer(draw.index_buffer, wgpu::IndexFormat::Uint32);
+                render_pass_encoder.DrawIndexed(draw.count);
+            }
+            else
+            {
+                render_pass_encoder.Draw(draw.count);
+            }
+        }
+    }
+
+    auto all_ready(const std::array<wgpu::RenderPipeline, fae::vertex_format_count>& pipelines) noexcept -> bool
+    {
+        return std::ranges::all_of(pipelines, [](const wgpu::RenderPipeline& pipeline)
+            { return static_cast<bool>(pipeline); });
+    }
+
+    /* the default shader's vertex entry point for each vertex format */
+    auto vertex_entry_point(fae::vertex_format format) noexcept -> const char*
+    {
+        switch (format)
+        {
+        case fae::vertex_format::compact:
+            return "vs_main_compact";
+        case fae::vertex_format::compact_with_color:
+            return "vs_main_compact_colored";
+        case fae::vertex_format::standard:
+            break;
+        }
+        return "vs_main";
+    }
+}
+
 auto fae::create_default_render_pipeline(fae::ecs_world& ecs_world, fae::entity_commands& global_entity, fae::asset_manager& assets) noexcept -> render_pipeline
 {
     auto maybe_webgpu = global_entity.get_component<fae::webgpu>();
@@ -24,36 +93,6 @@ auto fae::create_default_render_pipeline(fae::ecs_world& ecs_world, fae::entity_
     }
     auto shader_module = *maybe_default_shader_module;
 
-    auto vertex_attributes = std::vector<wgpu::VertexAttribute>{
-        wgpu::VertexAttribute{
-            .format = wgpu::VertexFormat::Float32x4,
-            .offset = fae::offset_of(&vertex::position),
-            .shaderLocation = 0,
-        },
-        wgpu::VertexAttribute{
-            .format = wgpu::VertexFormat::Float32x4,
-            .offset = fae::offset_of(&vertex::color),
-            .shaderLocation = 1,
-        },
-        wgpu::VertexAttribute{
-            .format = wgpu::VertexFormat::Float32x3,
-            .offset = fae::offset_of(&vertex::normal),
-            .shaderLocation = 2,
-        },
-        wgpu::VertexAttribute{
-            .format = wgpu::VertexFormat::Float32x2,
-            .offset = fae::offset_of(&vertex::uv),
-            .shaderLocation = 3,
-        },
-    };
-
-    auto vertex_buffer_layout = wgpu::VertexBufferLayout{
-        .arrayStride = sizeof(vertex),
-        .stepMode = wgpu::VertexStepMode::Vertex,
-        .attributeCount = static_cast<std::size_t>(vertex_attributes.size()),
-        .attributes = vertex_attributes.data(),
-    };
-
     auto blend_state = wgpu::BlendState{
         .color = wgpu::BlendComponent{
             .operation = wgpu::BlendOperation::Add,
@@ -66,11 +105,8 @@ auto fae::create_default_render_pipeline(fae::ecs_world& ecs_world, fae::entity_
             .dstFactor = wgpu::BlendFactor::One,
         },
     };
-    auto surface_capabilities = wgpu::SurfaceCapabilities{};
-    webgpu.surface.GetCapabilities(webgpu.adapter, &surface_capabilities);
-    auto surface_format = surface_capabilities.formats[0];
     wgpu::ColorTargetState color_target_state{
-        .format = surface_format,
+        .format = webgpu.target.format,
         .blend = &blend_state,
         .writeMask = wgpu::ColorWriteMask::All,
     };
@@ -82,14 +118,14 @@ auto fae::create_default_render_pipeline(fae::ecs_world& ecs_world, fae::entity_
         .targetCount = 1,
         .targets = &color_target_state,
     };
-    auto depth_texture_format = wgpu::TextureFormat::Depth24Plus;
     auto depth_stencil = wgpu::DepthStencilState{
-        .format = depth_texture_format,
+        .format = webgpu.depth_texture_format,
         .depthWriteEnabled = true,
         .depthCompare = wgpu::CompareFunction::Less,
     };
 
-    auto bind_group_layout_entries = std::vector<wgpu::BindGroupLayoutEntry>{
+    // per pass: the frame's uniforms & lights
+    auto frame_entries = std::vector<wgpu::BindGroupLayoutEntry>{
         wgpu::BindGroupLayoutEntry{
             .binding = 0,
             .visibility = wgpu::ShaderStage::Vertex | wgpu::ShaderStage::Fragment,
@@ -103,51 +139,69 @@ auto fae::create_default_render_pipeline(fae::ecs_world& ecs_world, fae::entity_
             .visibility = wgpu::ShaderStage::Vertex | wgpu::ShaderStage::Fragment,
             .buffer = wgpu::BufferBindingLayout{
                 .type = wgpu::BufferBindingType::Uniform,
-                .hasDynamicOffset = true,
-                .minBindingSize = sizeof(local_uniforms_t),
+                .minBindingSize = sizeof(ambient_light_info),
             },
         },
         wgpu::BindGroupLayoutEntry{
             .binding = 2,
+            .visibility = wgpu::ShaderStage::Vertex | wgpu::ShaderStage::Fragment,
+            .buffer = wgpu::BufferBindingLayout{
+                .type = wgpu::BufferBindingType::Uniform,
+                .minBindingSize = sizeof(directional_light_info),
+            },
+        },
+    };
+    // per material: its parameters, textures (viewed as arrays, see render_settings::texture_arrays) & sampler, baked once (see webgpu::render_pipeline::materials)
+    auto material_entries = std::vector<wgpu::BindGroupLayoutEntry>{
+        wgpu::BindGroupLayoutEntry{
+            .binding = 0,
+            .visibility = wgpu::ShaderStage::Fragment,
+            .buffer = wgpu::BufferBindingLayout{
+                .type = wgpu::BufferBindingType::Uniform,
+                .minBindingSize = sizeof(material_uniforms_t),
+            },
+        },
+        wgpu::BindGroupLayoutEntry{
+            .binding = 1,
             .visibility = wgpu::ShaderStage::Fragment,
             .texture = wgpu::TextureBindingLayout{
                 .sampleType = wgpu::TextureSampleType::Float,
-                .viewDimension = wgpu::TextureViewDimension::e2D,
+                .viewDimension = wgpu::TextureViewDimension::e2DArray,
             },
         },
         wgpu::BindGroupLayoutEntry{
-            .binding = 3,
+            .binding = 2,
             .visibility = wgpu::ShaderStage::Fragment,
             .sampler = wgpu::SamplerBindingLayout{
                 .type = wgpu::SamplerBindingType::Filtering,
             },
         },
+    };
+    // per draw: the object's transform, one bind group per pass at a dynamic offset
+    auto object_entries = std::vector<wgpu::BindGroupLayoutEntry>{
         wgpu::BindGroupLayoutEntry{
-            .binding = 4,
-            .visibility = wgpu::ShaderStage::Vertex | wgpu::ShaderStage::Fragment,
-            .buffer = wgpu::BufferBindingLayout{
-                .type = wgpu::BufferBindingType::Uniform,
-                .minBindingSize = sizeof(ambient_light_info),
-            },
-        },
-        wgpu::BindGroupLayoutEntry{
-            .binding = 5,
+            .binding = 0,
             .visibility = wgpu::ShaderStage::Vertex | wgpu::ShaderStage::Fragment,
             .buffer = wgpu::BufferBindingLayout{
                 .type = wgpu::BufferBindingType::Uniform,
-                .minBindingSize = sizeof(directional_light_info),
+                .hasDynamicOffset = true,
+                .minBindingSize = sizeof(local_uniforms_t),
             },
         },
     };
-
-    auto bind_group_layout_desc = wgpu::BindGroupLayoutDescriptor{
-        .label = "fae_bind_group_layout",
-        .entryCount = static_cast<std::size_t>(bind_group_layout_entries.size()),
-        .entries = bind_group_layout_entries.data(),
+    auto create_layout = [&](const char* label, const std::vector<wgpu::BindGroupLayoutEntry>& entries)
+    {
+        auto desc = wgpu::BindGroupLayoutDescriptor{
+            .label = label,
+            .entryCount = static_cast<std::size_t>(entries.size()),
+            .entries = entries.data(),
+        };
+        return webgpu.device.CreateBindGroupLayout(&desc);
     };
-
     auto bind_group_layouts = std::vector<wgpu::BindGroupLayout>{
-        webgpu.device.CreateBindGroupLayout(&bind_group_layout_desc),
+        create_layout("fae_frame_bind_group_layout", frame_entries),
+        create_layout("fae_material_bind_group_layout", material_entries),
+        create_layout("fae_object_bind_group_layout", object_entries),
     };
 
     auto pipeline_layout_desc = wgpu::PipelineLayoutDescriptor{
@@ -167,7 +221,6 @@ auto fae::create_default_render_pipeline(fae::ecs_world& ecs_world, fae::entity_
             .constantCount = 0,
             .constants = nullptr,
             .bufferCount = 1,
-            .buffers = &vertex_buffer_layout,
         },
         .primitive = wgpu::PrimitiveState{
             .topology = wgpu::PrimitiveTopology::TriangleList,
@@ -180,17 +233,17 @@ auto fae::create_default_render_pipeline(fae::ecs_world& ecs_world, fae::entity_
         .fragment = &fragment_state,
     };
 
-    auto webgpu_render_pipeline = webgpu.device.CreateRenderPipeline(&pipeline_descriptor);
+    // same vertex stage & layout so the bind groups recorded for the color pass work for the pre-pass too
+    auto depth_prepass_pipeline_descriptor = pipeline_descriptor;
+    depth_prepass_pipeline_descriptor.label = "fae_depth_prepass_render_pipeline";
+    depth_prepass_pipeline_descriptor.fragment = nullptr;
 
-    auto maybe_primary_window = global_entity.get_component<primary_window>();
-    if (!maybe_primary_window)
-    {
-        fae::log_fatal("primary window resource not found");
-    }
-    auto primary_window = *maybe_primary_window;
-    auto maybe_window = ecs_world.get_entity(primary_window.window_entity).get_component<fae::window>();
-    auto& window = *maybe_window;
-    auto window_size = window.get_size();
+    auto depth_equal_stencil = depth_stencil;
+    depth_equal_stencil.depthWriteEnabled = false;
+    depth_equal_stencil.depthCompare = wgpu::CompareFunction::Equal;
+    auto depth_equal_pipeline_descriptor = pipeline_descriptor;
+    depth_equal_pipeline_descriptor.label = "fae_depth_equal_render_pipeline";
+    depth_equal_pipeline_descriptor.depthStencil = &depth_equal_stencil;
 
     auto ceil_to_next_multiple = [](std::uint32_t value, std::uint32_t step) noexcept -> std::uint32_t
     {
@@ -208,70 +261,89 @@ auto fae::create_default_render_pipeline(fae::ecs_world& ecs_world, fae::entity_
     std::size_t id = webgpu.render_pipelines.size();
     webgpu.render_pipelines.push_back(webgpu::render_pipeline{
         .shader_module = shader_module,
-        .render_pipeline = webgpu_render_pipeline,
-        .depth_texture = create_texture(
-            webgpu.device, "Fae Depth texture",
-            {
-                .width = static_cast<std::uint32_t>(window_size.width),
-                .height = static_cast<std::uint32_t>(window_size.height),
-            },
-            depth_texture_format, wgpu::TextureUsage::RenderAttachment),
+        .frame_bind_group_layout = bind_group_layouts[0],
+        .material_bind_group_layout = bind_group_layouts[1],
+        .object_bind_group_layout = bind_group_layouts[2],
         .uniform_stride = uniform_stride,
     });
 
     auto& render_pipeline = webgpu.render_pipelines[id];
 
+    // compiled in the background (from the pipeline cache when warm) while the application loads its assets
+    auto compile = [&](const wgpu::RenderPipelineDescriptor& descriptor, std::array<wgpu::RenderPipeline, vertex_format_count> webgpu::render_pipeline::*member, std::size_t format_index)
+    {
+        webgpu.pipelines_compiling++;
+        create_render_pipeline_async(webgpu.device, descriptor, [&webgpu, id, member, format_index](wgpu::RenderPipeline pipeline)
+            {
+                (webgpu.render_pipelines[id].*member)[format_index] = std::move(pipeline);
+                webgpu.pipelines_compiling--; });
+    };
+    // one set of pipelines per vertex format, the layout of their vertex buffer is generated from it
+    for (std::size_t format_index = 0; format_index < vertex_format_count; ++format_index)
+    {
+        auto format = static_cast<vertex_format>(format_index);
+        auto layout = make_vertex_layout(format);
+        auto vertex_buffer_layout = layout.buffer_layout();
+        for (auto* descriptor : { &pipeline_descriptor, &depth_prepass_pipeline_descriptor, &depth_equal_pipeline_descriptor })
+        {
+            descriptor->vertex.entryPoint = vertex_entry_point(format);
+            descriptor->vertex.buffers = &vertex_buffer_layout;
+        }
+        compile(pipeline_descriptor, &webgpu::render_pipeline::render_pipeline, format_index);
+        compile(depth_prepass_pipeline_descriptor, &webgpu::render_pipeline::depth_prepass_render_pipeline, format_index);
+        compile(depth_equal_pipeline_descriptor, &webgpu::render_pipeline::depth_equal_render_pipeline, format_index);
+    }
+
     return fae::render_pipeline{
         .data = &render_pipeline,
         .get_id = [&, id]()
         { return id; },
         .prepare_render_pass = [&](std::size_t id)
         {
-            auto command_encoder = webgpu.device.CreateCommandEncoder();
-
-            wgpu::SurfaceTexture surface_texture;
-            webgpu.surface.GetCurrentTexture(&surface_texture);
-            if (surface_texture.status != wgpu::SurfaceGetCurrentTextureStatus::Success)
-                return;
-            auto surface_texture_view = surface_texture.texture.CreateView();
-
-            auto color_attachment = wgpu::RenderPassColorAttachment{
-                .view = surface_texture_view,
-                .depthSlice = WGPU_DEPTH_SLICE_UNDEFINED,
-                .resolveTarget = nullptr,
-                .loadOp = wgpu::LoadOp::Clear,
-                .storeOp = wgpu::StoreOp::Store,
-                .clearValue = webgpu.clear_color,
-            };
-            auto depth_attachment = wgpu::RenderPassDepthStencilAttachment{
-                .view = render_pipeline.depth_texture.CreateView(),
-                .depthLoadOp = wgpu::LoadOp::Clear,
-                .depthStoreOp = wgpu::StoreOp::Store,
-                .depthClearValue = 1.0,
-                .stencilReadOnly = true,
-            };
-            auto render_pass_desc = wgpu::RenderPassDescriptor{
-                .label = "fae_render_pass",
-                .colorAttachmentCount = 1,
-                .colorAttachments = &color_attachment,
-                .depthStencilAttachment = &depth_attachment,
-            };
-            auto render_pass_encoder = command_encoder.BeginRenderPass(&render_pass_desc);
-            render_pass_encoder.SetPipeline(render_pipeline.render_pipeline);
+            // declares the pass' graph passes, their draws are recorded when the frame's graph executes
+            auto& render_pass = webgpu.render_passes[id];
+            render_pass.depth_prepass = render_pass.depth_prepass && all_ready(render_pipeline.depth_prepass_render_pipeline) && all_ready(render_pipeline.depth_equal_render_pipeline);
+            if (render_pass.depth_prepass)
+            {
+                // the color pass loads this depth instead of clearing it, so the pre-pass runs even without draws
+                webgpu.graph.add_pass(render_graph::pass{
+                    .name = "fae_depth_prepass",
+                    .depth_attachment = render_graph::depth_attachment{ .texture = webgpu.frame.depth },
+                    .record_render_pass = [&webgpu, id](const wgpu::RenderPassEncoder& render_pass_encoder)
+                    {
+                        const auto& render_pass = webgpu.render_passes[id];
+                        record_draws(render_pass_encoder, render_pass, webgpu.render_pipelines[render_pass.render_pipeline_id].depth_prepass_render_pipeline);
+                    },
+                });
+            }
 
-            webgpu.render_passes[id].command_encoder = command_encoder;
-            webgpu.render_passes[id].render_pass_encoder = render_pass_encoder; },
-        .on_window_resized = [&](const window_resized& window_resized_event)
-        { window_resized_event.global_entity.use_component<fae::webgpu>([&](fae::webgpu& webgpu)
-              {
-            render_pipeline.depth_texture.Destroy();
-            render_pipeline.depth_texture = create_texture(
-            webgpu.device, "Fae Depth texture",
+            auto reads = std::vector<render_graph::resource_id>();
+            if (webgpu.gpu_driven.instance_count() > 0)
             {
-                .width = static_cast<std::uint32_t>(window_resized_event.width),
-                .height = static_cast<std::uint32_t>(window_resized_event.height),
-            },
-            wgpu::TextureFormat::Depth24Plus,
-            wgpu::TextureUsage::RenderAttachment); }); }
+                reads.push_back(webgpu.frame.gpu_driven_instances);
+            }
+            webgpu.graph.add_pass(render_graph::pass{
+                .name = render_pass.label,
+                .color_attachments = {
+                    render_graph::color_attachment{ .texture = webgpu.frame.scene_color, .clear_value = webgpu.clear_color },
+                },
+                .depth_attachment = render_graph::depth_attachment{
+                    .texture = webgpu.frame.depth,
+                    .load_op = render_pass.depth_prepass ? wgpu::LoadOp::Load : wgpu::LoadOp::Clear,
+                },
+                .reads = std::move(reads),
+                .record_render_pass = [&webgpu, id](const wgpu::RenderPassEncoder& render_pass_encoder)
+                {
+                    const auto& render_pass = webgpu.render_passes[id];
+                    const auto& render_pipeline = webgpu.render_pipelines[render_pass.render_pipeline_id];
+                    record_draws(render_pass_encoder, render_pass, render_pass.depth_prepass ? render_pipeline.depth_equal_render_pipeline : render_pipeline.render_pipeline);
+                    if (webgpu.frame.gpu_driven_prepared)
+                    {
+                        webgpu.gpu_driven.draw(render_pass_encoder);
+                    }
+                },
+            }); },
+        // the depth texture belongs to the frame's render graph, which sizes it from the render target
+        .on_window_resized = [](const window_resized&) {},
     };
 }
@@ -0,0 +1,137 @@
+#include "fae/webgpu/frame_pacer.hpp"
+
+#include <algorithm>
+#include <thread>
+#include <utility>
+
+#include "fae/webgpu/utils.hpp"
+
+namespace fae
+{
+    namespace
+    {
+        /* buffers are sized up so slightly larger requests in later frames still fit */
+        constexpr std::uint64_t buffer_size_granularity = 256;
+        /* bounds a single wait, a frame that takes longer is simply waited on again */
+        constexpr std::uint64_t work_done_wait_timeout_ns = 100'000'000;
+    }
+
+    auto frame_pacer::begin_frame(const wgpu::Instance& instance) -> void
+    {
+        m_sets.resize(std::max(max_frames_in_flight, 1u));
+        m_current = static_cast<std::size_t>(m_frames_submitted % m_sets.size());
+        m_wait_time = {};
+        auto& set = m_sets[m_current];
+        if (set.frame && m_state->frames_completed <= *set.frame)
+        {
+#ifndef FAE_PLATFORM_WEB
+            auto start = std::chrono::steady_clock::now();
+            while (m_state->frames_completed <= *set.frame)
+            {
+                // blocks until the frame's work done callback ran instead of spinning a core, which would also count as waiting
+                auto wait_info = wgpu::FutureWaitInfo{ .future = set.work_done };
+                auto status = instance.WaitAny(1, &wait_info, work_done_wait_timeout_ns);
+                if (status != wgpu::WaitStatus::Success && status != wgpu::WaitStatus::TimedOut)
+                {
+                    // an instance without timed waits can only poll, it gives up the core between polls
+                    instance.ProcessEvents();
+                    std::this_thread::yield();
+                }
+            }
+            m_wait_time = std::chrono::steady_clock::now() - start;
+#else
+            set.buffers.clear();
+#endif
+        }
+        // buffers the set's last frame didn't need are released, the others are handed out again
+        std::erase_if(set.buffers, [](pooled_buffer& pooled)
+            {
+                if (!pooled.used)
+                {
+                    pooled.buffer.Destroy();
+                    return true;
+                }
+                pooled.used = false;
+                return false; });
+    }
+
+    auto frame_pacer::acquire_buffer(const wgpu::Device& device, std::string_view label, std::uint64_t size, wgpu::BufferUsage usage) -> wgpu::Buffer
+    {
+        if (m_sets.empty())
+        {
+            m_sets.resize(std::max(max_frames_in_flight, 1u));
+        }
+        auto& buffers = m_sets[m_current].buffers;
+        auto best = buffers.end();
+        for (auto it = buffers.begin(); it != buffers.end(); ++it)
+        {
+            if (!it->used && it->usage == usage && it->size >= size && (best == buffers.end() || it->size < best->size))
+            {
+                best = it;
+            }
+        }
+        if (best != buffers.end())
+        {
+            best->used = true;
+            return best->buffer;
+        }
+        auto buffer_size = std::max<std::uint64_t>((size + buffer_size_granularity - 1) / buffer_size_granularity * buffer_size_granularity, buffer_size_granularity);
+        auto& pooled = buffers.emplace_back(pooled_buffer{
+            .buffer = create_buffer(device, label, buffer_size, usage),
+            .usage = usage,
+            .size = buffer_size,
+            .used = true,
+        });
+        return pooled.buffer;
+    }
+
+    auto frame_pacer::submitted(const wgpu::Queue& queue, std::chrono::steady_clock::time_point began) -> void
+    {
+        auto frame = m_frames_submitted++;
+#ifndef FAE_PLATFORM_WEB
+        auto callback_mode = wgpu::CallbackMode::AllowProcessEvents;
+#else
+        auto callback_mode = wgpu::CallbackMode::AllowSpontaneous;
+#endif
+        // a lost device completes its frames with an error status, those count as done too so nothing waits forever
+        auto work_done = queue.OnSubmittedWorkDone(callback_mode,
+            [state = m_state, frame, began](wgpu::QueueWorkDoneStatus status)
+            {
+                state->frames_completed = std::max(state->frames_completed, frame + 1);
+                state->latest_latency = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - began);
+            });
+        if (!m_sets.empty())
+        {
+            m_sets[m_current].frame = frame;
+            m_sets[m_current].work_done = work_done;
+        }
+    }
+
+    auto frame_pacer::frames_in_flight() const noexcept -> std::uint64_t
+    {
+        return m_frames_submitted - std::min(m_state->frames_completed, m_frames_submitted);
+    }
+
+    auto frame_pacer::latest_latency() const noexcept -> std::chrono::nanoseconds
+    {
+        return m_state->latest_latency;
+    }
+
+    auto frame_pacer::wait_time() const noexcept -> std::chrono::nanoseconds
+    {
+        return m_wait_time;
+    }
+
+    auto frame_pacer::allocated_bytes() const noexcept -> std::uint64_t
+    {
+        std::uint64_t bytes = 0;
+        for (const auto& set : m_sets)
+        {
+            for (const auto& pooled : set.buffers)
+            {
+                bytes += pooled.size;
+            }
+        }
+        return bytes;
+    }
+}
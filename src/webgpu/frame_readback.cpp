@@ -0,0 +1,132 @@
+#include "fae/webgpu/frame_readback.hpp"
+
+#ifndef FAE_PLATFORM_WEB
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <string_view>
+
+#include "fae/logging.hpp"
+
+namespace fae
+{
+    auto frame_readback::record(const wgpu::Device& device, const wgpu::CommandEncoder& command_encoder, const wgpu::Texture& texture, std::uint64_t frame) -> bool
+    {
+        constexpr std::uint32_t bytes_per_pixel = 4;
+        constexpr std::uint32_t bytes_per_row_alignment = 256;
+        auto width = texture.GetWidth();
+        auto height = texture.GetHeight();
+        auto padded_bytes_per_row = (width * bytes_per_pixel + bytes_per_row_alignment - 1) / bytes_per_row_alignment * bytes_per_row_alignment;
+        auto size = static_cast<std::uint64_t>(padded_bytes_per_row) * height;
+
+        auto& slots = m_state->slots;
+        auto free_slot = std::ranges::find_if(slots, [](const auto& slot)
+            { return !slot->in_flight; });
+        if (free_slot == slots.end())
+        {
+            if (slots.size() >= max_frames_in_flight)
+            {
+                m_frames_dropped++;
+                return false;
+            }
+            free_slot = slots.insert(slots.end(), std::make_unique<slot>());
+        }
+
+        auto& target = **free_slot;
+        if (!target.buffer || target.size != size)
+        {
+            if (target.buffer)
+            {
+                target.buffer.Destroy();
+            }
+            auto buffer_desc = wgpu::BufferDescriptor{
+                .label = "fae_frame_readback_buffer",
+                .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::MapRead,
+                .size = size,
+            };
+            target.buffer = device.CreateBuffer(&buffer_desc);
+            target.size = size;
+        }
+        target.width = width;
+        target.height = height;
+        target.padded_bytes_per_row = padded_bytes_per_row;
+        target.frame = frame;
+        target.in_flight = true;
+
+        auto source = wgpu::ImageCopyTexture{
+            .texture = texture,
+            .mipLevel = 0,
+            .origin = { 0, 0, 0 },
+            .aspect = wgpu::TextureAspect::All,
+        };
+        auto destination = wgpu::ImageCopyBuffer{};
+        destination.layout.offset = 0;
+        destination.layout.bytesPerRow = padded_bytes_per_row;
+        destination.layout.rowsPerImage = height;
+        destination.buffer = target.buffer;
+        auto extent = wgpu::Extent3D{ width, height, 1 };
+        command_encoder.CopyTextureToBuffer(&source, &destination, &extent);
+
+        m_recorded = &target;
+        return true;
+    }
+
+    auto frame_readback::submitted() -> void
+    {
+        if (!m_recorded)
+        {
+            return;
+        }
+        auto* recorded = m_recorded;
+        m_recorded = nullptr;
+        recorded->buffer.MapAsync(wgpu::MapMode::Read, 0, recorded->size, wgpu::CallbackMode::AllowProcessEvents,
+            [state = m_state, recorded](wgpu::MapAsyncStatus status, wgpu::StringView message)
+            {
+                if (status != wgpu::MapAsyncStatus::Success)
+                {
+                    fae::log_error(std::format("failed to map frame readback buffer: {}", std::string_view(message.data, message.length)));
+                    recorded->in_flight = false;
+                    return;
+                }
+
+                constexpr std::uint32_t bytes_per_pixel = 4;
+                auto packed_bytes_per_row = recorded->width * bytes_per_pixel;
+                auto frame = readback_frame{
+                    .frame = recorded->frame,
+                    .width = recorded->width,
+                    .height = recorded->height,
+                    .pixels = std::vector<std::uint8_t>(static_cast<std::size_t>(packed_bytes_per_row) * recorded->height),
+                };
+                auto mapped_data = static_cast<const std::uint8_t*>(recorded->buffer.GetConstMappedRange(0, recorded->size));
+                for (std::uint32_t row = 0; row < recorded->height; ++row)
+                {
+                    std::memcpy(frame.pixels.data() + row * packed_bytes_per_row, mapped_data + row * recorded->padded_bytes_per_row, packed_bytes_per_row);
+                }
+                recorded->buffer.Unmap();
+                recorded->in_flight = false;
+                state->completed.push_back(std::move(frame));
+            });
+    }
+
+    auto frame_readback::take_completed() -> std::vector<readback_frame>
+    {
+        auto completed = std::move(m_state->completed);
+        m_state->completed.clear();
+        std::ranges::sort(completed, {}, &readback_frame::frame);
+        return completed;
+    }
+
+    auto frame_readback::frames_in_flight() const noexcept -> std::size_t
+    {
+        return static_cast<std::size_t>(std::ranges::count_if(m_state->slots, [](const auto& slot)
+            { return slot->in_flight; }));
+    }
+
+    auto frame_readback::frames_dropped() const noexcept -> std::size_t
+    {
+        return m_frames_dropped;
+    }
+}
+
+#endif
@@ -0,0 +1,975 @@
+#include "fae/webgpu/gpu_driven_renderer.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <filesystem>
+#include <format>
+#include <limits>
+#include <utility>
+
+#include "fae/lighting.hpp"
+#include "fae/logging.hpp"
+#include "fae/webgpu/staging_belt.hpp"
+#include "fae/webgpu/utils.hpp"
+
+namespace fae
+{
+    namespace
+    {
+        constexpr std::uint32_t cull_workgroup_size = 64;
+        constexpr std::uint32_t hiz_workgroup_size = 8;
+        /* frustum culled, occluded, drawn early, drawn late, dropped */
+        constexpr std::uint64_t stats_size = 5 * sizeof(std::uint32_t);
+        /* count, cursor & first entry of a draw's range */
+        constexpr std::uint64_t visible_range_size = 3 * sizeof(std::uint32_t);
+        constexpr std::uint32_t max_workgroups_per_dimension = 65535;
+        /* above any cosine, clusters with it are never cone culled */
+        constexpr float no_cone_cutoff = 2.f;
+
+        auto bounding_sphere(const std::vector<vertex>& vertices) noexcept -> vec4
+        {
+            if (vertices.empty())
+            {
+                return vec4(0.f);
+            }
+            auto min = vertices.front().position;
+            auto max = vertices.front().position;
+            for (const auto& vertex : vertices)
+            {
+                min = math::min(min, vertex.position);
+                max = math::max(max, vertex.position);
+            }
+            auto center = (min + max) * 0.5f;
+            auto radius = 0.f;
+            for (const auto& vertex : vertices)
+            {
+                radius = std::max(radius, math::length(vertex.position - center));
+            }
+            return vec4(center, radius);
+        }
+
+        /* left, right, bottom, top, near, far. normalized, pointing inwards */
+        auto frustum_planes(const mat4& view_projection) noexcept -> std::array<vec4, 6>
+        {
+            auto row = [&](int i)
+            { return vec4(view_projection[0][i], view_projection[1][i], view_projection[2][i], view_projection[3][i]); };
+            auto planes = std::array<vec4, 6>{
+                row(3) + row(0),
+                row(3) - row(0),
+                row(3) + row(1),
+                row(3) - row(1),
+                row(3) + row(2),
+                row(3) - row(2),
+            };
+            for (auto& plane : planes)
+            {
+                plane /= math::length(vec3(plane));
+            }
+            return planes;
+        }
+    }
+
+    auto gpu_driven_renderer::add_model(const mesh& mesh, const texture& diffuse, color base_color) -> std::uint32_t
+    {
+        auto index = static_cast<std::uint32_t>(m_models.size());
+        auto index_count = static_cast<std::uint32_t>(mesh.has_indices() ? mesh.indices.size() : mesh.vertices.size());
+        auto first_index = static_cast<std::uint32_t>(m_indices.size());
+        auto base_vertex = static_cast<std::int32_t>(m_vertices.size());
+        auto entry = model_entry{
+            .bounding_sphere = bounding_sphere(mesh.vertices),
+            .first_cluster = static_cast<std::uint32_t>(m_clusters.size()),
+            .cluster_count = static_cast<std::uint32_t>(std::max<std::size_t>(mesh.meshlets.size(), 1)),
+            .diffuse = diffuse,
+            .base_color = base_color,
+        };
+        if (mesh.meshlets.empty())
+        {
+            m_clusters.push_back(cluster_entry{
+                .index_count = index_count,
+                .first_index = first_index,
+                .base_vertex = base_vertex,
+                .bounding_sphere = entry.bounding_sphere,
+                .cone_apex = vec3(0.f),
+                .cone_axis = vec3(0.f, 0.f, 1.f),
+                .cone_cutoff = no_cone_cutoff,
+            });
+        }
+        for (const auto& meshlet : mesh.meshlets)
+        {
+            m_clusters.push_back(cluster_entry{
+                .index_count = meshlet.index_count,
+                .first_index = first_index + meshlet.first_index,
+                .base_vertex = base_vertex,
+                .bounding_sphere = meshlet.bounding_sphere,
+                .cone_apex = meshlet.cone_apex,
+                .cone_axis = meshlet.cone_axis,
+                .cone_cutoff = meshlet.cone_cutoff,
+            });
+        }
+        m_vertices.insert(m_vertices.end(), mesh.vertices.begin(), mesh.vertices.end());
+        if (mesh.has_indices())
+        {
+            m_indices.insert(m_indices.end(), mesh.indices.begin(), mesh.indices.end());
+        }
+        else
+        {
+            // non indexed meshes get a trivial index list so every model is drawn the same way
+            for (std::uint32_t i = 0; i < index_count; ++i)
+            {
+                m_indices.push_back(i);
+            }
+        }
+        m_models.push_back(std::move(entry));
+        m_layout_changed = true;
+        return index;
+    }
+
+    auto gpu_driven_renderer::add_instance(std::uint32_t model_index, const transform& transform) -> std::uint32_t
+    {
+        auto index = static_cast<std::uint32_t>(m_instances.size());
+        m_instances.push_back(gpu_instance{ .model = transform.to_mat4(), .model_index = model_index });
+        m_models[model_index].instance_count++;
+        m_layout_changed = true;
+        return index;
+    }
+
+    auto gpu_driven_renderer::set_transform(std::uint32_t instance_index, const transform& transform) noexcept -> void
+    {
+        m_instances[instance_index].model = transform.to_mat4();
+        if (m_dirty_begin == m_dirty_end)
+        {
+            m_dirty_begin = instance_index;
+            m_dirty_end = instance_index + 1;
+            return;
+        }
+        m_dirty_begin = std::min<std::size_t>(m_dirty_begin, instance_index);
+        m_dirty_end = std::max<std::size_t>(m_dirty_end, instance_index + 1);
+    }
+
+    auto gpu_driven_renderer::clear() noexcept -> void
+    {
+        m_vertices.clear();
+        m_indices.clear();
+        m_models.clear();
+        m_clusters.clear();
+        m_instances.clear();
+        m_dirty_begin = m_dirty_end = 0;
+        m_layout_changed = true;
+    }
+
+    auto gpu_driven_renderer::model_count() const noexcept -> std::size_t
+    {
+        return m_models.size();
+    }
+
+    auto gpu_driven_renderer::instance_count() const noexcept -> std::size_t
+    {
+        return m_instances.size();
+    }
+
+    auto gpu_driven_renderer::cluster_count() const noexcept -> std::size_t
+    {
+        return m_clusters.size();
+    }
+
+    auto gpu_driven_renderer::take_bytes_uploaded() noexcept -> std::size_t
+    {
+        return std::exchange(m_bytes_uploaded, 0);
+    }
+
+    auto gpu_driven_renderer::prepare(const wgpu::Device& device, texture_residency& textures, staging_belt& uploads, wgpu::TextureFormat color_format, wgpu::TextureFormat depth_format, const frame& frame) noexcept -> bool
+    {
+        if (m_instances.empty())
+        {
+            return false;
+        }
+        if ((!m_render_pipeline || m_color_format != color_format) && !create_pipelines(device, color_format, depth_format))
+        {
+            return false;
+        }
+
+        if (m_layout_changed)
+        {
+            if (!rebuild_buffers(device, uploads))
+            {
+                return false;
+            }
+        }
+        else if (!m_cull_bind_group)
+        {
+            // the last rebuild didn't fit the device, nothing is drawn until the layout changes again
+            return false;
+        }
+        else if (m_dirty_begin != m_dirty_end)
+        {
+            auto offset = m_dirty_begin * sizeof(gpu_instance);
+            auto size = (m_dirty_end - m_dirty_begin) * sizeof(gpu_instance);
+            uploads.write_buffer(device, m_instance_buffer, offset, m_instances.data() + m_dirty_begin, size);
+            m_bytes_uploaded += size;
+        }
+        m_dirty_begin = m_dirty_end = 0;
+
+        m_occlusion_culling = frame.occlusion_culling && m_hiz_copy_pipeline && m_hiz_downsample_pipeline && frame.depth_width > 0 && frame.depth_height > 0;
+        if (m_occlusion_culling && (m_hiz_texture.GetWidth() != frame.depth_width || m_hiz_texture.GetHeight() != frame.depth_height))
+        {
+            create_hiz(device, frame.depth_width, frame.depth_height);
+        }
+
+        // the draws' counts & ranges are written by the culling passes, only the stats start over
+        auto zeroed_stats = std::array<std::uint32_t, 5>{};
+        uploads.write_buffer(device, m_stats_buffer, 0, zeroed_stats.data(), stats_size);
+
+        auto workgroup_count = static_cast<std::uint32_t>((m_instances.size() + cull_workgroup_size - 1) / cull_workgroup_size);
+        m_workgroups_x = std::min(workgroup_count, max_workgroups_per_dimension);
+        m_workgroups_y = (workgroup_count + m_workgroups_x - 1) / m_workgroups_x;
+        auto cull_uniforms = gpu_driven_renderer::cull_uniforms{
+            .planes = frustum_planes(frame.projection * frame.view),
+            .camera_position = vec4(frame.camera_world_position, 1.f),
+            .view_projection = frame.projection * frame.view,
+            .hiz_size = vec2(static_cast<float>(m_hiz_texture.GetWidth()), static_cast<float>(m_hiz_texture.GetHeight())),
+            .instance_count = static_cast<std::uint32_t>(m_instances.size()),
+            .dispatch_width = m_workgroups_x * cull_workgroup_size,
+            .hiz_mip_count = m_hiz_texture.GetMipLevelCount(),
+            .occlusion_culling = m_occlusion_culling ? 1u : 0u,
+            .phase = 0,
+            .visible_capacity = m_visible_capacity,
+            .indirect_first_instance = m_indirect_first_instance ? 1u : 0u,
+        };
+        uploads.write_buffer(device, m_cull_uniform_buffer, 0, &cull_uniforms, sizeof(cull_uniforms));
+        cull_uniforms.phase = 1;
+        uploads.write_buffer(device, m_late_cull_uniform_buffer, 0, &cull_uniforms, sizeof(cull_uniforms));
+        auto frame_uniforms = gpu_driven_renderer::frame_uniforms{
+            .view = frame.view,
+            .projection = frame.projection,
+            .camera_world_position = frame.camera_world_position,
+            .time = frame.time,
+        };
+        uploads.write_buffer(device, m_frame_uniform_buffer, 0, &frame_uniforms, sizeof(frame_uniforms));
+        m_bytes_uploaded += stats_size + 2 * sizeof(cull_uniforms) + sizeof(frame_uniforms);
+
+        if (!m_frame_bind_group || m_bound_ambient_light_info_buffer.Get() != frame.ambient_light_info_buffer.Get())
+        {
+            auto bind_entries = std::vector<wgpu::BindGroupEntry>{
+                wgpu::BindGroupEntry{
+                    .binding = 0,
+                    .buffer = m_frame_uniform_buffer,
+                    .size = sizeof(gpu_driven_renderer::frame_uniforms),
+                },
+                wgpu::BindGroupEntry{
+                    .binding = 1,
+                    .buffer = frame.ambient_light_info_buffer,
+                    .size = sizeof(ambient_light_info),
+                },
+                wgpu::BindGroupEntry{
+                    .binding = 2,
+                    .buffer = frame.directional_light_info_buffer,
+                    .size = sizeof(directional_light_info),
+                },
+            };
+            auto bind_group_desc = wgpu::BindGroupDescriptor{
+                .label = "fae_gpu_driven_frame_bind_group",
+                .layout = m_frame_bind_group_layout,
+                .entryCount = static_cast<std::size_t>(bind_entries.size()),
+                .entries = bind_entries.data(),
+            };
+            m_frame_bind_group = device.CreateBindGroup(&bind_group_desc);
+            m_bound_ambient_light_info_buffer = frame.ambient_light_info_buffer;
+        }
+
+        // textures may have been evicted & uploaded again since the last frame
+        for (auto& model : m_models)
+        {
+            auto texture_view = textures.acquire(device, model.diffuse, &uploads).view;
+            if (model.material_bind_group && model.bound_texture_view.Get() == texture_view.Get())
+            {
+                continue;
+            }
+            if (!model.material_uniform_buffer)
+            {
+                auto base_color = model.base_color.to_vec4();
+                model.material_uniform_buffer = create_buffer(device, "fae_gpu_driven_material_uniform_buffer", sizeof(vec4), wgpu::BufferUsage::Uniform);
+                uploads.write_buffer(device, model.material_uniform_buffer, 0, &base_color, sizeof(vec4));
+                m_bytes_uploaded += sizeof(vec4);
+            }
+            auto bind_entries = std::vector<wgpu::BindGroupEntry>{
+                wgpu::BindGroupEntry{
+                    .binding = 0,
+                    .buffer = model.material_uniform_buffer,
+                    .size = sizeof(vec4),
+                },
+                wgpu::BindGroupEntry{
+                    .binding = 1,
+                    .textureView = texture_view,
+                },
+                wgpu::BindGroupEntry{
+                    .binding = 2,
+                    .sampler = m_sampler,
+                },
+            };
+            auto bind_group_desc = wgpu::BindGroupDescriptor{
+                .label = "fae_gpu_driven_material_bind_group",
+                .layout = m_material_bind_group_layout,
+                .entryCount = static_cast<std::size_t>(bind_entries.size()),
+                .entries = bind_entries.data(),
+            };
+            model.material_bind_group = device.CreateBindGroup(&bind_group_desc);
+            model.bound_texture_view = texture_view;
+        }
+        return true;
+    }
+
+    auto gpu_driven_renderer::record_culling(const wgpu::CommandEncoder& command_encoder, cull_phase phase) noexcept -> void
+    {
+        if (m_instances.empty() || !m_cull_bind_group || (phase == cull_phase::late && !m_occlusion_culling))
+        {
+            return;
+        }
+        // count each draw's instances, turn the counts into ranges of the visible list, then write the instances into them
+        auto compute_pass = command_encoder.BeginComputePass();
+        compute_pass.SetBindGroup(0, phase == cull_phase::late ? m_late_cull_bind_group : m_cull_bind_group);
+        compute_pass.SetBindGroup(1, m_hiz_bind_group);
+        compute_pass.SetPipeline(m_cull_pipeline);
+        compute_pass.DispatchWorkgroups(m_workgroups_x, m_workgroups_y, 1);
+        compute_pass.SetPipeline(m_prefix_sum_pipeline);
+        compute_pass.DispatchWorkgroups(1, 1, 1);
+        compute_pass.SetPipeline(m_scatter_pipeline);
+        compute_pass.DispatchWorkgroups(m_workgroups_x, m_workgroups_y, 1);
+        compute_pass.End();
+
+        // the counts are complete once the frame's last phase ran, frames finding every readback buffer in flight aren't counted
+        if (phase == cull_phase::late || !m_occlusion_culling)
+        {
+            auto& busy = m_stats_state->busy;
+            auto free_slot = std::ranges::find(busy, false);
+            if (free_slot != busy.end())
+            {
+                auto slot = static_cast<std::size_t>(free_slot - busy.begin());
+                command_encoder.CopyBufferToBuffer(m_stats_buffer, 0, m_stats_readback_buffers[slot], 0, stats_size);
+                busy[slot] = true;
+                m_stats_pending = slot;
+            }
+        }
+    }
+
+    auto gpu_driven_renderer::record_hiz(const wgpu::Device& device, const wgpu::CommandEncoder& command_encoder, const wgpu::TextureView& depth) noexcept -> void
+    {
+        if (m_instances.empty() || !m_occlusion_culling)
+        {
+            return;
+        }
+        auto copy_entries = std::vector<wgpu::BindGroupEntry>{
+            wgpu::BindGroupEntry{ .binding = 0, .textureView = depth },
+            wgpu::BindGroupEntry{ .binding = 1, .textureView = m_hiz_level_0_view },
+        };
+        auto copy_bind_group_desc = wgpu::BindGroupDescriptor{
+            .label = "fae_hiz_copy_depth_bind_group",
+            .layout = m_hiz_copy_pipeline.GetBindGroupLayout(0),
+            .entryCount = static_cast<std::size_t>(copy_entries.size()),
+            .entries = copy_entries.data(),
+        };
+
+        auto compute_pass = command_encoder.BeginComputePass();
+        compute_pass.SetPipeline(m_hiz_copy_pipeline);
+        compute_pass.SetBindGroup(0, device.CreateBindGroup(&copy_bind_group_desc));
+        compute_pass.DispatchWorkgroups(
+            (m_hiz_texture.GetWidth() + hiz_workgroup_size - 1) / hiz_workgroup_size,
+            (m_hiz_texture.GetHeight() + hiz_workgroup_size - 1) / hiz_workgroup_size,
+            1);
+        compute_pass.SetPipeline(m_hiz_downsample_pipeline);
+        for (std::uint32_t level = 1; level < m_hiz_texture.GetMipLevelCount(); ++level)
+        {
+            compute_pass.SetBindGroup(0, m_hiz_downsample_bind_groups[level]);
+            compute_pass.DispatchWorkgroups(
+                (std::max(m_hiz_texture.GetWidth() >> level, 1u) + hiz_workgroup_size - 1) / hiz_workgroup_size,
+                (std::max(m_hiz_texture.GetHeight() >> level, 1u) + hiz_workgroup_size - 1) / hiz_workgroup_size,
+                1);
+        }
+        compute_pass.End();
+    }
+
+    auto gpu_driven_renderer::submitted() -> void
+    {
+        if (!m_stats_pending)
+        {
+            return;
+        }
+        auto slot = *std::exchange(m_stats_pending, std::nullopt);
+#ifndef FAE_PLATFORM_WEB
+        auto callback_mode = wgpu::CallbackMode::AllowProcessEvents;
+#else
+        auto callback_mode = wgpu::CallbackMode::AllowSpontaneous;
+#endif
+        m_stats_readback_buffers[slot].MapAsync(wgpu::MapMode::Read, 0, stats_size, callback_mode,
+            [state = m_stats_state, buffer = m_stats_readback_buffers[slot], slot](wgpu::MapAsyncStatus status, wgpu::StringView message)
+            {
+                if (status == wgpu::MapAsyncStatus::Success)
+                {
+                    const auto* counts = static_cast<const std::uint32_t*>(buffer.GetConstMappedRange(0, stats_size));
+                    state->latest = cull_stats{
+                        .frustum_culled = counts[0],
+                        .occluded = counts[1],
+                        .drawn_early = counts[2],
+                        .drawn_late = counts[3],
+                        .dropped = counts[4],
+                    };
+                    buffer.Unmap();
+                }
+                state->busy[slot] = false;
+            });
+    }
+
+    auto gpu_driven_renderer::latest_cull_stats() const noexcept -> cull_stats
+    {
+        return m_stats_state->latest;
+    }
+
+    auto gpu_driven_renderer::draw(const wgpu::RenderPassEncoder& render_pass_encoder, cull_phase phase) noexcept -> void
+    {
+        if (m_instances.empty() || !m_render_pipeline || !m_frame_bind_group || (phase == cull_phase::late && !m_occlusion_culling))
+        {
+            return;
+        }
+        render_pass_encoder.SetPipeline(m_render_pipeline);
+        render_pass_encoder.SetBindGroup(0, m_frame_bind_group);
+        auto draw_index_offset = std::uint32_t{ 0 };
+        render_pass_encoder.SetBindGroup(1, m_instances_bind_group, 1, &draw_index_offset);
+        render_pass_encoder.SetVertexBuffer(0, m_vertex_buffer);
+        render_pass_encoder.SetIndexBuffer(m_index_buffer, wgpu::IndexFormat::Uint32);
+        for (const auto& model : m_models)
+        {
+            if (model.instance_count == 0)
+            {
+                continue;
+            }
+            render_pass_encoder.SetBindGroup(2, model.material_bind_group);
+            // webgpu has no multi draw indirect, but each draw is only the indirect call (its range is read through firstInstance)
+            for (auto cluster_index = model.first_cluster; cluster_index < model.first_cluster + model.cluster_count; ++cluster_index)
+            {
+                if (!m_indirect_first_instance)
+                {
+                    draw_index_offset = static_cast<std::uint32_t>(cluster_index * m_draw_index_stride);
+                    render_pass_encoder.SetBindGroup(1, m_instances_bind_group, 1, &draw_index_offset);
+                }
+                render_pass_encoder.DrawIndexedIndirect(m_draw_buffer, cluster_index * sizeof(draw_indexed_indirect));
+            }
+        }
+    }
+
+    auto gpu_driven_renderer::rebuild_buffers(const wgpu::Device& device, staging_belt& uploads) noexcept -> bool
+    {
+        m_layout_changed = false;
+        m_cull_bind_group = nullptr;
+        m_late_cull_bind_group = nullptr;
+        m_instances_bind_group = nullptr;
+
+        auto supported_limits = wgpu::SupportedLimits{};
+        device.GetLimits(&supported_limits);
+        const auto& limits = supported_limits.limits;
+        auto max_binding_size = std::min<std::uint64_t>(limits.maxStorageBufferBindingSize, limits.maxBufferSize);
+
+        // the list holds every visible meshlet of every instance, all of them at worst. past the binding limit the fullest views drop some
+        auto worst_case_visible = std::uint64_t{ 0 };
+        for (const auto& model : m_models)
+        {
+            worst_case_visible += static_cast<std::uint64_t>(model.instance_count) * model.cluster_count;
+        }
+        auto visible_capacity = std::clamp<std::uint64_t>(worst_case_visible, 1, std::min<std::uint64_t>(max_binding_size / sizeof(std::uint32_t), std::numeric_limits<std::uint32_t>::max()));
+        if (visible_capacity < worst_case_visible)
+        {
+            fae::log_warning(std::format("gpu driven visible list holds {} of up to {} visible meshlet instances (storage binding limit), views that see more drop the rest",
+                visible_capacity, worst_case_visible));
+        }
+        m_visible_capacity = static_cast<std::uint32_t>(visible_capacity);
+
+        // one draw per cluster, the late phase reuses the early phase's once those are drawn
+        auto draw_count = static_cast<std::uint64_t>(m_clusters.size());
+        auto instance_buffer_size = static_cast<std::uint64_t>(m_instances.size()) * sizeof(gpu_instance);
+        auto model_info_size = static_cast<std::uint64_t>(m_models.size()) * sizeof(gpu_model_info);
+        auto cluster_info_size = static_cast<std::uint64_t>(m_clusters.size()) * sizeof(gpu_cluster_info);
+        auto draw_buffer_size = draw_count * sizeof(draw_indexed_indirect);
+        auto visible_buffer_size = visible_capacity * sizeof(std::uint32_t);
+        auto visibility_size = static_cast<std::uint64_t>(m_instances.size()) * sizeof(std::uint32_t);
+        auto compaction_size = draw_count * visible_range_size;
+        m_draw_index_stride = limits.minUniformBufferOffsetAlignment;
+        auto draw_index_size = draw_count * m_draw_index_stride;
+        auto sizes = std::array<std::pair<const char*, std::uint64_t>, 8>{ {
+            { "instance", instance_buffer_size },
+            { "model info", model_info_size },
+            { "cluster info", cluster_info_size },
+            { "draw", draw_buffer_size },
+            { "visible", visible_buffer_size },
+            { "visibility", visibility_size },
+            { "compaction", compaction_size },
+            { "draw index", draw_index_size },
+        } };
+        for (const auto& [name, size] : sizes)
+        {
+            if (size > max_binding_size)
+            {
+                fae::log_error(std::format("gpu driven {} buffer needs {} bytes, more than the device allows in one binding ({} bytes), nothing is drawn",
+                    name, size, max_binding_size));
+                return false;
+            }
+        }
+
+        auto model_infos = std::vector<gpu_model_info>();
+        model_infos.reserve(m_models.size());
+        for (const auto& model : m_models)
+        {
+            model_infos.push_back(gpu_model_info{ .bounding_sphere = model.bounding_sphere, .first_cluster = model.first_cluster, .cluster_count = model.cluster_count });
+        }
+        auto cluster_infos = std::vector<gpu_cluster_info>();
+        cluster_infos.reserve(m_clusters.size());
+        for (const auto& cluster : m_clusters)
+        {
+            cluster_infos.push_back(gpu_cluster_info{
+                .bounding_sphere = cluster.bounding_sphere,
+                .cone_apex = cluster.cone_apex,
+                .cone_cutoff = cluster.cone_cutoff,
+                .cone_axis = cluster.cone_axis,
+            });
+        }
+        // counts & ranges are filled in by the culling passes
+        auto draws = std::vector<draw_indexed_indirect>();
+        draws.reserve(draw_count);
+        for (const auto& cluster : m_clusters)
+        {
+            draws.push_back(draw_indexed_indirect{
+                .index_count = cluster.index_count,
+                .instance_count = 0,
+                .first_index = cluster.first_index,
+                .base_vertex = cluster.base_vertex,
+                .first_instance = 0,
+            });
+        }
+        auto draw_indices = std::vector<std::uint32_t>(draw_index_size / sizeof(std::uint32_t), 0);
+        for (std::size_t draw = 0; draw < draw_count; ++draw)
+        {
+            draw_indices[draw * m_draw_index_stride / sizeof(std::uint32_t)] = static_cast<std::uint32_t>(draw);
+        }
+
+        for (auto* buffer : { &m_vertex_buffer, &m_index_buffer, &m_instance_buffer, &m_model_info_buffer, &m_cluster_info_buffer, &m_draw_buffer, &m_visible_buffer, &m_visibility_buffer, &m_compaction_buffer, &m_draw_index_buffer })
+        {
+            if (*buffer)
+            {
+                buffer->Destroy();
+            }
+        }
+        m_vertex_buffer = create_buffer_with_data(device, "fae_gpu_driven_vertex_buffer", m_vertices.data(), m_vertices.size() * sizeof(vertex), wgpu::BufferUsage::Vertex, &uploads);
+        m_index_buffer = create_buffer_with_data(device, "fae_gpu_driven_index_buffer", m_indices.data(), m_indices.size() * sizeof(std::uint32_t), wgpu::BufferUsage::Index, &uploads);
+        m_instance_buffer = create_buffer_with_data(device, "fae_gpu_driven_instance_buffer", m_instances.data(), instance_buffer_size, wgpu::BufferUsage::Storage, &uploads);
+        m_model_info_buffer = create_buffer_with_data(device, "fae_gpu_driven_model_info_buffer", model_infos.data(), model_info_size, wgpu::BufferUsage::Storage, &uploads);
+        m_cluster_info_buffer = create_buffer_with_data(device, "fae_gpu_driven_cluster_info_buffer", cluster_infos.data(), cluster_info_size, wgpu::BufferUsage::Storage, &uploads);
+        m_draw_buffer = create_buffer_with_data(device, "fae_gpu_driven_draw_buffer", draws.data(), draw_buffer_size, wgpu::BufferUsage::Storage | wgpu::BufferUsage::Indirect, &uploads);
+        m_visible_buffer = create_buffer(device, "fae_gpu_driven_visible_buffer", visible_buffer_size, wgpu::BufferUsage::Storage);
+        // zero initialized: nothing was visible, the first frame's late phase draws what isn't occluded
+        m_visibility_buffer = create_buffer(device, "fae_gpu_driven_visibility_buffer", visibility_size, wgpu::BufferUsage::Storage);
+        // zero initialized counts, cs_prefix_sum zeroes them again for the next phase after reading them
+        m_compaction_buffer = create_buffer(device, "fae_gpu_driven_compaction_buffer", compaction_size, wgpu::BufferUsage::Storage);
+        m_draw_index_buffer = create_buffer_with_data(device, "fae_gpu_driven_draw_index_buffer", draw_indices.data(), draw_index_size, wgpu::BufferUsage::Uniform, &uploads);
+        m_bytes_uploaded += m_vertices.size() * sizeof(vertex) + m_indices.size() * sizeof(std::uint32_t) + instance_buffer_size + model_info_size + cluster_info_size + draw_buffer_size + draw_index_size;
+
+        auto cull_entries = std::vector<wgpu::BindGroupEntry>{
+            wgpu::BindGroupEntry{ .binding = 0, .buffer = m_cull_uniform_buffer, .size = sizeof(gpu_driven_renderer::cull_uniforms) },
+            wgpu::BindGroupEntry{ .binding = 1, .buffer = m_instance_buffer, .size = instance_buffer_size },
+            wgpu::BindGroupEntry{ .binding = 2, .buffer = m_model_info_buffer, .size = model_info_size },
+            wgpu::BindGroupEntry{ .binding = 3, .buffer = m_draw_buffer, .size = draw_buffer_size },
+            wgpu::BindGroupEntry{ .binding = 4, .buffer = m_visible_buffer, .size = visible_buffer_size },
+            wgpu::BindGroupEntry{ .binding = 5, .buffer = m_cluster_info_buffer, .size = cluster_info_size },
+            wgpu::BindGroupEntry{ .binding = 6, .buffer = m_visibility_buffer, .size = visibility_size },
+            wgpu::BindGroupEntry{ .binding = 7, .buffer = m_stats_buffer, .size = stats_size },
+            wgpu::BindGroupEntry{ .binding = 8, .buffer = m_compaction_buffer, .size = compaction_size },
+        };
+        auto cull_bind_group_desc = wgpu::BindGroupDescriptor{
+            .label = "fae_gpu_driven_cull_bind_group",
+            .layout = m_cull_bind_group_layout,
+            .entryCount = static_cast<std::size_t>(cull_entries.size()),
+            .entries = cull_entries.data(),
+        };
+        m_cull_bind_group = device.CreateBindGroup(&cull_bind_group_desc);
+        // the same resources with the late phase's uniforms
+        cull_entries[0].buffer = m_late_cull_uniform_buffer;
+        cull_bind_group_desc.label = "fae_gpu_driven_late_cull_bind_group";
+        m_late_cull_bind_group = device.CreateBindGroup(&cull_bind_group_desc);
+
+        auto instances_entries = std::vector<wgpu::BindGroupEntry>{
+            wgpu::BindGroupEntry{ .binding = 0, .buffer = m_instance_buffer, .size = instance_buffer_size },
+            wgpu::BindGroupEntry{ .binding = 1, .buffer = m_visible_buffer, .size = visible_buffer_size },
+            wgpu::BindGroupEntry{ .binding = 2, .buffer = m_compaction_buffer, .size = compaction_size },
+            wgpu::BindGroupEntry{ .binding = 3, .buffer = m_draw_index_buffer, .size = sizeof(std::uint32_t) },
+        };
+        auto instances_bind_group_desc = wgpu::BindGroupDescriptor{
+            .label = "fae_gpu_driven_instances_bind_group",
+            .layout = m_instances_bind_group_layout,
+            .entryCount = static_cast<std::size_t>(instances_entries.size()),
+            .entries = instances_entries.data(),
+        };
+        m_instances_bind_group = device.CreateBindGroup(&instances_bind_group_desc);
+        return true;
+    }
+
+    auto gpu_driven_renderer::create_pipelines(const wgpu::Device& device, wgpu::TextureFormat color_format, wgpu::TextureFormat depth_format) noexcept -> bool
+    {
+        auto maybe_cull_shader_module = create_shader_module_from_path(device, "fae_gpu_driven_cull_shader_module", FAE_ASSET_DIR / std::filesystem::path("cull_instances.wgsl"));
+        auto maybe_shader_module = create_shader_module_from_path(device, "fae_gpu_driven_shader_module", FAE_ASSET_DIR / std::filesystem::path("gpu_driven.wgsl"));
+        if (!maybe_cull_shader_module || !maybe_shader_module)
+        {
+            fae::log_error("failed to load cull_instances.wgsl or gpu_driven.wgsl, gpu driven rendering is unavailable");
+            return false;
+        }
+
+        m_indirect_first_instance = device.HasFeature(wgpu::FeatureName::IndirectFirstInstance);
+        if (!m_indirect_first_instance)
+        {
+            fae::log_info("the device has no indirect-first-instance, gpu driven draws bind their range of the visible list one by one");
+        }
+
+        // the count, prefix sum & scatter passes share their bindings, so the layout is explicit instead of derived per entry point
+        auto storage_entry = [](std::uint32_t binding, wgpu::BufferBindingType type)
+        {
+            return wgpu::BindGroupLayoutEntry{
+                .binding = binding,
+                .visibility = wgpu::ShaderStage::Compute,
+                .buffer = wgpu::BufferBindingLayout{ .type = type },
+            };
+        };
+        auto cull_entries = std::vector<wgpu::BindGroupLayoutEntry>{
+            wgpu::BindGroupLayoutEntry{
+                .binding = 0,
+                .visibility = wgpu::ShaderStage::Compute,
+                .buffer = wgpu::BufferBindingLayout{
+                    .type = wgpu::BufferBindingType::Uniform,
+                    .minBindingSize = sizeof(gpu_driven_renderer::cull_uniforms),
+                },
+            },
+            storage_entry(1, wgpu::BufferBindingType::ReadOnlyStorage),
+            storage_entry(2, wgpu::BufferBindingType::ReadOnlyStorage),
+            storage_entry(3, wgpu::BufferBindingType::Storage),
+            storage_entry(4, wgpu::BufferBindingType::Storage),
+            storage_entry(5, wgpu::BufferBindingType::ReadOnlyStorage),
+            storage_entry(6, wgpu::BufferBindingType::Storage),
+            storage_entry(7, wgpu::BufferBindingType::Storage),
+            storage_entry(8, wgpu::BufferBindingType::Storage),
+        };
+        auto hiz_entries = std::vector<wgpu::BindGroupLayoutEntry>{
+            wgpu::BindGroupLayoutEntry{
+                .binding = 0,
+                .visibility = wgpu::ShaderStage::Compute,
+                .texture = wgpu::TextureBindingLayout{
+                    .sampleType = wgpu::TextureSampleType::UnfilterableFloat,
+                    .viewDimension = wgpu::TextureViewDimension::e2D,
+                },
+            },
+        };
+
+        auto frame_entries = std::vector<wgpu::BindGroupLayoutEntry>{
+            wgpu::BindGroupLayoutEntry{
+                .binding = 0,
+                .visibility = wgpu::ShaderStage::Vertex | wgpu::ShaderStage::Fragment,
+                .buffer = wgpu::BufferBindingLayout{
+                    .type = wgpu::BufferBindingType::Uniform,
+                    .minBindingSize = sizeof(gpu_driven_renderer::frame_uniforms),
+                },
+            },
+            wgpu::BindGroupLayoutEntry{
+                .binding = 1,
+                .visibility = wgpu::ShaderStage::Fragment,
+                .buffer = wgpu::BufferBindingLayout{
+                    .type = wgpu::BufferBindingType::Uniform,
+                    .minBindingSize = sizeof(ambient_light_info),
+                },
+            },
+            wgpu::BindGroupLayoutEntry{
+                .binding = 2,
+                .visibility = wgpu::ShaderStage::Fragment,
+                .buffer = wgpu::BufferBindingLayout{
+                    .type = wgpu::BufferBindingType::Uniform,
+                    .minBindingSize = sizeof(directional_light_info),
+                },
+            },
+        };
+        auto instances_entries = std::vector<wgpu::BindGroupLayoutEntry>{
+            wgpu::BindGroupLayoutEntry{
+                .binding = 0,
+                .visibility = wgpu::ShaderStage::Vertex,
+                .buffer = wgpu::BufferBindingLayout{
+                    .type = wgpu::BufferBindingType::ReadOnlyStorage,
+                    .minBindingSize = sizeof(gpu_instance),
+                },
+            },
+            wgpu::BindGroupLayoutEntry{
+                .binding = 1,
+                .visibility = wgpu::ShaderStage::Vertex,
+                .buffer = wgpu::BufferBindingLayout{
+                    .type = wgpu::BufferBindingType::ReadOnlyStorage,
+                    .minBindingSize = sizeof(std::uint32_t),
+                },
+            },
+            wgpu::BindGroupLayoutEntry{
+                .binding = 2,
+                .visibility = wgpu::ShaderStage::Vertex,
+                .buffer = wgpu::BufferBindingLayout{
+                    .type = wgpu::BufferBindingType::ReadOnlyStorage,
+                    .minBindingSize = visible_range_size,
+                },
+            },
+            wgpu::BindGroupLayoutEntry{
+                .binding = 3,
+                .visibility = wgpu::ShaderStage::Vertex,
+                .buffer = wgpu::BufferBindingLayout{
+                    .type = wgpu::BufferBindingType::Uniform,
+                    .hasDynamicOffset = true,
+                    .minBindingSize = sizeof(std::uint32_t),
+                },
+            },
+        };
+        auto material_entries = std::vector<wgpu::BindGroupLayoutEntry>{
+            wgpu::BindGroupLayoutEntry{
+                .binding = 0,
+                .visibility = wgpu::ShaderStage::Fragment,
+                .buffer = wgpu::BufferBindingLayout{
+                    .type = wgpu::BufferBindingType::Uniform,
+                    .minBindingSize = sizeof(vec4),
+                },
+            },
+            wgpu::BindGroupLayoutEntry{
+                .binding = 1,
+                .visibility = wgpu::ShaderStage::Fragment,
+                .texture = wgpu::TextureBindingLayout{
+                    .sampleType = wgpu::TextureSampleType::Float,
+                    .viewDimension = wgpu::TextureViewDimension::e2D,
+                },
+            },
+            wgpu::BindGroupLayoutEntry{
+                .binding = 2,
+                .visibility = wgpu::ShaderStage::Fragment,
+                .sampler = wgpu::SamplerBindingLayout{
+                    .type = wgpu::SamplerBindingType::Filtering,
+                },
+            },
+        };
+        auto create_layout = [&](const char* label, const std::vector<wgpu::BindGroupLayoutEntry>& entries)
+        {
+            auto desc = wgpu::BindGroupLayoutDescriptor{
+                .label = label,
+                .entryCount = static_cast<std::size_t>(entries.size()),
+                .entries = entries.data(),
+            };
+            return device.CreateBindGroupLayout(&desc);
+        };
+        m_frame_bind_group_layout = create_layout("fae_gpu_driven_frame_bind_group_layout", frame_entries);
+        m_instances_bind_group_layout = create_layout("fae_gpu_driven_instances_bind_group_layout", instances_entries);
+        m_material_bind_group_layout = create_layout("fae_gpu_driven_material_bind_group_layout", material_entries);
+        m_cull_bind_group_layout = create_layout("fae_gpu_driven_cull_bind_group_layout", cull_entries);
+        m_hiz_bind_group_layout = create_layout("fae_gpu_driven_hiz_bind_group_layout", hiz_entries);
+
+        auto cull_bind_group_layouts = std::array<wgpu::BindGroupLayout, 2>{ m_cull_bind_group_layout, m_hiz_bind_group_layout };
+        auto cull_pipeline_layout_desc = wgpu::PipelineLayoutDescriptor{
+            .label = "fae_gpu_driven_cull_pipeline_layout",
+            .bindGroupLayoutCount = cull_bind_group_layouts.size(),
+            .bindGroupLayouts = cull_bind_group_layouts.data(),
+        };
+        auto cull_pipeline_desc = wgpu::ComputePipelineDescriptor{
+            .label = "fae_gpu_driven_cull_pipeline",
+            .layout = device.CreatePipelineLayout(&cull_pipeline_layout_desc),
+            .compute = {
+                .module = *maybe_cull_shader_module,
+                .entryPoint = "cs_count",
+            },
+        };
+        m_cull_pipeline = device.CreateComputePipeline(&cull_pipeline_desc);
+        cull_pipeline_desc.label = "fae_gpu_driven_prefix_sum_pipeline";
+        cull_pipeline_desc.compute.entryPoint = "cs_prefix_sum";
+        m_prefix_sum_pipeline = device.CreateComputePipeline(&cull_pipeline_desc);
+        cull_pipeline_desc.label = "fae_gpu_driven_scatter_pipeline";
+        cull_pipeline_desc.compute.entryPoint = "cs_scatter";
+        m_scatter_pipeline = device.CreateComputePipeline(&cull_pipeline_desc);
+
+        auto bind_group_layouts = std::vector<wgpu::BindGroupLayout>{
+            m_frame_bind_group_layout,
+            m_instances_bind_group_layout,
+            m_material_bind_group_layout,
+        };
+        auto pipeline_layout_desc = wgpu::PipelineLayoutDescriptor{
+            .label = "fae_gpu_driven_pipeline_layout",
+            .bindGroupLayoutCount = static_cast<std::size_t>(bind_group_layouts.size()),
+            .bindGroupLayouts = bind_group_layouts.data(),
+        };
+
+        // instances of every model share one merged vertex buffer in the standard format
+        auto vertex_layout = make_vertex_layout(vertex_format::standard);
+        auto vertex_buffer_layout = vertex_layout.buffer_layout();
+        auto blend_state = wgpu::BlendState{
+            .color = wgpu::BlendComponent{
+                .operation = wgpu::BlendOperation::Add,
+                .srcFactor = wgpu::BlendFactor::SrcAlpha,
+                .dstFactor = wgpu::BlendFactor::OneMinusSrcAlpha,
+            },
+            .alpha = wgpu::BlendComponent{
+                .operation = wgpu::BlendOperation::Add,
+                .srcFactor = wgpu::BlendFactor::Zero,
+                .dstFactor = wgpu::BlendFactor::One,
+            },
+        };
+        auto color_target_state = wgpu::ColorTargetState{
+            .format = color_format,
+            .blend = &blend_state,
+            .writeMask = wgpu::ColorWriteMask::All,
+        };
+        auto fragment_state = wgpu::FragmentState{
+            .module = *maybe_shader_module,
+            .entryPoint = "fs_main",
+            .targetCount = 1,
+            .targets = &color_target_state,
+        };
+        auto depth_stencil = wgpu::DepthStencilState{
+            .format = depth_format,
+            .depthWriteEnabled = true,
+            .depthCompare = wgpu::CompareFunction::Less,
+        };
+        auto vertex_constant = wgpu::ConstantEntry{
+            .key = "indirect_first_instance",
+            .value = m_indirect_first_instance ? 1.0 : 0.0,
+        };
+        auto pipeline_desc = wgpu::RenderPipelineDescriptor{
+            .label = "fae_gpu_driven_render_pipeline",
+            .layout = device.CreatePipelineLayout(&pipeline_layout_desc),
+            .vertex = wgpu::VertexState{
+                .module = *maybe_shader_module,
+                .entryPoint = "vs_main",
+                .constantCount = 1,
+                .constants = &vertex_constant,
+                .bufferCount = 1,
+                .buffers = &vertex_buffer_layout,
+            },
+            .primitive = wgpu::PrimitiveState{
+                .topology = wgpu::PrimitiveTopology::TriangleList,
+                .frontFace = wgpu::FrontFace::CCW,
+                .cullMode = wgpu::CullMode::Back,
+            },
+            .depthStencil = &depth_stencil,
+            .multisample = wgpu::MultisampleState{},
+            .fragment = &fragment_state,
+        };
+        m_render_pipeline = device.CreateRenderPipeline(&pipeline_desc);
+        m_color_format = color_format;
+
+        auto sampler_desc = wgpu::SamplerDescriptor{
+            .addressModeU = wgpu::AddressMode::Repeat,
+            .addressModeV = wgpu::AddressMode::Repeat,
+            .addressModeW = wgpu::AddressMode::Repeat,
+            .magFilter = wgpu::FilterMode::Nearest,
+            .minFilter = wgpu::FilterMode::Nearest,
+            .mipmapFilter = wgpu::MipmapFilterMode::Nearest,
+            .lodMinClamp = 0.f,
+            .lodMaxClamp = 32.f,
+            .compare = wgpu::CompareFunction::Undefined,
+            .maxAnisotropy = 1,
+        };
+        m_sampler = device.CreateSampler(&sampler_desc);
+
+        m_cull_uniform_buffer = create_buffer(device, "fae_gpu_driven_cull_uniform_buffer", sizeof(gpu_driven_renderer::cull_uniforms), wgpu::BufferUsage::Uniform);
+        m_late_cull_uniform_buffer = create_buffer(device, "fae_gpu_driven_late_cull_uniform_buffer", sizeof(gpu_driven_renderer::cull_uniforms), wgpu::BufferUsage::Uniform);
+        m_stats_buffer = create_buffer(device, "fae_gpu_driven_stats_buffer", stats_size, wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopySrc);
+        for (auto& buffer : m_stats_readback_buffers)
+        {
+            buffer = create_buffer(device, "fae_gpu_driven_stats_readback_buffer", stats_size, wgpu::BufferUsage::MapRead);
+        }
+        m_stats_state->busy = {};
+
+        // without the pyramid's pipelines occlusion culling is off, a 1x1 pyramid is still bound by the early phase
+        auto maybe_hiz_shader_module = create_shader_module_from_path(device, "fae_hiz_shader_module", FAE_ASSET_DIR / std::filesystem::path("hiz.wgsl"));
+        m_hiz_copy_pipeline = nullptr;
+        m_hiz_downsample_pipeline = nullptr;
+        if (maybe_hiz_shader_module)
+        {
+            auto hiz_pipeline_desc = wgpu::ComputePipelineDescriptor{
+                .label = "fae_hiz_copy_depth_pipeline",
+                .compute = {
+                    .module = *maybe_hiz_shader_module,
+                    .entryPoint = "cs_copy_depth",
+                },
+            };
+            m_hiz_copy_pipeline = device.CreateComputePipeline(&hiz_pipeline_desc);
+            hiz_pipeline_desc.label = "fae_hiz_downsample_pipeline";
+            hiz_pipeline_desc.compute.entryPoint = "cs_downsample";
+            m_hiz_downsample_pipeline = device.CreateComputePipeline(&hiz_pipeline_desc);
+        }
+        else
+        {
+            fae::log_error("failed to load hiz.wgsl, occlusion culling is unavailable");
+        }
+        create_hiz(device, 1, 1);
+        m_frame_uniform_buffer = create_buffer(device, "fae_gpu_driven_frame_uniform_buffer", sizeof(gpu_driven_renderer::frame_uniforms), wgpu::BufferUsage::Uniform);
+        // bind groups referencing the old layouts are rebuilt
+        m_frame_bind_group = nullptr;
+        for (auto& model : m_models)
+        {
+            model.material_bind_group = nullptr;
+        }
+        m_layout_changed = true;
+        return m_cull_pipeline && m_prefix_sum_pipeline && m_scatter_pipeline && m_render_pipeline;
+    }
+
+    auto gpu_driven_renderer::create_hiz(const wgpu::Device& device, std::uint32_t width, std::uint32_t height) noexcept -> void
+    {
+        if (m_hiz_texture)
+        {
+            m_hiz_texture.Destroy();
+        }
+        auto texture_desc = wgpu::TextureDescriptor{
+            .label = "fae_hiz_pyramid",
+            .usage = wgpu::TextureUsage::TextureBinding | wgpu::TextureUsage::StorageBinding,
+            .dimension = wgpu::TextureDimension::e2D,
+            .size = { width, height, 1 },
+            .format = wgpu::TextureFormat::R32Float,
+            .mipLevelCount = static_cast<std::uint32_t>(std::bit_width(std::max(width, height))),
+            .sampleCount = 1,
+        };
+        m_hiz_texture = device.CreateTexture(&texture_desc);
+
+        auto hiz_entry = wgpu::BindGroupEntry{ .binding = 0, .textureView = m_hiz_texture.CreateView() };
+        auto hiz_bind_group_desc = wgpu::BindGroupDescriptor{
+            .label = "fae_gpu_driven_hiz_bind_group",
+            .layout = m_hiz_bind_group_layout,
+            .entryCount = 1,
+            .entries = &hiz_entry,
+        };
+        m_hiz_bind_group = device.CreateBindGroup(&hiz_bind_group_desc);
+
+        auto level_views = std::vector<wgpu::TextureView>();
+        for (std::uint32_t level = 0; level < texture_desc.mipLevelCount; ++level)
+        {
+            auto view_desc = wgpu::TextureViewDescriptor{
+                .format = wgpu::TextureFormat::R32Float,
+                .dimension = wgpu::TextureViewDimension::e2D,
+                .baseMipLevel = level,
+                .mipLevelCount = 1,
+                .baseArrayLayer = 0,
+                .arrayLayerCount = 1,
+                .aspect = wgpu::TextureAspect::All,
+            };
+            level_views.push_back(m_hiz_texture.CreateView(&view_desc));
+        }
+        m_hiz_level_0_view = level_views.front();
+        m_hiz_downsample_bind_groups.assign(texture_desc.mipLevelCount, nullptr);
+        if (!m_hiz_downsample_pipeline)
+        {
+            return;
+        }
+        for (std::uint32_t level = 1; level < texture_desc.mipLevelCount; ++level)
+        {
+            auto entries = std::vector<wgpu::BindGroupEntry>{
+                wgpu::BindGroupEntry{ .binding = 2, .textureView = level_views[level - 1] },
+                wgpu::BindGroupEntry{ .binding = 3, .textureView = level_views[level] },
+            };
+            auto bind_group_desc = wgpu::BindGroupDescriptor{
+                .label = "fae_hiz_downsample_bind_group",
+                .layout = m_hiz_downsample_pipeline.GetBindGroupLayout(0),
+                .entryCount = static_cast<std::size_t>(entries.size()),
+                .entries = entries.data(),
+            };
+            m_hiz_downsample_bind_groups[level] = device.CreateBindGroup(&bind_group_desc);
+        }
+    }
+}
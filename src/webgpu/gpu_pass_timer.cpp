@@ -0,0 +1,144 @@
+#include "fae/webgpu/gpu_pass_timer.hpp"
+
+#ifndef FAE_PLATFORM_WEB
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <format>
+#include <string_view>
+
+#include "fae/logging.hpp"
+
+namespace fae
+{
+    auto gpu_pass_timer::timestamp_writes(const wgpu::Device& device, std::string label) -> const wgpu::RenderPassTimestampWrites*
+    {
+        if (m_unsupported || m_state->slots[m_slot].mapping || m_labels.size() >= max_passes)
+        {
+            return nullptr;
+        }
+        if (!m_query_set)
+        {
+            if (!device.HasFeature(wgpu::FeatureName::TimestampQuery))
+            {
+                m_unsupported = true;
+                return nullptr;
+            }
+            create_buffers(device);
+        }
+
+        auto index = static_cast<std::uint32_t>(m_labels.size());
+        m_labels.push_back(std::move(label));
+        m_timestamp_writes[index] = wgpu::RenderPassTimestampWrites{
+            .querySet = m_query_set,
+            .beginningOfPassWriteIndex = index * 2,
+            .endOfPassWriteIndex = index * 2 + 1,
+        };
+        return &m_timestamp_writes[index];
+    }
+
+    auto gpu_pass_timer::resolve(const wgpu::CommandEncoder& command_encoder) -> void
+    {
+        if (m_labels.empty())
+        {
+            return;
+        }
+        auto size = m_labels.size() * 2 * sizeof(std::uint64_t);
+        command_encoder.ResolveQuerySet(m_query_set, 0, static_cast<std::uint32_t>(m_labels.size() * 2), m_resolve_buffer, 0);
+        command_encoder.CopyBufferToBuffer(m_resolve_buffer, 0, m_state->slots[m_slot].readback_buffer, 0, size);
+        m_resolved = true;
+    }
+
+    auto gpu_pass_timer::submitted(std::uint64_t frame) -> void
+    {
+        if (!m_resolved)
+        {
+            m_labels.clear();
+            return;
+        }
+        m_resolved = false;
+        auto index = m_slot;
+        m_slot = (m_slot + 1) % readback_slots;
+        auto& slot = m_state->slots[index];
+        slot.mapping = true;
+        slot.labels = std::move(m_labels);
+        slot.frame = frame;
+        m_labels.clear();
+        auto size = slot.labels.size() * 2 * sizeof(std::uint64_t);
+        slot.readback_buffer.MapAsync(wgpu::MapMode::Read, 0, size, wgpu::CallbackMode::AllowProcessEvents,
+            [state = m_state, index, size](wgpu::MapAsyncStatus status, wgpu::StringView message)
+            {
+                auto& slot = state->slots[index];
+                slot.mapping = false;
+                if (status != wgpu::MapAsyncStatus::Success)
+                {
+                    fae::log_error(std::format("failed to map gpu pass timestamps: {}", std::string_view(message.data, message.length)));
+                    return;
+                }
+
+                auto timestamps = std::vector<std::uint64_t>(slot.labels.size() * 2);
+                std::memcpy(timestamps.data(), slot.readback_buffer.GetConstMappedRange(0, size), size);
+                slot.readback_buffer.Unmap();
+                // maps can complete out of order, never replace newer results with older ones
+                if (slot.frame < state->latest.frame)
+                {
+                    return;
+                }
+
+                auto& latest = state->latest;
+                latest.frame = slot.frame;
+                latest.passes.clear();
+                auto frame_begin = std::ranges::min(timestamps);
+                auto frame_end = frame_begin;
+                for (std::size_t i = 0; i < slot.labels.size(); ++i)
+                {
+                    auto begin = timestamps[i * 2];
+                    auto end = timestamps[i * 2 + 1];
+                    // timestamps can go backwards when the gpu changes clocks, don't report those
+                    auto nanoseconds = end > begin ? end - begin : 0;
+                    frame_end = std::max(frame_end, end);
+                    latest.passes.push_back(gpu_pass_time{
+                        .label = slot.labels[i],
+                        .start = std::chrono::nanoseconds(static_cast<std::int64_t>(begin - frame_begin)),
+                        .time = std::chrono::nanoseconds(static_cast<std::int64_t>(nanoseconds)),
+                    });
+                }
+                latest.total = std::chrono::nanoseconds(static_cast<std::int64_t>(frame_end - frame_begin));
+            });
+    }
+
+    auto gpu_pass_timer::latest() const noexcept -> const gpu_frame_stats&
+    {
+        return m_state->latest;
+    }
+
+    auto gpu_pass_timer::create_buffers(const wgpu::Device& device) -> void
+    {
+        auto query_set_desc = wgpu::QuerySetDescriptor{
+            .label = "fae_gpu_pass_timer_query_set",
+            .type = wgpu::QueryType::Timestamp,
+            .count = max_passes * 2,
+        };
+        m_query_set = device.CreateQuerySet(&query_set_desc);
+
+        auto size = static_cast<std::uint64_t>(max_passes) * 2 * sizeof(std::uint64_t);
+        auto resolve_buffer_desc = wgpu::BufferDescriptor{
+            .label = "fae_gpu_pass_timer_resolve_buffer",
+            .usage = wgpu::BufferUsage::QueryResolve | wgpu::BufferUsage::CopySrc,
+            .size = size,
+        };
+        m_resolve_buffer = device.CreateBuffer(&resolve_buffer_desc);
+        auto readback_buffer_desc = wgpu::BufferDescriptor{
+            .label = "fae_gpu_pass_timer_readback_buffer",
+            .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::MapRead,
+            .size = size,
+        };
+        for (auto& slot : m_state->slots)
+        {
+            slot.readback_buffer = device.CreateBuffer(&readback_buffer_desc);
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,153 @@
+#include "fae/webgpu/mip_generator.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <vector>
+
+#include "fae/logging.hpp"
+#include "fae/webgpu/utils.hpp"
+
+namespace fae
+{
+    namespace
+    {
+        constexpr std::uint32_t workgroup_size = 8;
+    }
+
+    auto mip_generator::ready() const noexcept -> bool
+    {
+        return m_state->state == pipeline_state::ready;
+    }
+
+    auto mip_generator::failed() const noexcept -> bool
+    {
+        return m_state->state == pipeline_state::failed;
+    }
+
+    auto mip_generator::generate(const wgpu::Device& device, const wgpu::Texture& texture) noexcept -> bool
+    {
+        prepare(device);
+        if (!ready())
+        {
+            return false;
+        }
+
+        auto command_encoder = device.CreateCommandEncoder();
+        auto compute_pass = command_encoder.BeginComputePass();
+        compute_pass.SetPipeline(m_state->pipeline);
+
+        auto level_view_desc = wgpu::TextureViewDescriptor{
+            .format = texture.GetFormat(),
+            .dimension = wgpu::TextureViewDimension::e2D,
+            .baseMipLevel = 0,
+            .mipLevelCount = 1,
+            .baseArrayLayer = 0,
+            .arrayLayerCount = 1,
+            .aspect = wgpu::TextureAspect::All,
+        };
+        for (std::uint32_t level = 1; level < texture.GetMipLevelCount(); ++level)
+        {
+            level_view_desc.baseMipLevel = level - 1;
+            auto previous_level = texture.CreateView(&level_view_desc);
+            level_view_desc.baseMipLevel = level;
+            auto next_level = texture.CreateView(&level_view_desc);
+
+            auto bind_entries = std::vector<wgpu::BindGroupEntry>{
+                wgpu::BindGroupEntry{
+                    .binding = 0,
+                    .textureView = previous_level,
+                },
+                wgpu::BindGroupEntry{
+                    .binding = 1,
+                    .textureView = next_level,
+                },
+            };
+            auto bind_group_desc = wgpu::BindGroupDescriptor{
+                .label = "fae_mip_generator_bind_group",
+                .layout = m_bind_group_layout,
+                .entryCount = static_cast<std::size_t>(bind_entries.size()),
+                .entries = bind_entries.data(),
+            };
+            compute_pass.SetBindGroup(0, device.CreateBindGroup(&bind_group_desc));
+
+            auto width = std::max(texture.GetWidth() >> level, 1u);
+            auto height = std::max(texture.GetHeight() >> level, 1u);
+            compute_pass.DispatchWorkgroups(
+                (width + workgroup_size - 1) / workgroup_size,
+                (height + workgroup_size - 1) / workgroup_size,
+                1);
+        }
+        compute_pass.End();
+
+        auto command_buffer = command_encoder.Finish();
+        device.GetQueue().Submit(1, &command_buffer);
+        return true;
+    }
+
+    auto mip_generator::prepare(const wgpu::Device& device) noexcept -> void
+    {
+        if (m_state->state != pipeline_state::none)
+        {
+            return;
+        }
+        auto maybe_shader_module = create_shader_module_from_path(device, "fae_mip_generator_shader_module", FAE_ASSET_DIR / std::filesystem::path("mipmap.wgsl"));
+        if (!maybe_shader_module)
+        {
+            fae::log_error("failed to load mipmap.wgsl, gpu mip generation is unavailable");
+            m_state->state = pipeline_state::failed;
+            return;
+        }
+
+        auto bind_group_layout_entries = std::vector<wgpu::BindGroupLayoutEntry>{
+            wgpu::BindGroupLayoutEntry{
+                .binding = 0,
+                .visibility = wgpu::ShaderStage::Compute,
+                .texture = wgpu::TextureBindingLayout{
+                    .sampleType = wgpu::TextureSampleType::Float,
+                    .viewDimension = wgpu::TextureViewDimension::e2D,
+                },
+            },
+            wgpu::BindGroupLayoutEntry{
+                .binding = 1,
+                .visibility = wgpu::ShaderStage::Compute,
+                .storageTexture = wgpu::StorageTextureBindingLayout{
+                    .access = wgpu::StorageTextureAccess::WriteOnly,
+                    .format = wgpu::TextureFormat::RGBA8Unorm,
+                    .viewDimension = wgpu::TextureViewDimension::e2D,
+                },
+            },
+        };
+        auto bind_group_layout_desc = wgpu::BindGroupLayoutDescriptor{
+            .label = "fae_mip_generator_bind_group_layout",
+            .entryCount = static_cast<std::size_t>(bind_group_layout_entries.size()),
+            .entries = bind_group_layout_entries.data(),
+        };
+        m_bind_group_layout = device.CreateBindGroupLayout(&bind_group_layout_desc);
+
+        auto pipeline_layout_desc = wgpu::PipelineLayoutDescriptor{
+            .label = "fae_mip_generator_pipeline_layout",
+            .bindGroupLayoutCount = 1,
+            .bindGroupLayouts = &m_bind_group_layout,
+        };
+        auto pipeline_desc = wgpu::ComputePipelineDescriptor{
+            .label = "fae_mip_generator_pipeline",
+            .layout = device.CreatePipelineLayout(&pipeline_layout_desc),
+            .compute = {
+                .module = *maybe_shader_module,
+                .entryPoint = "cs_main",
+            },
+        };
+        // created synchronously a rejected pipeline would be an error object, only the async creation reports the failure
+        m_state->state = pipeline_state::compiling;
+        create_compute_pipeline_async(device, pipeline_desc, [state = m_state](wgpu::ComputePipeline pipeline)
+            {
+                if (!pipeline)
+                {
+                    fae::log_error("gpu mip generation is unavailable, mip chains are built on the cpu");
+                    state->state = pipeline_state::failed;
+                    return;
+                }
+                state->pipeline = std::move(pipeline);
+                state->state = pipeline_state::ready; });
+    }
+}
@@ -0,0 +1,135 @@
+#include "fae/webgpu/pipeline_cache.hpp"
+
+#ifndef FAE_PLATFORM_WEB
+
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <system_error>
+#include <vector>
+
+#include "fae/core/enum.hpp"
+#include "fae/logging.hpp"
+
+namespace fae
+{
+    namespace
+    {
+        auto fnv1a(const void* data, std::size_t size) noexcept -> std::uint64_t
+        {
+            auto hash = std::uint64_t{ 14695981039346656037ull };
+            auto bytes = static_cast<const std::uint8_t*>(data);
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                hash ^= bytes[i];
+                hash *= 1099511628211ull;
+            }
+            return hash;
+        }
+    }
+
+    auto pipeline_cache::make_isolation_key(const wgpu::Adapter& adapter) noexcept -> std::string
+    {
+        auto info = wgpu::AdapterInfo{};
+        adapter.GetInfo(&info);
+        return std::format("{}_{:04x}_{:04x}", to_string(info.backendType), info.vendorID, info.deviceID);
+    }
+
+    auto pipeline_cache::device_descriptor() noexcept -> wgpu::DawnCacheDeviceDescriptor
+    {
+        auto descriptor = wgpu::DawnCacheDeviceDescriptor{};
+        descriptor.isolationKey = isolation_key.c_str();
+        descriptor.loadDataFunction = [](const void* key, std::size_t key_size, void* value, std::size_t value_size, void* userdata) -> std::size_t
+        { return static_cast<pipeline_cache*>(userdata)->load(key, key_size, value, value_size); };
+        descriptor.storeDataFunction = [](const void* key, std::size_t key_size, const void* value, std::size_t value_size, void* userdata)
+        { static_cast<pipeline_cache*>(userdata)->store(key, key_size, value, value_size); };
+        descriptor.functionUserdata = this;
+        return descriptor;
+    }
+
+    auto pipeline_cache::load(const void* key, std::size_t key_size, void* value, std::size_t value_size) noexcept -> std::size_t
+    {
+        auto file = std::ifstream(path_for(key, key_size), std::ios::binary | std::ios::ate);
+        if (!file.is_open())
+        {
+            misses++;
+            return 0;
+        }
+        auto file_size = static_cast<std::size_t>(file.tellg());
+        file.seekg(0);
+
+        // the full key is stored in front of the blob so that hash collisions read as misses
+        auto stored_key_size = std::uint64_t{ 0 };
+        file.read(reinterpret_cast<char*>(&stored_key_size), sizeof(stored_key_size));
+        if (!file || stored_key_size != key_size || file_size < sizeof(stored_key_size) + key_size)
+        {
+            misses++;
+            return 0;
+        }
+        auto stored_key = std::vector<char>(key_size);
+        file.read(stored_key.data(), static_cast<std::streamsize>(key_size));
+        if (!file || std::memcmp(stored_key.data(), key, key_size) != 0)
+        {
+            misses++;
+            return 0;
+        }
+
+        auto blob_size = file_size - sizeof(stored_key_size) - key_size;
+        // dawn first asks for the size with no buffer, then loads
+        if (value == nullptr || value_size < blob_size)
+        {
+            return blob_size;
+        }
+        file.read(static_cast<char*>(value), static_cast<std::streamsize>(blob_size));
+        if (!file)
+        {
+            misses++;
+            return 0;
+        }
+        hits++;
+        return blob_size;
+    }
+
+    auto pipeline_cache::store(const void* key, std::size_t key_size, const void* value, std::size_t value_size) noexcept -> void
+    {
+        auto lock = std::scoped_lock(m_store_mutex);
+        auto error = std::error_code{};
+        std::filesystem::create_directories(directory, error);
+        if (error)
+        {
+            fae::log_warning(std::format("failed to create pipeline cache directory {}: {}", directory.string(), error.message()));
+            return;
+        }
+
+        // written next to the final file & renamed so that a crash never leaves a truncated blob behind
+        auto path = path_for(key, key_size);
+        auto temporary_path = path;
+        temporary_path += ".tmp";
+        {
+            auto file = std::ofstream(temporary_path, std::ios::binary | std::ios::trunc);
+            auto stored_key_size = static_cast<std::uint64_t>(key_size);
+            file.write(reinterpret_cast<const char*>(&stored_key_size), sizeof(stored_key_size));
+            file.write(static_cast<const char*>(key), static_cast<std::streamsize>(key_size));
+            file.write(static_cast<const char*>(value), static_cast<std::streamsize>(value_size));
+            if (!file)
+            {
+                fae::log_warning(std::format("failed to write pipeline cache entry {}", temporary_path.string()));
+                return;
+            }
+        }
+        std::filesystem::rename(temporary_path, path, error);
+        if (error)
+        {
+            std::filesystem::remove(temporary_path, error);
+            return;
+        }
+        stores++;
+    }
+
+    auto pipeline_cache::path_for(const void* key, std::size_t key_size) const noexcept -> std::filesystem::path
+    {
+        return directory / std::format("{:016x}.bin", fnv1a(key, key_size));
+    }
+}
+
+#endif
@@ -0,0 +1,391 @@
+#include "fae/webgpu/render_graph.hpp"
+
+#include <algorithm>
+#include <unordered_set>
+
+#include "fae/webgpu/gpu_pass_timer.hpp"
+
+namespace fae
+{
+    namespace
+    {
+        /* pooled textures unused for this many frames are released (e.g. after a resize) */
+        constexpr std::uint64_t pooled_texture_max_idle_frames = 3;
+
+        auto has_attachments(const render_graph::pass& pass) noexcept -> bool
+        {
+            return !pass.color_attachments.empty() || pass.depth_attachment;
+        }
+
+        /* resources whose previous contents the pass uses, loaded attachments included */
+        auto pass_reads(const render_graph::pass& pass) -> std::vector<render_graph::resource_id>
+        {
+            auto reads = pass.reads;
+            for (const auto& attachment : pass.color_attachments)
+            {
+                if (attachment.load_op == wgpu::LoadOp::Load)
+                {
+                    reads.push_back(attachment.texture);
+                }
+            }
+            if (pass.depth_attachment && (pass.depth_attachment->load_op == wgpu::LoadOp::Load || pass.depth_attachment->read_only))
+            {
+                reads.push_back(pass.depth_attachment->texture);
+            }
+            return reads;
+        }
+
+        auto pass_writes(const render_graph::pass& pass) -> std::vector<render_graph::resource_id>
+        {
+            auto writes = pass.writes;
+            for (const auto& attachment : pass.color_attachments)
+            {
+                writes.push_back(attachment.texture);
+            }
+            if (pass.depth_attachment && !pass.depth_attachment->read_only)
+            {
+                writes.push_back(pass.depth_attachment->texture);
+            }
+            return writes;
+        }
+    }
+
+    auto render_graph::import_texture(std::string name, wgpu::TextureView view, const texture_desc& desc) -> resource_id
+    {
+        m_resources.push_back(resource{ .name = std::move(name), .type = resource_type::imported_texture, .desc = desc, .view = std::move(view) });
+        return static_cast<resource_id>(m_resources.size() - 1);
+    }
+
+    auto render_graph::import_buffer(std::string name) -> resource_id
+    {
+        m_resources.push_back(resource{ .name = std::move(name), .type = resource_type::buffer });
+        return static_cast<resource_id>(m_resources.size() - 1);
+    }
+
+    auto render_graph::create_texture(std::string name, const texture_desc& desc) -> resource_id
+    {
+        m_resources.push_back(resource{ .name = std::move(name), .type = resource_type::transient_texture, .desc = desc });
+        return static_cast<resource_id>(m_resources.size() - 1);
+    }
+
+    auto render_graph::mark_output(resource_id resource) -> void
+    {
+        m_resources[resource].output = true;
+    }
+
+    auto render_graph::add_pass(pass pass) -> void
+    {
+        m_passes.push_back(std::move(pass));
+    }
+
+    auto render_graph::texture_desc_of(resource_id resource) const noexcept -> const texture_desc&
+    {
+        return m_resources[resource].desc;
+    }
+
+    auto render_graph::texture_view(resource_id resource) const noexcept -> wgpu::TextureView
+    {
+        const auto& target = m_resources[resource];
+        if (target.pooled_texture)
+        {
+            return m_pool[*target.pooled_texture].view;
+        }
+        return target.view;
+    }
+
+    auto render_graph::execute(const wgpu::Device& device, gpu_pass_timer* timer) -> wgpu::CommandBuffer
+    {
+        m_frame++;
+        auto passes = cull_passes(order_passes());
+        m_passes_culled = m_passes.size() - passes.size();
+        allocate_transient_textures(device, passes);
+        if (passes.empty())
+        {
+            return {};
+        }
+
+        auto encoder_desc = wgpu::CommandEncoderDescriptor{ .label = "fae_render_graph" };
+        auto command_encoder = device.CreateCommandEncoder(&encoder_desc);
+        for (auto index : passes)
+        {
+            const auto& pass = m_passes[index];
+            if (!has_attachments(pass))
+            {
+                if (pass.record_commands)
+                {
+                    pass.record_commands(command_encoder);
+                }
+                continue;
+            }
+
+            auto color_attachments = std::vector<wgpu::RenderPassColorAttachment>();
+            for (const auto& attachment : pass.color_attachments)
+            {
+                color_attachments.push_back(wgpu::RenderPassColorAttachment{
+                    .view = texture_view(attachment.texture),
+                    .depthSlice = WGPU_DEPTH_SLICE_UNDEFINED,
+                    .resolveTarget = nullptr,
+                    .loadOp = attachment.load_op,
+                    .storeOp = wgpu::StoreOp::Store,
+                    .clearValue = attachment.clear_value,
+                });
+            }
+            auto depth_attachment = wgpu::RenderPassDepthStencilAttachment{};
+            if (pass.depth_attachment)
+            {
+                depth_attachment.view = texture_view(pass.depth_attachment->texture);
+                // read only depth must leave the load & store ops undefined
+                depth_attachment.depthLoadOp = pass.depth_attachment->read_only ? wgpu::LoadOp::Undefined : pass.depth_attachment->load_op;
+                depth_attachment.depthStoreOp = pass.depth_attachment->read_only ? wgpu::StoreOp::Undefined : wgpu::StoreOp::Store;
+                depth_attachment.depthClearValue = pass.depth_attachment->clear_value;
+                depth_attachment.depthReadOnly = pass.depth_attachment->read_only;
+                depth_attachment.stencilReadOnly = true;
+            }
+            auto render_pass_desc = wgpu::RenderPassDescriptor{
+                .label = pass.name.c_str(),
+                .colorAttachmentCount = color_attachments.size(),
+                .colorAttachments = color_attachments.data(),
+                .depthStencilAttachment = pass.depth_attachment ? &depth_attachment : nullptr,
+            };
+#ifndef FAE_PLATFORM_WEB
+            if (timer)
+            {
+                render_pass_desc.timestampWrites = timer->timestamp_writes(device, pass.name);
+            }
+#endif
+            auto render_pass_encoder = command_encoder.BeginRenderPass(&render_pass_desc);
+            if (pass.record_render_pass)
+            {
+                pass.record_render_pass(render_pass_encoder);
+            }
+            render_pass_encoder.End();
+        }
+#ifndef FAE_PLATFORM_WEB
+        if (timer)
+        {
+            timer->resolve(command_encoder);
+        }
+#endif
+        return command_encoder.Finish();
+    }
+
+    auto render_graph::reset() noexcept -> void
+    {
+        m_resources.clear();
+        m_passes.clear();
+    }
+
+    auto render_graph::pass_count() const noexcept -> std::size_t
+    {
+        return m_passes.size();
+    }
+
+    auto render_graph::passes_culled() const noexcept -> std::size_t
+    {
+        return m_passes_culled;
+    }
+
+    auto render_graph::transient_texture_count() const noexcept -> std::size_t
+    {
+        return m_transient_texture_count;
+    }
+
+    auto render_graph::allocated_texture_count() const noexcept -> std::size_t
+    {
+        return m_pool.size();
+    }
+
+    auto render_graph::order_passes() const -> std::vector<std::size_t>
+    {
+        // accesses to a resource happen in the order passes were declared, so a pass depends on the last earlier writer of what it reads
+        // and on the earlier readers of what it overwrites. passes are scheduled as soon as those ran, declaration order breaks ties
+        auto dependencies = std::vector<std::vector<std::size_t>>(m_passes.size());
+        auto last_writer = std::vector<std::optional<std::size_t>>(m_resources.size());
+        auto readers = std::vector<std::vector<std::size_t>>(m_resources.size());
+        for (std::size_t index = 0; index < m_passes.size(); ++index)
+        {
+            for (auto read : pass_reads(m_passes[index]))
+            {
+                if (last_writer[read])
+                {
+                    dependencies[index].push_back(*last_writer[read]);
+                }
+                readers[read].push_back(index);
+            }
+            for (auto write : pass_writes(m_passes[index]))
+            {
+                if (last_writer[write])
+                {
+                    dependencies[index].push_back(*last_writer[write]);
+                }
+                for (auto reader : readers[write])
+                {
+                    if (reader != index)
+                    {
+                        dependencies[index].push_back(reader);
+                    }
+                }
+                readers[write].clear();
+                last_writer[write] = index;
+            }
+        }
+
+        auto order = std::vector<std::size_t>();
+        auto scheduled = std::vector<bool>(m_passes.size(), false);
+        while (order.size() < m_passes.size())
+        {
+            for (std::size_t index = 0; index < m_passes.size(); ++index)
+            {
+                if (scheduled[index])
+                {
+                    continue;
+                }
+                if (std::ranges::all_of(dependencies[index], [&](auto dependency)
+                        { return scheduled[dependency]; }))
+                {
+                    scheduled[index] = true;
+                    order.push_back(index);
+                    break;
+                }
+            }
+        }
+        return order;
+    }
+
+    auto render_graph::cull_passes(const std::vector<std::size_t>& order) const -> std::vector<std::size_t>
+    {
+        // walk backwards from the outputs, a pass is kept if a later kept pass (or an output) uses what it writes
+        auto needed = std::unordered_set<resource_id>();
+        for (resource_id id = 0; id < m_resources.size(); ++id)
+        {
+            if (m_resources[id].output)
+            {
+                needed.insert(id);
+            }
+        }
+        auto kept = std::vector<std::size_t>();
+        for (auto it = order.rbegin(); it != order.rend(); ++it)
+        {
+            const auto& pass = m_passes[*it];
+            auto writes = pass_writes(pass);
+            auto used = pass.has_side_effects || std::ranges::any_of(writes, [&](auto write)
+                                                     { return needed.contains(write); });
+            if (!used)
+            {
+                continue;
+            }
+            kept.push_back(*it);
+            // what this pass writes replaces earlier contents, unless it also reads them (added back below)
+            for (auto write : writes)
+            {
+                needed.erase(write);
+            }
+            for (auto read : pass_reads(pass))
+            {
+                needed.insert(read);
+            }
+        }
+        std::ranges::reverse(kept);
+        return kept;
+    }
+
+    auto render_graph::allocate_transient_textures(const wgpu::Device& device, const std::vector<std::size_t>& passes) -> void
+    {
+        struct lifetime
+        {
+            resource_id resource;
+            std::size_t first;
+            std::size_t last;
+        };
+        auto lifetimes = std::vector<lifetime>();
+        auto lifetime_of = [&](resource_id id) -> lifetime*
+        {
+            auto it = std::ranges::find(lifetimes, id, &lifetime::resource);
+            return it == lifetimes.end() ? nullptr : &*it;
+        };
+        for (std::size_t position = 0; position < passes.size(); ++position)
+        {
+            const auto& pass = m_passes[passes[position]];
+            auto resources = pass_reads(pass);
+            auto writes = pass_writes(pass);
+            resources.insert(resources.end(), writes.begin(), writes.end());
+            for (auto id : resources)
+            {
+                if (m_resources[id].type != resource_type::transient_texture)
+                {
+                    continue;
+                }
+                if (auto* existing = lifetime_of(id))
+                {
+                    existing->last = position;
+                    continue;
+                }
+                lifetimes.push_back(lifetime{ .resource = id, .first = position, .last = position });
+            }
+        }
+        m_transient_texture_count = lifetimes.size();
+
+        // textures with the same description whose lifetimes don't overlap share a pooled texture
+        auto busy_until = std::vector<std::optional<std::size_t>>(m_pool.size());
+        for (const auto& lifetime : lifetimes)
+        {
+            auto& resource = m_resources[lifetime.resource];
+            auto pooled = std::optional<std::size_t>();
+            for (std::size_t index = 0; index < m_pool.size(); ++index)
+            {
+                if (m_pool[index].desc == resource.desc && (!busy_until[index] || *busy_until[index] < lifetime.first))
+                {
+                    pooled = index;
+                    break;
+                }
+            }
+            if (!pooled)
+            {
+                auto texture_desc = wgpu::TextureDescriptor{
+                    .label = resource.name.c_str(),
+                    .usage = resource.desc.usage,
+                    .dimension = wgpu::TextureDimension::e2D,
+                    .size = { resource.desc.width, resource.desc.height, 1 },
+                    .format = resource.desc.format,
+                    .mipLevelCount = 1,
+                    .sampleCount = 1,
+                };
+                auto texture = device.CreateTexture(&texture_desc);
+                m_pool.push_back(pooled_texture{ .desc = resource.desc, .texture = texture, .view = texture.CreateView() });
+                busy_until.emplace_back();
+                pooled = m_pool.size() - 1;
+            }
+            busy_until[*pooled] = lifetime.last;
+            m_pool[*pooled].last_used_frame = m_frame;
+            resource.pooled_texture = pooled;
+        }
+
+        // release what hasn't been used for a while, textures handed out above are never idle
+        auto idle = [&](const pooled_texture& texture)
+        { return texture.last_used_frame + pooled_texture_max_idle_frames < m_frame; };
+        if (std::ranges::none_of(m_pool, idle))
+        {
+            return;
+        }
+        auto remap = std::vector<std::size_t>(m_pool.size());
+        auto kept = std::vector<pooled_texture>();
+        for (std::size_t index = 0; index < m_pool.size(); ++index)
+        {
+            if (idle(m_pool[index]))
+            {
+                m_pool[index].texture.Destroy();
+                continue;
+            }
+            remap[index] = kept.size();
+            kept.push_back(std::move(m_pool[index]));
+        }
+        m_pool = std::move(kept);
+        for (auto& resource : m_resources)
+        {
+            if (resource.pooled_texture)
+            {
+                resource.pooled_texture = remap[*resource.pooled_texture];
+            }
+        }
+    }
+}
@@ -0,0 +1,214 @@
+#include "fae/webgpu/staging_belt.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <string_view>
+#include <utility>
+
+#include "fae/logging.hpp"
+
+namespace fae
+{
+    namespace
+    {
+        /* buffer to texture copies need rows & offsets aligned on 256 bytes */
+        constexpr std::uint64_t texture_copy_alignment = 256;
+        constexpr std::uint64_t buffer_copy_alignment = 4;
+
+        constexpr auto align(std::uint64_t value, std::uint64_t alignment) noexcept -> std::uint64_t
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+    }
+
+    auto staging_belt::write_buffer(const wgpu::Device& device, const wgpu::Buffer& destination, std::uint64_t offset, const void* data, std::uint64_t size) -> void
+    {
+        if (size == 0)
+        {
+            return;
+        }
+        m_bytes_written += size;
+#ifdef FAE_PLATFORM_WEB
+        device.GetQueue().WriteBuffer(destination, offset, data, size);
+#else
+        auto [chunk, chunk_offset] = allocate(device, size, buffer_copy_alignment);
+        if (!chunk->mapped)
+        {
+            device.GetQueue().WriteBuffer(destination, offset, data, size);
+            return;
+        }
+        std::memcpy(chunk->mapped + chunk_offset, data, size);
+        m_buffer_copies.push_back(buffer_copy{
+            .source = chunk->buffer,
+            .source_offset = chunk_offset,
+            .destination = destination,
+            .destination_offset = offset,
+            .size = size,
+        });
+#endif
+    }
+
+    auto staging_belt::write_texture(const wgpu::Device& device, const wgpu::ImageCopyTexture& destination, const void* data, std::uint32_t bytes_per_row, std::uint32_t rows_per_image, const wgpu::Extent3D& extent) -> void
+    {
+        auto rows = static_cast<std::uint64_t>(rows_per_image) * extent.depthOrArrayLayers;
+        if (rows == 0 || bytes_per_row == 0)
+        {
+            return;
+        }
+        m_bytes_written += rows * bytes_per_row;
+        auto layout = wgpu::TextureDataLayout{
+            .offset = 0,
+            .bytesPerRow = bytes_per_row,
+            .rowsPerImage = rows_per_image,
+        };
+#ifdef FAE_PLATFORM_WEB
+        device.GetQueue().WriteTexture(&destination, data, rows * bytes_per_row, &layout, &extent);
+#else
+        auto padded_bytes_per_row = align(bytes_per_row, texture_copy_alignment);
+        auto [chunk, chunk_offset] = allocate(device, padded_bytes_per_row * rows, texture_copy_alignment);
+        if (!chunk->mapped)
+        {
+            device.GetQueue().WriteTexture(&destination, data, rows * bytes_per_row, &layout, &extent);
+            return;
+        }
+        auto source = static_cast<const std::uint8_t*>(data);
+        for (std::uint64_t row = 0; row < rows; ++row)
+        {
+            std::memcpy(chunk->mapped + chunk_offset + row * padded_bytes_per_row, source + row * bytes_per_row, bytes_per_row);
+        }
+        auto copy = texture_copy{
+            .destination = destination,
+            .extent = extent,
+        };
+        copy.source.layout.offset = chunk_offset;
+        copy.source.layout.bytesPerRow = static_cast<std::uint32_t>(padded_bytes_per_row);
+        copy.source.layout.rowsPerImage = rows_per_image;
+        copy.source.buffer = chunk->buffer;
+        m_texture_copies.push_back(std::move(copy));
+#endif
+    }
+
+    auto staging_belt::allocate(const wgpu::Device& device, std::uint64_t size, std::uint64_t alignment) -> std::pair<chunk*, std::uint64_t>
+    {
+        if (!m_active_chunks.empty())
+        {
+            auto& chunk = m_active_chunks.back();
+            auto offset = align(chunk.offset, alignment);
+            if (offset + size <= chunk.size)
+            {
+                chunk.offset = offset + size;
+                return { &chunk, offset };
+            }
+        }
+
+        auto chunk = staging_belt::chunk{};
+        auto& free_chunks = m_state->free_chunks;
+        auto it = std::ranges::find_if(free_chunks, [&](const staging_belt::chunk& free_chunk)
+            { return free_chunk.size >= size; });
+        if (it != free_chunks.end())
+        {
+            chunk = std::move(*it);
+            free_chunks.erase(it);
+        }
+        else
+        {
+            auto desc = wgpu::BufferDescriptor{
+                .label = "fae_staging_chunk",
+                .usage = wgpu::BufferUsage::MapWrite | wgpu::BufferUsage::CopySrc,
+                .size = std::max(chunk_size, align(size, buffer_copy_alignment)),
+                .mappedAtCreation = true,
+            };
+            chunk.buffer = device.CreateBuffer(&desc);
+            chunk.size = desc.size;
+            chunk.mapped = static_cast<std::uint8_t*>(chunk.buffer.GetMappedRange(0, chunk.size));
+            m_state->allocated_bytes += chunk.size;
+            m_state->high_water_bytes = std::max(m_state->high_water_bytes, m_state->allocated_bytes);
+        }
+        chunk.offset = size;
+        m_active_chunks.push_back(std::move(chunk));
+        return { &m_active_chunks.back(), 0 };
+    }
+
+    auto staging_belt::finish(const wgpu::Device& device) -> wgpu::CommandBuffer
+    {
+        m_frame_bytes = std::exchange(m_bytes_written, 0);
+        for (auto& chunk : m_active_chunks)
+        {
+            if (chunk.mapped)
+            {
+                chunk.buffer.Unmap();
+                chunk.mapped = nullptr;
+            }
+            m_closed_chunks.push_back(std::move(chunk));
+        }
+        m_active_chunks.clear();
+        if (m_buffer_copies.empty() && m_texture_copies.empty())
+        {
+            return nullptr;
+        }
+
+        auto encoder_desc = wgpu::CommandEncoderDescriptor{ .label = "fae_staging_belt_encoder" };
+        auto command_encoder = device.CreateCommandEncoder(&encoder_desc);
+        for (const auto& copy : m_buffer_copies)
+        {
+            command_encoder.CopyBufferToBuffer(copy.source, copy.source_offset, copy.destination, copy.destination_offset, copy.size);
+        }
+        for (const auto& copy : m_texture_copies)
+        {
+            command_encoder.CopyBufferToTexture(&copy.source, &copy.destination, &copy.extent);
+        }
+        m_buffer_copies.clear();
+        m_texture_copies.clear();
+        return command_encoder.Finish();
+    }
+
+    auto staging_belt::submitted() -> void
+    {
+        for (auto& chunk : m_closed_chunks)
+        {
+#ifndef FAE_PLATFORM_WEB
+            // oversized chunks were for one large write, don't keep them around
+            if (chunk.size <= chunk_size)
+            {
+                chunk.buffer.MapAsync(wgpu::MapMode::Write, 0, chunk.size, wgpu::CallbackMode::AllowProcessEvents,
+                    [state = m_state, chunk, max_free_chunks = max_free_chunks](wgpu::MapAsyncStatus status, wgpu::StringView message) mutable
+                    {
+                        if (status != wgpu::MapAsyncStatus::Success || state->free_chunks.size() >= max_free_chunks)
+                        {
+                            if (status != wgpu::MapAsyncStatus::Success && status != wgpu::MapAsyncStatus::Aborted)
+                            {
+                                fae::log_error(std::format("failed to map staging chunk: {}", std::string_view(message.data, message.length)));
+                            }
+                            state->allocated_bytes -= chunk.size;
+                            chunk.buffer.Destroy();
+                            return;
+                        }
+                        chunk.mapped = static_cast<std::uint8_t*>(chunk.buffer.GetMappedRange(0, chunk.size));
+                        chunk.offset = 0;
+                        state->free_chunks.push_back(std::move(chunk));
+                    });
+                continue;
+            }
+#endif
+            m_state->allocated_bytes -= chunk.size;
+            chunk.buffer.Destroy();
+        }
+        m_closed_chunks.clear();
+    }
+
+    auto staging_belt::frame_bytes() const noexcept -> std::uint64_t
+    {
+        return m_frame_bytes;
+    }
+
+    auto staging_belt::allocated_bytes() const noexcept -> std::uint64_t
+    {
+        return m_state->allocated_bytes;
+    }
+
+    auto staging_belt::high_water_bytes() const noexcept -> std::uint64_t
+    {
+        return m_state->high_water_bytes;
+    }
+}
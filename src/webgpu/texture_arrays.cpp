@@ -0,0 +1,164 @@
+#include "fae/webgpu/texture_arrays.hpp"
+
+#include <algorithm>
+#include <span>
+#include <utility>
+
+#include "fae/color.hpp"
+
+namespace fae
+{
+    auto texture_arrays::acquire(const wgpu::Device& device, const texture& texture, asset_handle<fae::texture> handle, staging_belt& uploads) -> std::optional<slot>
+    {
+        if (auto it = m_slots.find(handle); it != m_slots.end())
+        {
+            return it->second;
+        }
+        if (!handle.valid() || texture.compressed || texture.width == 0 || texture.height == 0)
+        {
+            return std::nullopt;
+        }
+        // cooked chains are copied into the layer as they are, but only when they cover every level the array has
+        auto has_full_chain = texture.mips && texture.mips->levels.size() == mip_level_count(texture.width, texture.height);
+        if (!has_full_chain && texture.data.size() != texture.width * texture.height)
+        {
+            return std::nullopt;
+        }
+
+        auto array_index = static_cast<std::uint32_t>(m_arrays.size());
+        for (std::uint32_t i = 0; i < m_arrays.size(); ++i)
+        {
+            const auto& candidate = m_arrays[i];
+            if (candidate.width == texture.width && candidate.height == texture.height && !candidate.free_layers.empty())
+            {
+                array_index = i;
+                break;
+            }
+        }
+        if (array_index == m_arrays.size())
+        {
+            array_index = create_array(device, texture.width, texture.height);
+        }
+        auto& array = m_arrays[array_index];
+        auto layer = array.free_layers.back();
+        array.free_layers.pop_back();
+
+        auto built_chain = mip_chain{};
+        if (!has_full_chain)
+        {
+            built_chain = build_mip_chain(std::span(reinterpret_cast<const std::uint8_t*>(texture.data.data()), texture.data.size() * sizeof(color)),
+                texture.width,
+                texture.height,
+                mip_options);
+        }
+        const auto& chain = has_full_chain ? *texture.mips : built_chain;
+        auto destination = wgpu::ImageCopyTexture{
+            .texture = array.texture,
+            .mipLevel = 0,
+            .origin = { 0, 0, layer },
+            .aspect = wgpu::TextureAspect::All,
+        };
+        for (std::uint32_t level = 0; level < chain.levels.size(); ++level)
+        {
+            const auto& mip = chain.levels[level];
+            destination.mipLevel = level;
+            auto level_size = wgpu::Extent3D{ static_cast<std::uint32_t>(mip.width), static_cast<std::uint32_t>(mip.height), 1 };
+            uploads.write_texture(device, destination, chain.level_data(level).data(), static_cast<std::uint32_t>(4 * mip.width), static_cast<std::uint32_t>(mip.height), level_size);
+        }
+        m_bytes_uploaded += chain.data.size();
+
+        auto packed = slot{ .array = array_index, .layer = layer };
+        m_slots.insert({ handle, packed });
+        return packed;
+    }
+
+    auto texture_arrays::create_array(const wgpu::Device& device, std::size_t width, std::size_t height) -> std::uint32_t
+    {
+        auto supported_limits = wgpu::SupportedLimits{};
+        device.GetLimits(&supported_limits);
+        auto layer_bytes = mip_chain_size_in_bytes(width, height);
+        auto layer_count = static_cast<std::uint32_t>(std::clamp<std::size_t>(max_array_bytes / layer_bytes, 1, std::min(max_layers_per_array, supported_limits.limits.maxTextureArrayLayers)));
+
+        auto texture_desc = wgpu::TextureDescriptor{
+            .label = "fae_texture_array",
+            .usage = wgpu::TextureUsage::CopyDst | wgpu::TextureUsage::TextureBinding,
+            .dimension = wgpu::TextureDimension::e2D,
+            .size = { static_cast<std::uint32_t>(width), static_cast<std::uint32_t>(height), layer_count },
+            .format = wgpu::TextureFormat::RGBA8Unorm,
+            .mipLevelCount = mip_level_count(width, height),
+            .sampleCount = 1,
+        };
+        auto array = texture_arrays::array{
+            .texture = device.CreateTexture(&texture_desc),
+            .width = width,
+            .height = height,
+            .layer_count = layer_count,
+            .size_in_bytes = layer_bytes * layer_count,
+        };
+        auto view_desc = wgpu::TextureViewDescriptor{
+            .format = wgpu::TextureFormat::RGBA8Unorm,
+            .dimension = wgpu::TextureViewDimension::e2DArray,
+            .baseMipLevel = 0,
+            .mipLevelCount = texture_desc.mipLevelCount,
+            .baseArrayLayer = 0,
+            .arrayLayerCount = layer_count,
+            .aspect = wgpu::TextureAspect::All,
+        };
+        array.view = array.texture.CreateView(&view_desc);
+        // handed out from the back, lowest layers first
+        for (auto layer = layer_count; layer > 0; --layer)
+        {
+            array.free_layers.push_back(layer - 1);
+        }
+        m_allocated_bytes += array.size_in_bytes;
+        m_arrays.push_back(std::move(array));
+        return static_cast<std::uint32_t>(m_arrays.size() - 1);
+    }
+
+    auto texture_arrays::view(std::uint32_t array) const noexcept -> const wgpu::TextureView&
+    {
+        return m_arrays[array].view;
+    }
+
+    auto texture_arrays::release(asset_handle<texture> handle) noexcept -> void
+    {
+        auto it = m_slots.find(handle);
+        if (it == m_slots.end())
+        {
+            return;
+        }
+        m_arrays[it->second.array].free_layers.push_back(it->second.layer);
+        m_slots.erase(it);
+    }
+
+    auto texture_arrays::clear() noexcept -> void
+    {
+        for (auto& array : m_arrays)
+        {
+            array.texture.Destroy();
+        }
+        m_arrays.clear();
+        m_slots.clear();
+        m_allocated_bytes = 0;
+    }
+
+    auto texture_arrays::array_count() const noexcept -> std::size_t
+    {
+        return m_arrays.size();
+    }
+
+    auto texture_arrays::layers_used() const noexcept -> std::size_t
+    {
+        return m_slots.size();
+    }
+
+    auto texture_arrays::allocated_bytes() const noexcept -> std::size_t
+    {
+        return m_allocated_bytes;
+    }
+
+    auto texture_arrays::take_bytes_uploaded() noexcept -> std::size_t
+    {
+        return std::exchange(m_bytes_uploaded, 0);
+    }
+}
@@ -0,0 +1,158 @@
+#include "fae/webgpu/texture_residency.hpp"
+
+#include <algorithm>
+#include <format>
+
+#include "fae/core/enum.hpp"
+#include "fae/logging.hpp"
+#include "fae/rendering/mip_chain.hpp"
+
+namespace fae
+{
+    auto texture_residency::acquire(const wgpu::Device& device, const texture& texture, staging_belt* uploads) noexcept -> texture_and_view
+    {
+        return acquire(device, texture, texture.handle, uploads);
+    }
+
+    auto texture_residency::acquire(const wgpu::Device& device, const texture& texture, asset_handle<fae::texture> handle, staging_belt* uploads) noexcept -> texture_and_view
+    {
+        if (!handle.valid())
+        {
+            static auto warned = false;
+            if (!warned)
+            {
+                fae::log_warning("texture without an asset handle is re-uploaded every frame, load it through the asset_manager to keep it resident");
+                warned = true;
+            }
+            return m_transient_textures.emplace_back(upload(device, texture, uploads).gpu);
+        }
+
+        auto it = m_textures.find(handle);
+        if (it == m_textures.end())
+        {
+            it = m_textures.insert({ handle, upload(device, texture, uploads) }).first;
+            m_resident_bytes += it->second.size_in_bytes;
+        }
+        it->second.last_used_frame = m_frame;
+        return it->second.gpu;
+    }
+
+    auto texture_residency::release(asset_handle<texture> handle) noexcept -> void
+    {
+        auto it = m_textures.find(handle);
+        if (it == m_textures.end())
+        {
+            return;
+        }
+        it->second.gpu.texture.Destroy();
+        m_resident_bytes -= it->second.size_in_bytes;
+        m_textures.erase(it);
+    }
+
+    auto texture_residency::clear() noexcept -> void
+    {
+        for (auto& [handle, resident] : m_textures)
+        {
+            resident.gpu.texture.Destroy();
+        }
+        m_textures.clear();
+        m_resident_bytes = 0;
+        end_frame();
+    }
+
+    auto texture_residency::end_frame() noexcept -> void
+    {
+        for (auto& transient : m_transient_textures)
+        {
+            transient.texture.Destroy();
+        }
+        m_transient_textures.clear();
+
+        // textures used this frame are never evicted, the budget may be exceeded if a single frame needs more
+        while (budget_bytes != 0 && m_resident_bytes > budget_bytes)
+        {
+            auto least_recently_used = std::min_element(m_textures.begin(), m_textures.end(), [](const auto& lhs, const auto& rhs)
+                { return lhs.second.last_used_frame < rhs.second.last_used_frame; });
+            if (least_recently_used == m_textures.end() || least_recently_used->second.last_used_frame == m_frame)
+            {
+                break;
+            }
+            release(least_recently_used->first);
+        }
+
+        m_frame_bytes_uploaded = 0;
+        m_frame++;
+    }
+
+    auto texture_residency::upload(const wgpu::Device& device, const texture& texture, staging_belt* uploads) noexcept -> resident_texture
+    {
+        auto uploaded = [&](texture_and_view gpu, std::size_t size_in_bytes)
+        {
+            m_frame_bytes_uploaded += size_in_bytes;
+            return resident_texture{
+                .gpu = gpu,
+                .size_in_bytes = size_in_bytes,
+                .last_used_frame = m_frame,
+            };
+        };
+
+        if (texture.compressed)
+        {
+            const auto& compressed = *texture.compressed;
+            if (can_upload_compressed(device, compressed))
+            {
+                return uploaded(create_compressed_texture_and_view(device, compressed, uploads), compressed.data.size());
+            }
+
+            auto maybe_chain = decompress(compressed);
+            if (!maybe_chain)
+            {
+                fae::log_error(std::format("device can't sample {} textures and there is no cpu decoder for them, using a placeholder", to_string(compressed.compression)));
+                auto placeholder = fae::texture{ .width = 1, .height = 1, .data = { colors::white } };
+                return uploaded(create_texture_with_mips_and_view(device, placeholder, {}, uploads), sizeof(color));
+            }
+            fae::log_warning(std::format("device can't sample {} textures, decoding on the cpu", to_string(compressed.compression)));
+            // files without precomputed mips still get a full chain
+            if (maybe_chain->levels.size() == 1 && mip_level_count(texture.width, texture.height) > 1)
+            {
+                *maybe_chain = build_mip_chain(maybe_chain->data, texture.width, texture.height, mip_options);
+            }
+            return uploaded(create_texture_from_mip_chain(device, *maybe_chain, uploads), maybe_chain->data.size());
+        }
+
+        if (texture.mips)
+        {
+            // cooked with its chain already built, each level is written as it is
+            return uploaded(create_texture_from_mip_chain(device, *texture.mips, uploads), texture.mips->data.size());
+        }
+
+        if (generate_mips_on_gpu)
+        {
+            // only level 0 crosses the bus, the rest of the chain is written by the compute pass
+            // which is submitted right away, so level 0 can't wait for the staging belt
+            auto gpu = create_texture_with_gpu_mips_and_view(device, texture, m_mip_generator);
+            m_frame_bytes_uploaded += texture.width * texture.height * sizeof(color);
+            return resident_texture{
+                .gpu = gpu,
+                .size_in_bytes = mip_chain_size_in_bytes(texture.width, texture.height),
+                .last_used_frame = m_frame,
+            };
+        }
+        return uploaded(create_texture_with_mips_and_view(device, texture, mip_options, uploads), mip_chain_size_in_bytes(texture.width, texture.height));
+    }
+
+    auto texture_residency::resident_bytes() const noexcept -> std::size_t
+    {
+        return m_resident_bytes;
+    }
+
+    auto texture_residency::resident_count() const noexcept -> std::size_t
+    {
+        return m_textures.size();
+    }
+
+    auto texture_residency::frame_bytes_uploaded() const noexcept -> std::size_t
+    {
+        return m_frame_bytes_uploaded;
+    }
+}
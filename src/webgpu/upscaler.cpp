@@ -0,0 +1,117 @@
+#include "fae/webgpu/upscaler.hpp"
+
+#include <filesystem>
+#include <vector>
+
+#include "fae/logging.hpp"
+#include "fae/webgpu/utils.hpp"
+
+namespace fae
+{
+    auto upscaler::record(const wgpu::Device& device, const wgpu::RenderPassEncoder& render_pass_encoder, const wgpu::TextureView& source, wgpu::TextureFormat target_format) noexcept -> bool
+    {
+        if ((!m_pipeline || m_target_format != target_format) && !create_pipeline(device, target_format))
+        {
+            return false;
+        }
+
+        auto bind_group_entries = std::vector<wgpu::BindGroupEntry>{
+            wgpu::BindGroupEntry{
+                .binding = 0,
+                .textureView = source,
+            },
+            wgpu::BindGroupEntry{
+                .binding = 1,
+                .sampler = m_sampler,
+            },
+        };
+        auto bind_group_desc = wgpu::BindGroupDescriptor{
+            .label = "fae_upscaler_bind_group",
+            .layout = m_bind_group_layout,
+            .entryCount = static_cast<std::size_t>(bind_group_entries.size()),
+            .entries = bind_group_entries.data(),
+        };
+        render_pass_encoder.SetPipeline(m_pipeline);
+        render_pass_encoder.SetBindGroup(0, device.CreateBindGroup(&bind_group_desc));
+        render_pass_encoder.Draw(3);
+        return true;
+    }
+
+    auto upscaler::create_pipeline(const wgpu::Device& device, wgpu::TextureFormat target_format) noexcept -> bool
+    {
+        m_pipeline = nullptr;
+        auto maybe_shader_module = create_shader_module_from_path(device, "fae_upscaler_shader_module", FAE_ASSET_DIR / std::filesystem::path("upscale.wgsl"));
+        if (!maybe_shader_module)
+        {
+            fae::log_error("failed to load upscale.wgsl, scenes rendered at a lower resolution are not shown");
+            return false;
+        }
+
+        auto bind_group_layout_entries = std::vector<wgpu::BindGroupLayoutEntry>{
+            wgpu::BindGroupLayoutEntry{
+                .binding = 0,
+                .visibility = wgpu::ShaderStage::Fragment,
+                .texture = wgpu::TextureBindingLayout{
+                    .sampleType = wgpu::TextureSampleType::Float,
+                    .viewDimension = wgpu::TextureViewDimension::e2D,
+                },
+            },
+            wgpu::BindGroupLayoutEntry{
+                .binding = 1,
+                .visibility = wgpu::ShaderStage::Fragment,
+                .sampler = wgpu::SamplerBindingLayout{
+                    .type = wgpu::SamplerBindingType::Filtering,
+                },
+            },
+        };
+        auto bind_group_layout_desc = wgpu::BindGroupLayoutDescriptor{
+            .label = "fae_upscaler_bind_group_layout",
+            .entryCount = static_cast<std::size_t>(bind_group_layout_entries.size()),
+            .entries = bind_group_layout_entries.data(),
+        };
+        m_bind_group_layout = device.CreateBindGroupLayout(&bind_group_layout_desc);
+
+        auto pipeline_layout_desc = wgpu::PipelineLayoutDescriptor{
+            .label = "fae_upscaler_pipeline_layout",
+            .bindGroupLayoutCount = 1,
+            .bindGroupLayouts = &m_bind_group_layout,
+        };
+        auto color_target_state = wgpu::ColorTargetState{
+            .format = target_format,
+            .writeMask = wgpu::ColorWriteMask::All,
+        };
+        auto fragment_state = wgpu::FragmentState{
+            .module = *maybe_shader_module,
+            .entryPoint = "fs_main",
+            .targetCount = 1,
+            .targets = &color_target_state,
+        };
+        auto pipeline_desc = wgpu::RenderPipelineDescriptor{
+            .label = "fae_upscaler_pipeline",
+            .layout = device.CreatePipelineLayout(&pipeline_layout_desc),
+            .vertex = wgpu::VertexState{
+                .module = *maybe_shader_module,
+                .entryPoint = "vs_main",
+            },
+            .primitive = wgpu::PrimitiveState{
+                .topology = wgpu::PrimitiveTopology::TriangleList,
+            },
+            .multisample = wgpu::MultisampleState{},
+            .fragment = &fragment_state,
+        };
+        m_pipeline = device.CreateRenderPipeline(&pipeline_desc);
+
+        auto sampler_desc = wgpu::SamplerDescriptor{
+            .addressModeU = wgpu::AddressMode::ClampToEdge,
+            .addressModeV = wgpu::AddressMode::ClampToEdge,
+            .addressModeW = wgpu::AddressMode::ClampToEdge,
+            .magFilter = wgpu::FilterMode::Linear,
+            .minFilter = wgpu::FilterMode::Linear,
+            .mipmapFilter = wgpu::MipmapFilterMode::Nearest,
+            .maxAnisotropy = 1,
+        };
+        m_sampler = device.CreateSampler(&sampler_desc);
+        m_target_format = target_format;
+        return static_cast<bool>(m_pipeline);
+    }
+}
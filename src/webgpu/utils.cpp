@@ -3,12 +3,19 @@
 #include <fstream>
 #include <string>
 #include <bit>
+#include <cstring>
+#include <format>
 
 #ifdef FAE_PLATFORM_WEB
 #include <emscripten/emscripten.h>
 #endif
 
+#include "fae/core/offset_of.hpp"
 #include "fae/logging.hpp"
+#include "fae/rendering/mesh.hpp"
+#include "fae/rendering/mip_chain.hpp"
+#include "fae/webgpu/mip_generator.hpp"
+#include "fae/webgpu/staging_belt.hpp"
 
 namespace fae
 {
@@ -123,9 +130,15 @@ namespace fae
         std::string_view label,
         const void* data,
         std::size_t size,
-        wgpu::BufferUsage usage)
+        wgpu::BufferUsage usage,
+        staging_belt* uploads)
     {
         auto buffer = create_buffer(device, label, size, usage);
+        if (uploads)
+        {
+            uploads->write_buffer(device, buffer, 0, data, size);
+            return buffer;
+        }
         device.GetQueue().WriteBuffer(buffer, 0, data, size);
         return buffer;
     }
@@ -162,6 +175,48 @@ namespace fae
         return create_shader_module_from_str(device, label, shader_src);
     }
 
+    auto create_render_pipeline_async(const wgpu::Device& device,
+        const wgpu::RenderPipelineDescriptor& descriptor,
+        std::function<void(wgpu::RenderPipeline)> on_created) noexcept -> void
+    {
+#ifndef FAE_PLATFORM_WEB
+        device.CreateRenderPipelineAsync(&descriptor, wgpu::CallbackMode::AllowProcessEvents,
+            [on_created = std::move(on_created)](wgpu::CreatePipelineAsyncStatus status, wgpu::RenderPipeline pipeline, wgpu::StringView message)
+            {
+                if (status != wgpu::CreatePipelineAsyncStatus::Success)
+                {
+                    fae::log_error(std::format("failed to create render pipeline: {}", std::string_view(message.data, message.length)));
+                    on_created(nullptr);
+                    return;
+                }
+                on_created(std::move(pipeline));
+            });
+#else
+        on_created(device.CreateRenderPipeline(&descriptor));
+#endif
+    }
+
+    auto create_compute_pipeline_async(const wgpu::Device& device,
+        const wgpu::ComputePipelineDescriptor& descriptor,
+        std::function<void(wgpu::ComputePipeline)> on_created) noexcept -> void
+    {
+#ifndef FAE_PLATFORM_WEB
+        device.CreateComputePipelineAsync(&descriptor, wgpu::CallbackMode::AllowProcessEvents,
+            [on_created = std::move(on_created)](wgpu::CreatePipelineAsyncStatus status, wgpu::ComputePipeline pipeline, wgpu::StringView message)
+            {
+                if (status != wgpu::CreatePipelineAsyncStatus::Success)
+                {
+                    fae::log_error(std::format("failed to create compute pipeline: {}", std::string_view(message.data, message.length)));
+                    on_created(nullptr);
+                    return;
+                }
+                on_created(std::move(pipeline));
+            });
+#else
+        on_created(device.CreateComputePipeline(&descriptor));
+#endif
+    }
+
     wgpu::Texture create_texture(const wgpu::Device& device,
         std::string_view label,
         wgpu::Extent3D extent,
@@ -178,14 +233,28 @@ namespace fae
     }
 
     [[nodiscard]] texture_and_view create_texture_with_mips_and_view(const wgpu::Device& device,
-        texture texture)
+        const texture& texture,
+        const mip_chain_options& mip_options,
+        staging_belt* uploads)
+    {
+        auto chain = build_mip_chain(std::span(reinterpret_cast<const std::uint8_t*>(texture.data.data()), texture.data.size() * sizeof(color)),
+            texture.width,
+            texture.height,
+            mip_options);
+        return create_texture_from_mip_chain(device, chain, uploads);
+    }
+
+    [[nodiscard]] texture_and_view create_texture_from_mip_chain(const wgpu::Device& device,
+        const mip_chain& chain,
+        staging_belt* uploads)
     {
+        const auto& base_level = chain.levels.front();
         auto texture_desc = wgpu::TextureDescriptor{
-            .usage = wgpu::TextureUsage::CopyDst | wgpu::TextureUsage::TextureBinding,
+            .usage = wgpu::TextureUsage::CopyDst | wgpu::TextureUsage::CopySrc | wgpu::TextureUsage::TextureBinding,
             .dimension = wgpu::TextureDimension::e2D,
-            .size = { static_cast<std::uint32_t>(texture.width), static_cast<std::uint32_t>(texture.height), 1 },
+            .size = { static_cast<std::uint32_t>(base_level.width), static_cast<std::uint32_t>(base_level.height), 1 },
             .format = wgpu::TextureFormat::RGBA8Unorm,
-            .mipLevelCount = static_cast<std::uint32_t>(std::bit_width(std::max(texture.width, texture.height))),
+            .mipLevelCount = static_cast<std::uint32_t>(chain.levels.size()),
             .sampleCount = 1,
             .viewFormatCount = 0,
             .viewFormats = nullptr,
@@ -205,71 +274,320 @@ namespace fae
         auto texture_view = wgpu_texture.CreateView(&texture_view_desc);
 
         // write mipmaps
+        auto destination = wgpu::ImageCopyTexture{
+            .texture = wgpu_texture,
+            .mipLevel = 0,
+            .origin = { 0, 0, 0 },
+            .aspect = wgpu::TextureAspect::All,
+        };
+        auto queue = device.GetQueue();
+        for (std::uint32_t level = 0; level < chain.levels.size(); ++level)
+        {
+            const auto& mip = chain.levels[level];
+            auto level_data = chain.level_data(level);
+            auto source = wgpu::TextureDataLayout{
+                .offset = 0,
+                .bytesPerRow = static_cast<std::uint32_t>(4 * mip.width),
+                .rowsPerImage = static_cast<std::uint32_t>(mip.height),
+            };
+            auto level_size = wgpu::Extent3D{ static_cast<std::uint32_t>(mip.width), static_cast<std::uint32_t>(mip.height), 1 };
+            destination.mipLevel = level;
+            if (uploads)
+            {
+                uploads->write_texture(device, destination, level_data.data(), source.bytesPerRow, source.rowsPerImage, level_size);
+                continue;
+            }
+            queue.WriteTexture(&destination, level_data.data(), level_data.size(), &source, &level_size);
+        }
+
+        return texture_and_view{
+            .texture = wgpu_texture,
+            .view = texture_view,
+        };
+    }
+
+    auto vertex_layout::buffer_layout() const noexcept -> wgpu::VertexBufferLayout
+    {
+        return wgpu::VertexBufferLayout{
+            .arrayStride = stride,
+            .stepMode = wgpu::VertexStepMode::Vertex,
+            .attributeCount = attributes.size(),
+            .attributes = attributes.data(),
+        };
+    }
+
+    auto make_vertex_layout(vertex_format format) -> vertex_layout
+    {
+        if (format == vertex_format::standard)
+        {
+            return vertex_layout{
+                .attributes = {
+                    wgpu::VertexAttribute{ .format = wgpu::VertexFormat::Float32x3, .offset = fae::offset_of(&vertex::position), .shaderLocation = 0 },
+                    wgpu::VertexAttribute{ .format = wgpu::VertexFormat::Float32x4, .offset = fae::offset_of(&vertex::color), .shaderLocation = 1 },
+                    wgpu::VertexAttribute{ .format = wgpu::VertexFormat::Float32x3, .offset = fae::offset_of(&vertex::normal), .shaderLocation = 2 },
+                    wgpu::VertexAttribute{ .format = wgpu::VertexFormat::Float32x2, .offset = fae::offset_of(&vertex::uv), .shaderLocation = 3 },
+                },
+                .stride = sizeof(vertex),
+            };
+        }
+
+        auto layout = vertex_layout{
+            .attributes = {
+                wgpu::VertexAttribute{ .format = wgpu::VertexFormat::Float32x3, .offset = fae::offset_of(&compact_colored_vertex::position), .shaderLocation = 0 },
+                wgpu::VertexAttribute{ .format = wgpu::VertexFormat::Snorm16x2, .offset = fae::offset_of(&compact_colored_vertex::normal), .shaderLocation = 2 },
+                wgpu::VertexAttribute{ .format = wgpu::VertexFormat::Float16x2, .offset = fae::offset_of(&compact_colored_vertex::uv), .shaderLocation = 3 },
+            },
+            .stride = vertex_stride(format),
+        };
+        if (format == vertex_format::compact_with_color)
+        {
+            layout.attributes.push_back(wgpu::VertexAttribute{ .format = wgpu::VertexFormat::Unorm8x4, .offset = fae::offset_of(&compact_colored_vertex::color), .shaderLocation = 1 });
+        }
+        return layout;
+    }
+
+    auto to_wgpu_texture_format(texture_compression compression) noexcept -> wgpu::TextureFormat
+    {
+        switch (compression)
+        {
+        case texture_compression::bc1:
+            return wgpu::TextureFormat::BC1RGBAUnorm;
+        case texture_compression::bc2:
+            return wgpu::TextureFormat::BC2RGBAUnorm;
+        case texture_compression::bc3:
+            return wgpu::TextureFormat::BC3RGBAUnorm;
+        case texture_compression::bc4:
+            return wgpu::TextureFormat::BC4RUnorm;
+        case texture_compression::bc5:
+            return wgpu::TextureFormat::BC5RGUnorm;
+        case texture_compression::bc7:
+            return wgpu::TextureFormat::BC7RGBAUnorm;
+        case texture_compression::etc2_rgb8:
+            return wgpu::TextureFormat::ETC2RGB8Unorm;
+        case texture_compression::etc2_rgb8a1:
+            return wgpu::TextureFormat::ETC2RGB8A1Unorm;
+        case texture_compression::etc2_rgba8:
+            return wgpu::TextureFormat::ETC2RGBA8Unorm;
+        case texture_compression::astc_4x4:
+            return wgpu::TextureFormat::ASTC4x4Unorm;
+        }
+        return wgpu::TextureFormat::Undefined;
+    }
+
+    auto required_feature(texture_compression compression) noexcept -> wgpu::FeatureName
+    {
+        switch (compression)
+        {
+        case texture_compression::etc2_rgb8:
+        case texture_compression::etc2_rgb8a1:
+        case texture_compression::etc2_rgba8:
+            return wgpu::FeatureName::TextureCompressionETC2;
+        case texture_compression::astc_4x4:
+            return wgpu::FeatureName::TextureCompressionASTC;
+        default:
+            return wgpu::FeatureName::TextureCompressionBC;
+        }
+    }
+
+    auto can_upload_compressed(const wgpu::Device& device, const compressed_texture& texture) noexcept -> bool
+    {
+        const auto& base_level = texture.levels.front();
+        return device.HasFeature(required_feature(texture.compression)) && base_level.width % 4 == 0 && base_level.height % 4 == 0;
+    }
+
+    [[nodiscard]] texture_and_view create_compressed_texture_and_view(const wgpu::Device& device,
+        const compressed_texture& texture,
+        staging_belt* uploads)
+    {
+        const auto& base_level = texture.levels.front();
+        auto format = to_wgpu_texture_format(texture.compression);
+        auto texture_desc = wgpu::TextureDescriptor{
+            .usage = wgpu::TextureUsage::CopyDst | wgpu::TextureUsage::TextureBinding,
+            .dimension = wgpu::TextureDimension::e2D,
+            .size = { static_cast<std::uint32_t>(base_level.width), static_cast<std::uint32_t>(base_level.height), 1 },
+            .format = format,
+            .mipLevelCount = static_cast<std::uint32_t>(texture.levels.size()),
+            .sampleCount = 1,
+            .viewFormatCount = 0,
+            .viewFormats = nullptr,
+        };
+        auto wgpu_texture = device.CreateTexture(&texture_desc);
+
+        auto destination = wgpu::ImageCopyTexture{
+            .texture = wgpu_texture,
+            .mipLevel = 0,
+            .origin = { 0, 0, 0 },
+            .aspect = wgpu::TextureAspect::All,
+        };
+        auto queue = device.GetQueue();
+        auto block_size = static_cast<std::uint32_t>(block_size_in_bytes(texture.compression));
+        for (std::uint32_t level = 0; level < texture.levels.size(); ++level)
+        {
+            const auto& mip = texture.levels[level];
+            // copies are in whole blocks, levels smaller than a block still occupy one
+            auto blocks_wide = static_cast<std::uint32_t>((mip.width + 3) / 4);
+            auto blocks_high = static_cast<std::uint32_t>((mip.height + 3) / 4);
+            auto level_data = texture.level_data(level);
+            auto source = wgpu::TextureDataLayout{
+                .offset = 0,
+                .bytesPerRow = blocks_wide * block_size,
+                .rowsPerImage = blocks_high,
+            };
+            auto level_size = wgpu::Extent3D{ blocks_wide * 4, blocks_high * 4, 1 };
+            destination.mipLevel = level;
+            if (uploads)
+            {
+                uploads->write_texture(device, destination, level_data.data(), source.bytesPerRow, source.rowsPerImage, level_size);
+                continue;
+            }
+            queue.WriteTexture(&destination, level_data.data(), level_data.size(), &source, &level_size);
+        }
+
+        auto texture_view_desc = wgpu::TextureViewDescriptor{
+            .format = format,
+            .dimension = wgpu::TextureViewDimension::e2D,
+            .baseMipLevel = 0,
+            .mipLevelCount = texture_desc.mipLevelCount,
+            .baseArrayLayer = 0,
+            .arrayLayerCount = 1,
+            .aspect = wgpu::TextureAspect::All,
+        };
+        return texture_and_view{
+            .texture = wgpu_texture,
+            .view = wgpu_texture.CreateView(&texture_view_desc),
+        };
+    }
+
+    [[nodiscard]] texture_and_view create_texture_with_gpu_mips_and_view(const wgpu::Device& device,
+        const texture& texture,
+        mip_generator& mip_generator)
+    {
+        auto texture_desc = wgpu::TextureDescriptor{
+            .usage = wgpu::TextureUsage::CopyDst | wgpu::TextureUsage::CopySrc | wgpu::TextureUsage::TextureBinding | wgpu::TextureUsage::StorageBinding,
+            .dimension = wgpu::TextureDimension::e2D,
+            .size = { static_cast<std::uint32_t>(texture.width), static_cast<std::uint32_t>(texture.height), 1 },
+            .format = wgpu::TextureFormat::RGBA8Unorm,
+            .mipLevelCount = mip_level_count(texture.width, texture.height),
+            .sampleCount = 1,
+            .viewFormatCount = 0,
+            .viewFormats = nullptr,
+        };
+        auto wgpu_texture = device.CreateTexture(&texture_desc);
+
         auto source = wgpu::TextureDataLayout{
             .offset = 0,
             .bytesPerRow = static_cast<std::uint32_t>(4 * texture.width),
             .rowsPerImage = static_cast<std::uint32_t>(texture.height),
         };
-
         auto destination = wgpu::ImageCopyTexture{
             .texture = wgpu_texture,
             .mipLevel = 0,
             .origin = { 0, 0, 0 },
             .aspect = wgpu::TextureAspect::All,
         };
+        device.GetQueue().WriteTexture(&destination, texture.data.data(), texture.data.size() * sizeof(color), &source, &texture_desc.size);
 
-        auto queue = device.GetQueue();
+        if (!mip_generator.generate(device, wgpu_texture))
+        {
+            wgpu_texture.Destroy();
+            return create_texture_with_mips_and_view(device, texture);
+        }
+
+        auto texture_view_desc = wgpu::TextureViewDescriptor{
+            .format = wgpu::TextureFormat::RGBA8Unorm,
+            .dimension = wgpu::TextureViewDimension::e2D,
+            .baseMipLevel = 0,
+            .mipLevelCount = texture_desc.mipLevelCount,
+            .baseArrayLayer = 0,
+            .arrayLayerCount = 1,
+            .aspect = wgpu::TextureAspect::All,
+        };
+        return texture_and_view{
+            .texture = wgpu_texture,
+            .view = wgpu_texture.CreateView(&texture_view_desc),
+        };
+    }
 
-        wgpu::Extent3D mipLevelSize = texture_desc.size;
-        std::vector<unsigned char> previousLevelPixels;
-        wgpu::Extent3D previousMipLevelSize;
-        for (uint32_t level = 0; level < texture_desc.mipLevelCount; ++level)
+#ifndef FAE_PLATFORM_WEB
+    auto wait_for_submitted_work_sync(const wgpu::Instance& instance, const wgpu::Device& device) noexcept -> void
+    {
+        auto done = false;
+        device.GetQueue().OnSubmittedWorkDone(wgpu::CallbackMode::AllowProcessEvents,
+            [&done](wgpu::QueueWorkDoneStatus status)
+            { done = true; });
+        while (!done)
         {
-            // Pixel data for the current level
-            std::vector<unsigned char> pixels(4 * mipLevelSize.width * mipLevelSize.height);
-            if (level == 0)
-            {
-                // We cannot really avoid this copy since we need this
-                // in previousLevelPixels at the next iteration
-                memcpy(pixels.data(), texture.data.data(), pixels.size());
-            }
-            else
+            instance.ProcessEvents();
+        }
+    }
+
+    auto read_texture_sync(const wgpu::Instance& instance,
+        const wgpu::Device& device,
+        const wgpu::Texture& texture,
+        std::uint32_t mip_level) noexcept -> std::vector<std::uint8_t>
+    {
+        constexpr std::uint32_t bytes_per_pixel = 4;
+        constexpr std::uint32_t bytes_per_row_alignment = 256;
+        auto width = std::max(texture.GetWidth() >> mip_level, 1u);
+        auto height = std::max(texture.GetHeight() >> mip_level, 1u);
+        auto packed_bytes_per_row = width * bytes_per_pixel;
+        auto padded_bytes_per_row = (packed_bytes_per_row + bytes_per_row_alignment - 1) / bytes_per_row_alignment * bytes_per_row_alignment;
+
+        auto readback_buffer_desc = wgpu::BufferDescriptor{
+            .label = "fae_texture_readback_buffer",
+            .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::MapRead,
+            .size = static_cast<std::uint64_t>(padded_bytes_per_row) * height,
+        };
+        auto readback_buffer = device.CreateBuffer(&readback_buffer_desc);
+
+        auto source = wgpu::ImageCopyTexture{
+            .texture = texture,
+            .mipLevel = mip_level,
+            .origin = { 0, 0, 0 },
+            .aspect = wgpu::TextureAspect::All,
+        };
+        auto destination = wgpu::ImageCopyBuffer{};
+        destination.layout.offset = 0;
+        destination.layout.bytesPerRow = padded_bytes_per_row;
+        destination.layout.rowsPerImage = height;
+        destination.buffer = readback_buffer;
+        auto extent = wgpu::Extent3D{ width, height, 1 };
+
+        auto command_encoder = device.CreateCommandEncoder();
+        command_encoder.CopyTextureToBuffer(&source, &destination, &extent);
+        auto command_buffer = command_encoder.Finish();
+        device.GetQueue().Submit(1, &command_buffer);
+
+        auto done = false;
+        auto mapped = false;
+        readback_buffer.MapAsync(wgpu::MapMode::Read, 0, readback_buffer_desc.size, wgpu::CallbackMode::AllowProcessEvents,
+            [&](wgpu::MapAsyncStatus status, wgpu::StringView message)
             {
-                // Create mip level data
-                for (uint32_t i = 0; i < mipLevelSize.width; ++i)
+                mapped = status == wgpu::MapAsyncStatus::Success;
+                if (!mapped)
                 {
-                    for (uint32_t j = 0; j < mipLevelSize.height; ++j)
-                    {
-                        unsigned char* p = &pixels[4 * (j * mipLevelSize.width + i)];
-                        // Get the corresponding 4 pixels from the previous level
-                        unsigned char* p00 = &previousLevelPixels[4 * ((2 * j + 0) * previousMipLevelSize.width + (2 * i + 0))];
-                        unsigned char* p01 = &previousLevelPixels[4 * ((2 * j + 0) * previousMipLevelSize.width + (2 * i + 1))];
-                        unsigned char* p10 = &previousLevelPixels[4 * ((2 * j + 1) * previousMipLevelSize.width + (2 * i + 0))];
-                        unsigned char* p11 = &previousLevelPixels[4 * ((2 * j + 1) * previousMipLevelSize.width + (2 * i + 1))];
-                        // Average
-                        p[0] = (p00[0] + p01[0] + p10[0] + p11[0]) / 4;
-                        p[1] = (p00[1] + p01[1] + p10[1] + p11[1]) / 4;
-                        p[2] = (p00[2] + p01[2] + p10[2] + p11[2]) / 4;
-                        p[3] = (p00[3] + p01[3] + p10[3] + p11[3]) / 4;
-                    }
+                    fae::log_error(std::format("failed to map texture readback buffer: {}", std::string_view(message.data, message.length)));
                 }
-            }
-
-            // Upload data to the GPU texture
-            destination.mipLevel = level;
-            source.bytesPerRow = 4 * mipLevelSize.width;
-            source.rowsPerImage = mipLevelSize.height;
-            queue.WriteTexture(&destination, pixels.data(), pixels.size(), &source, &mipLevelSize);
-
-            previousLevelPixels = std::move(pixels);
-            previousMipLevelSize = mipLevelSize;
-            mipLevelSize.width /= 2;
-            mipLevelSize.height /= 2;
+                done = true;
+            });
+        while (!done)
+        {
+            instance.ProcessEvents();
         }
 
-        return texture_and_view{
-            .texture = wgpu_texture,
-            .view = texture_view,
-        };
+        auto pixels = std::vector<std::uint8_t>();
+        if (!mapped)
+        {
+            return pixels;
+        }
+        pixels.resize(static_cast<std::size_t>(packed_bytes_per_row) * height);
+        auto mapped_data = static_cast<const std::uint8_t*>(readback_buffer.GetConstMappedRange(0, readback_buffer_desc.size));
+        for (std::uint32_t row = 0; row < height; ++row)
+        {
+            std::memcpy(pixels.data() + row * packed_bytes_per_row, mapped_data + row * padded_bytes_per_row, packed_bytes_per_row);
+        }
+        readback_buffer.Unmap();
+        return pixels;
     }
+#endif
 }
@@ -1,6 +1,9 @@
 #include "fae/webgpu/webgpu.hpp"
 
+#include <algorithm>
 #include <optional>
+#include <span>
+#include <vector>
 #include <format>
 #include <string>
 #include <string_view>
@@ -18,18 +21,108 @@ namespace fae
 {
     auto webgpu_plugin::init(application& app) const noexcept -> void
     {
-        app
-            .add_plugin(windowing_plugin{})
-            .add_system<window_resized>(reconfigure_on_window_resized);
+        if (!headless)
+        {
+            app
+                .add_plugin(windowing_plugin{})
+                .add_system<window_resized>(reconfigure_on_window_resized);
+        }
 
+#ifndef FAE_PLATFORM_WEB
+        // the frame pacer blocks on frames with a timeout instead of polling for them
+        auto instance_descriptor = wgpu::InstanceDescriptor{
+            .features = wgpu::InstanceFeatures{ .timedWaitAnyEnable = true },
+        };
+        auto instance = wgpu::CreateInstance(&instance_descriptor);
+#else
+        auto instance = wgpu::CreateInstance();
+#endif
         auto& webgpu = app.global_entity.get_or_set_component<fae::webgpu>(fae::webgpu{
-            .instance = wgpu::CreateInstance(),
+            .instance = instance,
         });
+        webgpu.textures.budget_bytes = texture_memory_budget;
+        webgpu.textures.generate_mips_on_gpu = generate_mips_on_gpu;
+        webgpu.frames.max_frames_in_flight = std::max(max_frames_in_flight, 1u);
+        app.assets.on_asset_released += [&global_entity = app.global_entity](const asset_id& id)
+        {
+            global_entity.use_component<fae::webgpu>([&](fae::webgpu& webgpu)
+                {
+                    webgpu.textures.release(asset_handle<texture>{ .id = id });
+                    webgpu.texture_arrays.release(asset_handle<texture>{ .id = id });
+                    // not destroyed, draws recorded this frame may still use its buffers
+                    webgpu.mesh_buffers.erase(asset_handle<fae::mesh>{ .id = id });
+                    for (auto& render_pipeline : webgpu.render_pipelines)
+                    {
+                        // not destroyed, draws recorded this frame may still use its bind group
+                        render_pipeline.materials.erase(asset_handle<material>{ .id = id });
+                    } });
+        };
         webgpu.adapter = request_adapter_sync(webgpu.instance, adapter_options);
-        webgpu.device = request_device_sync(webgpu.adapter, device_descriptor);
+        auto required_features = std::vector<wgpu::FeatureName>(device_descriptor.requiredFeatures, device_descriptor.requiredFeatures + device_descriptor.requiredFeatureCount);
+        if (request_texture_compression)
+        {
+            // only formats the adapter supports can be required, compressed textures in other formats are decoded on the cpu
+            for (auto feature : { wgpu::FeatureName::TextureCompressionBC, wgpu::FeatureName::TextureCompressionETC2, wgpu::FeatureName::TextureCompressionASTC })
+            {
+                if (webgpu.adapter.HasFeature(feature) && std::ranges::find(required_features, feature) == required_features.end())
+                {
+                    required_features.push_back(feature);
+                }
+            }
+        }
+        // lets the gpu driven renderer's draws read their range of the compacted visible list through firstInstance
+        if (webgpu.adapter.HasFeature(wgpu::FeatureName::IndirectFirstInstance) && std::ranges::find(required_features, wgpu::FeatureName::IndirectFirstInstance) == required_features.end())
+        {
+            required_features.push_back(wgpu::FeatureName::IndirectFirstInstance);
+        }
+        if (request_timestamp_queries && !webgpu.adapter.HasFeature(wgpu::FeatureName::TimestampQuery))
+        {
+            fae::log_info("the adapter has no timestamp queries, gpu pass times are unavailable (see gpu_frame_stats)");
+        }
+        else if (request_timestamp_queries && std::ranges::find(required_features, wgpu::FeatureName::TimestampQuery) == required_features.end())
+        {
+            required_features.push_back(wgpu::FeatureName::TimestampQuery);
+        }
+        auto descriptor = device_descriptor;
+        descriptor.requiredFeatureCount = required_features.size();
+        descriptor.requiredFeatures = required_features.data();
+#ifndef FAE_PLATFORM_WEB
+        auto cache_descriptor = wgpu::DawnCacheDeviceDescriptor{};
+        if (!pipeline_cache_directory.empty())
+        {
+            webgpu.pipeline_cache = std::make_shared<fae::pipeline_cache>();
+            webgpu.pipeline_cache->directory = pipeline_cache_directory;
+            webgpu.pipeline_cache->isolation_key = pipeline_cache::make_isolation_key(webgpu.adapter);
+            cache_descriptor = webgpu.pipeline_cache->device_descriptor();
+            cache_descriptor.nextInChain = descriptor.nextInChain;
+            descriptor.nextInChain = &cache_descriptor;
+        }
+#endif
+        webgpu.device = request_device_sync(webgpu.adapter, descriptor);
 #ifndef FAE_PLATFORM_WEB
         webgpu.device.SetLoggingCallback(logging_callback, nullptr);
 #endif
+        if (headless)
+        {
+            webgpu.target = fae::webgpu::render_target{
+                .format = headless_format,
+                .width = headless_width,
+                .height = headless_height,
+                .offscreen_texture = create_texture(webgpu.device,
+                    "fae_offscreen_render_target",
+                    { .width = headless_width, .height = headless_height },
+                    headless_format,
+                    wgpu::TextureUsage::RenderAttachment | wgpu::TextureUsage::CopySrc | wgpu::TextureUsage::TextureBinding),
+            };
+#ifndef FAE_PLATFORM_WEB
+            if (read_back_frames)
+            {
+                webgpu.readback.emplace();
+            }
+#endif
+            return;
+        }
+
         auto maybe_primary_window = app.global_entity.get_component<primary_window>();
         if (!maybe_primary_window)
         {
@@ -50,6 +143,13 @@ namespace fae
         auto surface_capabilities = wgpu::SurfaceCapabilities{};
         webgpu.surface.GetCapabilities(webgpu.adapter, &surface_capabilities);
         auto surface_format = surface_capabilities.formats[0];
+        auto supported_present_modes = std::span(surface_capabilities.presentModes, surface_capabilities.presentModeCount);
+        webgpu.present_mode = present_mode;
+        if (std::ranges::find(supported_present_modes, present_mode) == supported_present_modes.end())
+        {
+            fae::log_warning(std::format("present mode {} is not supported by the surface, using Fifo", to_string(present_mode)));
+            webgpu.present_mode = wgpu::PresentMode::Fifo;
+        }
 
         auto surface_config = wgpu::SurfaceConfiguration{
             .device = webgpu.device,
@@ -57,9 +157,14 @@ namespace fae
             .usage = wgpu::TextureUsage::RenderAttachment,
             .width = static_cast<std::uint32_t>(window_size.width),
             .height = static_cast<std::uint32_t>(window_size.height),
-            .presentMode = wgpu::PresentMode::Fifo,
+            .presentMode = webgpu.present_mode,
         };
         webgpu.surface.Configure(&surface_config);
+        webgpu.target = fae::webgpu::render_target{
+            .format = surface_format,
+            .width = surface_config.width,
+            .height = surface_config.height,
+        };
     }
 
     auto reconfigure_on_window_resized(const fae::window_resized& e) noexcept -> void
@@ -84,8 +189,10 @@ namespace fae
                 .usage = wgpu::TextureUsage::RenderAttachment,
                 .width = static_cast<std::uint32_t>(window_width),
                 .height = static_cast<std::uint32_t>(window_height),
-                .presentMode = wgpu::PresentMode::Fifo,
+                .presentMode = webgpu.present_mode,
             };
-            webgpu.surface.Configure(&surface_config); });
+            webgpu.surface.Configure(&surface_config);
+            webgpu.target.width = surface_config.width;
+            webgpu.target.height = surface_config.height; });
     }
 }
@@ -0,0 +1,174 @@
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <format>
+#include <optional>
+#include <print>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "fae/core/exit.hpp"
+#include "fae/rendering/cooked_mesh.hpp"
+#include "fae/rendering/cooked_texture.hpp"
+#include "fae/rendering/mesh.hpp"
+#include "fae/rendering/texture.hpp"
+
+/*
+cooks source meshes & textures into the binary formats mesh::load & texture::load map without parsing or decoding
+(see cooked_mesh.hpp & cooked_texture.hpp), next to each source as <source>.fmesh or <source>.ftex
+meshes are imported with the default import options (optimized for the gpu's caches), so loading the cooked file skips that too
+textures get their full mip chain built, ktx2 & dds files keep their compressed levels
+directories are searched recursively, sources whose cooked file is newer are skipped unless --force is given
+
+usage: asset_cooker [--force] [--meshlets] [--srgb] [paths...] (default: the asset directory)
+    --force      cook every source, even when its cooked file is up to date
+    --meshlets   also build meshlets (see build_meshlets) for the gpu driven renderer
+    --srgb       average texels in linear space when building mips (see mip_chain_options), for color textures
+*/
+
+using clock_type = std::chrono::steady_clock;
+
+struct options
+{
+    bool force = false;
+    bool meshlets = false;
+    bool srgb = false;
+    std::vector<std::filesystem::path> paths;
+};
+
+auto lowercase_extension(const std::filesystem::path& path) -> std::string
+{
+    auto extension = path.extension().string();
+    std::ranges::transform(extension, extension.begin(), [](unsigned char c)
+        { return static_cast<char>(std::tolower(c)); });
+    return extension;
+}
+
+auto is_source_mesh(const std::filesystem::path& path) -> bool
+{
+    constexpr auto extensions = std::array<std::string_view, 8>{ ".obj", ".stl", ".fbx", ".gltf", ".glb", ".ply", ".dae", ".3ds" };
+    return std::ranges::find(extensions, lowercase_extension(path)) != extensions.end();
+}
+
+auto is_source_texture(const std::filesystem::path& path) -> bool
+{
+    constexpr auto extensions = std::array<std::string_view, 7>{ ".png", ".jpg", ".jpeg", ".tga", ".bmp", ".ktx2", ".dds" };
+    return std::ranges::find(extensions, lowercase_extension(path)) != extensions.end();
+}
+
+/* the cooked file's description for the summary, nullopt if the source couldn't be loaded or cooked */
+auto cook_mesh(const std::filesystem::path& source, const std::filesystem::path& cooked, const options& options) -> std::optional<std::string>
+{
+    auto mesh = fae::mesh::load(source, fae::mesh_import_options{ .build_meshlets = options.meshlets });
+    if (!mesh || !fae::write_cooked_mesh(*mesh, cooked))
+    {
+        return std::nullopt;
+    }
+    return std::format("{} vertices, {} triangles", mesh->vertices.size(), mesh->indices.size() / 3);
+}
+
+auto cook_texture(const std::filesystem::path& source, const std::filesystem::path& cooked, const options& options) -> std::optional<std::string>
+{
+    auto texture = fae::texture::load(source);
+    if (!texture || !fae::write_cooked_texture(*texture, cooked, fae::mip_chain_options{ .srgb = options.srgb }))
+    {
+        return std::nullopt;
+    }
+    return std::format("{}x{}, {} levels", texture->width, texture->height, texture->compressed ? texture->compressed->levels.size() : fae::mip_level_count(texture->width, texture->height));
+}
+
+auto up_to_date(const std::filesystem::path& source, const std::filesystem::path& cooked) -> bool
+{
+    auto cooked_error = std::error_code{};
+    auto source_error = std::error_code{};
+    auto cooked_time = std::filesystem::last_write_time(cooked, cooked_error);
+    auto source_time = std::filesystem::last_write_time(source, source_error);
+    return !cooked_error && !source_error && cooked_time >= source_time;
+}
+
+auto main(int argc, char* argv[]) -> int
+{
+    auto options = ::options{};
+    for (int i = 1; i < argc; ++i)
+    {
+        auto arg = std::string_view(argv[i]);
+        if (arg == "--force")
+        {
+            options.force = true;
+        }
+        else if (arg == "--meshlets")
+        {
+            options.meshlets = true;
+        }
+        else if (arg == "--srgb")
+        {
+            options.srgb = true;
+        }
+        else if (arg.starts_with("--"))
+        {
+            std::println("unknown option {}", arg);
+            return fae::exit_failure;
+        }
+        else
+        {
+            options.paths.emplace_back(arg);
+        }
+    }
+    if (options.paths.empty())
+    {
+        options.paths.emplace_back(FAE_ASSET_DIR);
+    }
+
+    auto sources = std::vector<std::filesystem::path>();
+    for (const auto& path : options.paths)
+    {
+        if (std::filesystem::is_directory(path))
+        {
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(path))
+            {
+                if (entry.is_regular_file() && (is_source_mesh(entry.path()) || is_source_texture(entry.path())))
+                {
+                    sources.push_back(entry.path());
+                }
+            }
+        }
+        else if (std::filesystem::is_regular_file(path))
+        {
+            sources.push_back(path);
+        }
+        else
+        {
+            std::println("{} doesn't exist", path.string());
+            return fae::exit_failure;
+        }
+    }
+
+    auto cooked_count = std::size_t{ 0 };
+    auto failed_count = std::size_t{ 0 };
+    for (const auto& source : sources)
+    {
+        auto is_texture = is_source_texture(source);
+        auto cooked = is_texture ? fae::cooked_texture_path(source) : fae::cooked_mesh_path(source);
+        if (!options.force && up_to_date(source, cooked))
+        {
+            continue;
+        }
+        auto start = clock_type::now();
+        auto description = is_texture ? cook_texture(source, cooked, options) : cook_mesh(source, cooked, options);
+        if (!description)
+        {
+            std::println("failed to cook {}", source.string());
+            failed_count++;
+            continue;
+        }
+        auto cook_ms = std::chrono::duration<double, std::milli>(clock_type::now() - start).count();
+        std::println("cooked {} ({}, {} bytes) in {:.3f} ms", cooked.string(), *description, std::filesystem::file_size(cooked), cook_ms);
+        cooked_count++;
+    }
+    std::println("{} cooked, {} up to date, {} failed", cooked_count, sources.size() - cooked_count - failed_count, failed_count);
+    return failed_count == 0 ? fae::exit_success : fae::exit_failure;
+}